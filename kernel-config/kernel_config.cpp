@@ -7,6 +7,7 @@
  */
 
 #include "kernel_config.h"
+#include "sysctl_writer.h"
 #include <algorithm>
 #include <fstream>
 #include <sstream>
@@ -20,6 +21,7 @@
 #include <sys/wait.h>
 #include <signal.h>
 #include <map>
+#include <unordered_set>
 
 // 简单的配置解析函数
 std::map<std::string, std::string> parseSimpleConfig(const std::string& content) {
@@ -52,13 +54,19 @@ namespace CloudFlow::Kernel {
 
 class KernelConfigManager::Impl {
 public:
-    Impl() : config_loaded_(false), requires_reboot_(false) {
+    Impl() : alias_index_(module_loader_.moduleDirectory()), config_loaded_(false), requires_reboot_(false) {
         // 初始化默认配置
         initializeDefaultConfig();
+        
+        // 模块表刷新时通知模块状态监听器
+        module_table_.setListener([this](const std::string& name, bool loaded) {
+            notifyModuleStatus(name, loaded);
+        });
     }
     
     ~Impl() {
         // 清理资源
+        module_table_.stopMonitor();
     }
     
     bool initialize() {
@@ -77,6 +85,12 @@ public:
             return false;
         }
         
+        // 读取模块依赖索引，没有/lib/modules的环境（如容器）中忽略
+        if (module_loader_.loadIndex()) {
+            resolveModuleInfo();
+            alias_index_.open();
+        }
+        
         return true;
     }
     
@@ -93,7 +107,15 @@ public:
         // 解析简单的文本配置
         auto config = parseSimpleConfig(content);
         
-        return parseConfig(config);
+        // 解析失败时参数列表也可能已部分替换，无论成败都重建索引
+        bool parsed = parseConfig(config);
+        parameter_index_.rebuild(config_.parameters);
+        if (!parsed) {
+            return false;
+        }
+        
+        resolveModuleInfo();
+        return true;
     }
     
     bool saveConfig(const std::string& config_file) const {
@@ -169,14 +191,17 @@ public:
             }
         }
         
-        // 应用模块加载
+        // 应用模块加载，所有自动加载的模块作为一批并行加载
+        std::vector<std::string> module_names;
         for (const auto& module : config_.modules) {
             if (module.auto_load && !module.is_builtin) {
-                if (!loadModuleInternal(module.name)) {
-                    success = false;
-                }
+                module_names.push_back(module.name);
             }
         }
+        std::vector<ModuleLoadResult> results;
+        if (!module_names.empty() && !loadModulesInternal(module_names, results)) {
+            success = false;
+        }
         
         // 应用sysctl设置
         if (!applySysctlSettings()) {
@@ -187,77 +212,49 @@ public:
     }
     
     bool validateConfig() const {
-        // 检查参数依赖关系
-        for (const auto& param : config_.parameters) {
-            for (const auto& dep : param.dependencies) {
-                auto dep_param = std::find_if(config_.parameters.begin(), 
-                                             config_.parameters.end(),
-                                             [&](const KernelParameter& p) { 
-                                                 return p.name == dep; 
-                                             });
-                
-                if (dep_param == config_.parameters.end()) {
-                    return false; // 依赖参数不存在
-                }
-                
-                if (dep_param->value.empty() && dep_param->is_required) {
-                    return false; // 必需依赖参数未设置
-                }
-            }
-            
-            // 检查冲突
-            for (const auto& conflict : param.conflicts) {
-                auto conflict_param = std::find_if(config_.parameters.begin(), 
-                                                  config_.parameters.end(),
-                                                  [&](const KernelParameter& p) { 
-                                                      return p.name == conflict; 
-                                                  });
-                
-                if (conflict_param != config_.parameters.end() && 
-                    !conflict_param->value.empty()) {
-                    return false; // 冲突参数已设置
-                }
-            }
-        }
-        
-        return true;
+        // 按预先建立的依赖/冲突图检查，依赖关系成环也视为无效
+        std::string error;
+        return parameter_index_.validate(config_.parameters, error);
+    }
+    
+    ParameterHandle findParameter(const std::string& param_name) const {
+        return parameter_index_.find(param_name);
     }
     
     std::string getParameterValue(const std::string& param_name) const {
-        auto it = std::find_if(config_.parameters.begin(), 
-                              config_.parameters.end(),
-                              [&](const KernelParameter& p) { 
-                                  return p.name == param_name; 
-                              });
-        
-        if (it != config_.parameters.end()) {
-            return it->value;
+        return getParameterValue(parameter_index_.find(param_name));
+    }
+    
+    std::string getParameterValue(ParameterHandle handle) const {
+        size_t index;
+        if (parameter_index_.resolve(handle, index)) {
+            return config_.parameters[index].value;
         }
         
         return "";
     }
     
     bool setParameterValue(const std::string& param_name, const std::string& value) {
-        auto it = std::find_if(config_.parameters.begin(), 
-                              config_.parameters.end(),
-                              [&](const KernelParameter& p) { 
-                                  return p.name == param_name; 
-                              });
-        
-        if (it == config_.parameters.end()) {
+        return setParameterValue(parameter_index_.find(param_name), value);
+    }
+    
+    bool setParameterValue(ParameterHandle handle, const std::string& value) {
+        size_t index;
+        if (!parameter_index_.resolve(handle, index)) {
             return false;
         }
+        KernelParameter& param = config_.parameters[index];
         
         // 验证参数值
-        if (!validateParameterValue(*it, value)) {
+        if (!validateParameterValue(param, value)) {
             return false;
         }
         
-        it->value = value;
+        param.value = value;
         
         // 通知监听器
         for (const auto& listener : param_change_listeners_) {
-            listener(param_name, value);
+            listener(param.name, value);
         }
         
         return true;
@@ -267,30 +264,54 @@ public:
         return loadModuleInternal(module_name);
     }
     
+    bool loadModules(const std::vector<std::string>& module_names, std::vector<ModuleLoadResult>& results) {
+        return loadModulesInternal(module_names, results);
+    }
+    
     bool unloadModule(const std::string& module_name) {
         return unloadModuleInternal(module_name);
     }
     
-    std::vector<std::string> getLoadedModules() const {
-        std::vector<std::string> loaded_modules;
+    std::vector<std::string> resolveModalias(const std::string& modalias) {
+        return alias_index_.lookup(modalias);
+    }
+    
+    bool coldplug(std::vector<ModuleLoadResult>& results) {
+        // 收集所有设备的modalias，候选模块合并为一批并行加载
+        std::vector<std::string> modaliases;
+        collectModaliases("/sys/devices", modaliases);
         
-        // 读取/proc/modules获取已加载模块
-        std::ifstream modules_file("/proc/modules");
-        if (!modules_file.is_open()) {
-            return loaded_modules;
+        std::vector<std::string> module_names;
+        std::unordered_set<std::string> seen;
+        for (const auto& modalias : modaliases) {
+            for (auto& name : alias_index_.lookup(modalias)) {
+                if (seen.insert(name).second) {
+                    module_names.push_back(std::move(name));
+                }
+            }
         }
         
-        std::string line;
-        while (std::getline(modules_file, line)) {
-            std::istringstream iss(line);
-            std::string module_name;
-            iss >> module_name;
-            loaded_modules.push_back(module_name);
+        if (module_names.empty()) {
+            return true;
+        }
+        return loadModulesInternal(module_names, results);
+    }
+    
+    std::vector<std::string> getLoadedModules() const {
+        std::vector<std::string> loaded_modules;
+        
+        // 从缓存的模块表获取已加载模块
+        for (const auto& module : *module_table_.modules()) {
+            loaded_modules.push_back(module.name);
         }
         
         return loaded_modules;
     }
     
+    std::vector<LoadedModule> getLoadedModuleTable() const {
+        return *module_table_.modules();
+    }
+    
     bool setSysctl(const std::string& key, const std::string& value) {
         config_.sysctl_settings[key] = value;
         return true;
@@ -305,17 +326,12 @@ public:
     }
     
     bool applySysctlSettings() {
-        bool success = true;
+        // 按键排序，同一子系统内的写入顺序固定
+        std::map<std::string, std::string> sorted(config_.sysctl_settings.begin(), config_.sysctl_settings.end());
+        std::vector<std::pair<std::string, std::string>> settings(sorted.begin(), sorted.end());
         
-        for (const auto& setting : config_.sysctl_settings) {
-            std::string command = "sysctl -w " + setting.first + "=" + setting.second;
-            
-            if (system(command.c_str()) != 0) {
-                success = false;
-            }
-        }
-        
-        return success;
+        std::vector<SysctlFailure> failures;
+        return sysctl_.apply(settings, failures);
     }
     
     std::string getKernelVersion() const {
@@ -378,15 +394,22 @@ public:
     }
     
     void addModuleStatusChangeListener(std::function<void(const std::string&, bool)> callback) {
+        std::lock_guard<std::mutex> lock(module_listeners_mutex_);
         module_status_listeners_.push_back(callback);
     }
 
 private:
     KernelConfig config_;
+    ParameterRegistry parameter_index_;
+    SysctlWriter sysctl_;
+    ModuleLoader module_loader_;
+    ModuleAliasIndex alias_index_;
     bool config_loaded_;
     bool requires_reboot_;
     std::vector<std::function<void(const std::string&, const std::string&)>> param_change_listeners_;
     std::vector<std::function<void(const std::string&, bool)>> module_status_listeners_;
+    std::mutex module_listeners_mutex_;     ///< 监听器可能在uevent线程上调用
+    LoadedModuleTable module_table_;
     
     void initializeDefaultConfig() {
         // 设置默认参数
@@ -401,6 +424,7 @@ private:
         };
         
         config_.parameters = {vm_swappiness, net_ipv4_tcp_timestamps};
+        parameter_index_.rebuild(config_.parameters);
     }
     
     bool detectSystemInfo() {
@@ -421,7 +445,12 @@ private:
     }
     
     bool loadCurrentModules() {
-        // 实现从/proc/modules读取当前模块信息
+        // 从/proc/modules读取当前模块信息作为基准，之后随模块uevent刷新；没有/proc/modules时为空表。
+        // 无法监听uevent时（如受限容器）只在本进程加载、卸载模块后刷新
+        if (!module_table_.refresh()) {
+            return false;
+        }
+        module_table_.startMonitor();
         return true;
     }
     
@@ -542,18 +571,8 @@ private:
             return true; // 非运行时参数需要重启，但应用成功
         }
         
-        // 构建参数路径
-        std::string param_path = "/proc/sys/" + param.name;
-        std::replace(param_path.begin(), param_path.end(), '.', '/');
-        
-        // 写入参数值
-        std::ofstream param_file(param_path);
-        if (!param_file.is_open()) {
-            return false;
-        }
-        
-        param_file << param.value;
-        return param_file.good();
+        std::string error;
+        return sysctl_.write(param.name, param.value, error);
     }
     
     bool validateParameterValue(const KernelParameter& param, const std::string& value) {
@@ -586,32 +605,86 @@ private:
         return true;
     }
     
-    bool loadModuleInternal(const std::string& module_name) {
-        std::string command = "modprobe " + module_name;
+    void collectModaliases(const std::string& path, std::vector<std::string>& modaliases) {
+        DIR* dir = opendir(path.c_str());
+        if (dir == nullptr) {
+            return;
+        }
         
-        if (system(command.c_str()) == 0) {
-            // 通知监听器
-            for (const auto& listener : module_status_listeners_) {
-                listener(module_name, true);
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (entry->d_type == DT_DIR && name != "." && name != "..") {
+                collectModaliases(path + "/" + name, modaliases);
+            } else if (entry->d_type == DT_REG && name == "modalias") {
+                std::ifstream file(path + "/" + name);
+                std::string modalias;
+                if (std::getline(file, modalias) && !modalias.empty()) {
+                    modaliases.push_back(modalias);
+                }
+            }
+        }
+        closedir(dir);
+    }
+    
+    // 用depmod索引补全配置中模块的依赖和文件路径
+    void resolveModuleInfo() {
+        for (auto& module : config_.modules) {
+            if (module.is_builtin) {
+                continue;
+            }
+            module.dependencies = module_loader_.dependencies(module.name);
+            if (module.file_path.empty()) {
+                module.file_path = module_loader_.modulePath(module.name);
+            }
+        }
+    }
+    
+    bool loadModuleInternal(const std::string& module_name) {
+        std::vector<ModuleLoadResult> results;
+        return loadModulesInternal({module_name}, results);
+    }
+    
+    bool loadModulesInternal(const std::vector<std::string>& module_names, std::vector<ModuleLoadResult>& results) {
+        // 配置中的模块参数随模块一起传给内核
+        std::unordered_map<std::string, std::string> options;
+        for (const auto& module : config_.modules) {
+            std::string joined;
+            for (const auto& parameter : module.parameters) {
+                joined += (joined.empty() ? "" : " ") + parameter;
+            }
+            if (!joined.empty()) {
+                options[ModuleLoader::normalizeName(module.name)] = joined;
             }
-            return true;
         }
         
-        return false;
+        bool success = module_loader_.load(module_names, options, results);
+        
+        // 刷新模块表，由模块表通知监听器，包括随之加载的依赖模块
+        module_table_.refresh();
+        
+        return success;
     }
     
     bool unloadModuleInternal(const std::string& module_name) {
-        std::string command = "modprobe -r " + module_name;
+        std::vector<std::string> removed;
+        std::string error;
+        bool success = module_loader_.unload(module_name, removed, error);
         
-        if (system(command.c_str()) == 0) {
-            // 通知监听器
-            for (const auto& listener : module_status_listeners_) {
-                listener(module_name, false);
-            }
-            return true;
-        }
+        // 刷新模块表，由模块表通知监听器，包括随之卸载的依赖模块
+        module_table_.refresh();
         
-        return false;
+        return success;
+    }
+    
+    void notifyModuleStatus(const std::string& name, bool loaded) {
+        std::vector<std::function<void(const std::string&, bool)>> listeners;
+        {
+            std::lock_guard<std::mutex> lock(module_listeners_mutex_);
+            listeners = module_status_listeners_;
+        }
+        for (const auto& listener : listeners) {
+            listener(name, loaded);
+        }
     }
 };
 
@@ -627,9 +700,16 @@ bool KernelConfigManager::applyConfig() { return impl_->applyConfig(); }
 bool KernelConfigManager::validateConfig() const { return impl_->validateConfig(); }
 std::string KernelConfigManager::getParameterValue(const std::string& param_name) const { return impl_->getParameterValue(param_name); }
 bool KernelConfigManager::setParameterValue(const std::string& param_name, const std::string& value) { return impl_->setParameterValue(param_name, value); }
+ParameterHandle KernelConfigManager::findParameter(const std::string& param_name) const { return impl_->findParameter(param_name); }
+std::string KernelConfigManager::getParameterValue(ParameterHandle handle) const { return impl_->getParameterValue(handle); }
+bool KernelConfigManager::setParameterValue(ParameterHandle handle, const std::string& value) { return impl_->setParameterValue(handle, value); }
 bool KernelConfigManager::loadModule(const std::string& module_name) { return impl_->loadModule(module_name); }
+bool KernelConfigManager::loadModules(const std::vector<std::string>& module_names, std::vector<ModuleLoadResult>& results) { return impl_->loadModules(module_names, results); }
 bool KernelConfigManager::unloadModule(const std::string& module_name) { return impl_->unloadModule(module_name); }
+std::vector<std::string> KernelConfigManager::resolveModalias(const std::string& modalias) { return impl_->resolveModalias(modalias); }
+bool KernelConfigManager::coldplug(std::vector<ModuleLoadResult>& results) { return impl_->coldplug(results); }
 std::vector<std::string> KernelConfigManager::getLoadedModules() const { return impl_->getLoadedModules(); }
+std::vector<LoadedModule> KernelConfigManager::getLoadedModuleTable() const { return impl_->getLoadedModuleTable(); }
 bool KernelConfigManager::setSysctl(const std::string& key, const std::string& value) { return impl_->setSysctl(key, value); }
 std::string KernelConfigManager::getSysctl(const std::string& key) const { return impl_->getSysctl(key); }
 bool KernelConfigManager::applySysctlSettings() { return impl_->applySysctlSettings(); }
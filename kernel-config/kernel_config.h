@@ -15,7 +15,12 @@
 #include <unordered_map>
 #include <memory>
 #include <fstream>
+#include <functional>
 #include <map>
+#include "module_alias.h"
+#include "module_loader.h"
+#include "module_table.h"
+#include "parameter_registry.h"
 
 // 简单的配置解析函数
 std::map<std::string, std::string> parseSimpleConfig(const std::string& content);
@@ -146,6 +151,28 @@ public:
      */
     bool setParameterValue(const std::string& param_name, const std::string& value);
     
+    /**
+     * @brief 查找参数句柄，频繁访问的参数可保存句柄，免去按名称查找
+     * @param param_name 参数名称
+     * @return 参数句柄，参数不存在时无效；重新加载配置后句柄失效
+     */
+    ParameterHandle findParameter(const std::string& param_name) const;
+    
+    /**
+     * @brief 通过句柄获取参数值
+     * @param handle 参数句柄
+     * @return 参数值，句柄无效时返回空字符串
+     */
+    std::string getParameterValue(ParameterHandle handle) const;
+    
+    /**
+     * @brief 通过句柄设置参数值
+     * @param handle 参数句柄
+     * @param value 参数值
+     * @return 设置是否成功
+     */
+    bool setParameterValue(ParameterHandle handle, const std::string& value);
+    
     /**
      * @brief 加载内核模块
      * @param module_name 模块名称
@@ -153,6 +180,14 @@ public:
      */
     bool loadModule(const std::string& module_name);
     
+    /**
+     * @brief 并行加载一批内核模块及其依赖
+     * @param module_names 模块名称列表
+     * @param results 输出每个模块的加载结果和耗时
+     * @return 请求的模块是否全部加载成功
+     */
+    bool loadModules(const std::vector<std::string>& module_names, std::vector<ModuleLoadResult>& results);
+    
     /**
      * @brief 卸载内核模块
      * @param module_name 模块名称
@@ -160,12 +195,32 @@ public:
      */
     bool unloadModule(const std::string& module_name);
     
+    /**
+     * @brief 查找设备modalias对应的候选模块
+     * @param modalias 设备modalias字符串
+     * @return 候选模块名称列表
+     */
+    std::vector<std::string> resolveModalias(const std::string& modalias);
+    
+    /**
+     * @brief 为/sys/devices下已存在的设备加载驱动模块
+     * @param results 输出每个模块的加载结果和耗时
+     * @return 候选模块是否全部加载成功
+     */
+    bool coldplug(std::vector<ModuleLoadResult>& results);
+    
     /**
      * @brief 获取已加载的模块列表
      * @return 模块名称列表
      */
     std::vector<std::string> getLoadedModules() const;
     
+    /**
+     * @brief 获取已加载模块的详细信息
+     * @return 按名称排序的模块列表，包括大小、引用计数、使用者和状态
+     */
+    std::vector<LoadedModule> getLoadedModuleTable() const;
+    
     /**
      * @brief 设置sysctl参数
      * @param key 参数键
@@ -0,0 +1,445 @@
+/**
+ * @file module_alias.cpp
+ * @brief 模块别名索引实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "module_alias.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CloudFlow::Kernel {
+
+namespace {
+
+// 索引文件布局：FileHeader | FileNode[] | FileEdge[] | FileValue[] | 字符串表
+// 前缀树只收录模式中第一个通配符之前的部分，单分支路径压缩成一条边；
+// 模式余下部分（以通配符开头，可能为空）和模块名作为值挂在前缀结束的节点上
+constexpr char kMagic[8] = {'C', 'F', 'A', 'L', 'I', 'A', 'S', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kSourceCount = 2;
+const char* const kSources[kSourceCount] = {"modules.alias", "modules.builtin.alias"};
+
+struct SourceStamp {
+    int64_t size;
+    int64_t mtime_ns;
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t node_count;
+    uint32_t edge_count;
+    uint32_t value_count;
+    uint32_t strings_size;
+    uint32_t reserved;
+    SourceStamp sources[kSourceCount];
+};
+
+struct FileNode {
+    uint32_t first_edge;    ///< 出边按首字符排序
+    uint32_t edge_count;
+    uint32_t first_value;   ///< 值按模式余下部分排序，相同余下部分只需匹配一次
+    uint32_t value_count;
+};
+
+struct FileEdge {
+    uint32_t label;         ///< 边上字符串在字符串表中的偏移
+    uint16_t length;
+    uint8_t first;          ///< 边上字符串的首字符
+    uint8_t reserved;
+    uint32_t child;
+};
+
+struct FileValue {
+    uint32_t tail;          ///< 模式余下部分在字符串表中的偏移
+    uint32_t name;          ///< 模块名在字符串表中的偏移
+    uint32_t line;          ///< 别名在源文件中的序号，决定结果顺序
+};
+
+bool isWildcard(char c) {
+    return c == '*' || c == '?' || c == '[';
+}
+
+bool stampOf(const std::string& path, SourceStamp& stamp) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        stamp = SourceStamp{-1, 0};
+        return false;
+    }
+    stamp.size = st.st_size;
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
+class TrieBuilder {
+public:
+    TrieBuilder() : nodes_(1) {}
+    
+    void add(const std::string& pattern, const std::string& module, uint32_t line) {
+        size_t wildcard = std::find_if(pattern.begin(), pattern.end(), isWildcard) - pattern.begin();
+        uint32_t node = 0;
+        for (size_t i = 0; i < wildcard; ++i) {
+            auto it = nodes_[node].children.find(pattern[i]);
+            if (it == nodes_[node].children.end()) {
+                uint32_t child = static_cast<uint32_t>(nodes_.size());
+                nodes_[node].children.emplace(pattern[i], child);
+                nodes_.emplace_back();
+                node = child;
+            } else {
+                node = it->second;
+            }
+        }
+        nodes_[node].values.push_back(Value{pattern.substr(wildcard), module, line});
+    }
+    
+    std::vector<char> serialize(const SourceStamp (&sources)[kSourceCount]) {
+        std::vector<FileNode> nodes;
+        std::vector<FileEdge> edges;
+        std::vector<FileValue> values;
+        std::string strings;
+        std::unordered_map<std::string, uint32_t> offsets;
+        auto intern = [&](const std::string& text) {
+            auto it = offsets.find(text);
+            if (it != offsets.end()) {
+                return it->second;
+            }
+            uint32_t offset = static_cast<uint32_t>(strings.size());
+            strings.append(text).push_back('\0');
+            offsets.emplace(text, offset);
+            return offset;
+        };
+        
+        // 按广度优先编号，每个节点的出边在处理该节点时连续写出
+        std::vector<uint32_t> order{0};
+        for (size_t i = 0; i < order.size(); ++i) {
+            Node& node = nodes_[order[i]];
+            FileNode file_node{static_cast<uint32_t>(edges.size()), static_cast<uint32_t>(node.children.size()),
+                               static_cast<uint32_t>(values.size()), static_cast<uint32_t>(node.values.size())};
+            
+            for (const auto& child : node.children) {
+                std::string label(1, child.first);
+                uint32_t target = child.second;
+                while (nodes_[target].values.empty() && nodes_[target].children.size() == 1 && label.size() < 0xffff) {
+                    label += nodes_[target].children.begin()->first;
+                    target = nodes_[target].children.begin()->second;
+                }
+                edges.push_back(FileEdge{intern(label), static_cast<uint16_t>(label.size()),
+                                         static_cast<uint8_t>(label[0]), 0, static_cast<uint32_t>(order.size())});
+                order.push_back(target);
+            }
+            
+            std::sort(node.values.begin(), node.values.end(), [](const Value& a, const Value& b) {
+                return std::tie(a.tail, a.line) < std::tie(b.tail, b.line);
+            });
+            for (const auto& value : node.values) {
+                values.push_back(FileValue{intern(value.tail), intern(value.module), value.line});
+            }
+            nodes.push_back(file_node);
+        }
+        
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.node_count = static_cast<uint32_t>(nodes.size());
+        header.edge_count = static_cast<uint32_t>(edges.size());
+        header.value_count = static_cast<uint32_t>(values.size());
+        header.strings_size = static_cast<uint32_t>(strings.size());
+        std::copy(std::begin(sources), std::end(sources), header.sources);
+        
+        std::vector<char> data;
+        auto append = [&data](const void* bytes, size_t size) {
+            data.insert(data.end(), static_cast<const char*>(bytes), static_cast<const char*>(bytes) + size);
+        };
+        append(&header, sizeof(header));
+        append(nodes.data(), nodes.size() * sizeof(FileNode));
+        append(edges.data(), edges.size() * sizeof(FileEdge));
+        append(values.data(), values.size() * sizeof(FileValue));
+        append(strings.data(), strings.size());
+        return data;
+    }
+
+private:
+    struct Value {
+        std::string tail;
+        std::string module;
+        uint32_t line;
+    };
+    
+    struct Node {
+        std::map<char, uint32_t> children;
+        std::vector<Value> values;
+    };
+    
+    std::vector<Node> nodes_;
+};
+
+} // namespace
+
+struct ModuleAliasIndex::Mapping {
+    void* address = MAP_FAILED;     ///< mmap的索引文件
+    std::vector<char> buffer;       ///< 索引文件无法写入时在内存中的编译结果
+    size_t size = 0;
+    
+    const FileHeader* header = nullptr;
+    const FileNode* nodes = nullptr;
+    const FileEdge* edges = nullptr;
+    const FileValue* values = nullptr;
+    const char* strings = nullptr;
+    
+    ~Mapping() {
+        if (address != MAP_FAILED) {
+            munmap(address, size);
+        }
+    }
+    
+    // 检查布局，损坏的索引文件按不存在处理
+    bool attach(const char* data) {
+        if (size < sizeof(FileHeader)) {
+            return false;
+        }
+        header = reinterpret_cast<const FileHeader*>(data);
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+            header->node_count == 0) {
+            return false;
+        }
+        
+        uint64_t expected = sizeof(FileHeader) + uint64_t(header->node_count) * sizeof(FileNode) +
+                            uint64_t(header->edge_count) * sizeof(FileEdge) +
+                            uint64_t(header->value_count) * sizeof(FileValue) + header->strings_size;
+        if (expected != size || (header->strings_size != 0 && data[size - 1] != '\0')) {
+            return false;
+        }
+        
+        nodes = reinterpret_cast<const FileNode*>(data + sizeof(FileHeader));
+        edges = reinterpret_cast<const FileEdge*>(nodes + header->node_count);
+        values = reinterpret_cast<const FileValue*>(edges + header->edge_count);
+        strings = reinterpret_cast<const char*>(values + header->value_count);
+        
+        for (uint32_t i = 0; i < header->node_count; ++i) {
+            const FileNode& node = nodes[i];
+            if (uint64_t(node.first_edge) + node.edge_count > header->edge_count ||
+                uint64_t(node.first_value) + node.value_count > header->value_count) {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->edge_count; ++i) {
+            if (edges[i].child >= header->node_count || edges[i].length == 0 ||
+                uint64_t(edges[i].label) + edges[i].length >= header->strings_size) {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->value_count; ++i) {
+            if (values[i].tail >= header->strings_size || values[i].name >= header->strings_size) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+ModuleAliasIndex::ModuleAliasIndex(const std::string& module_dir, const std::string& index_file)
+    : module_dir_(module_dir)
+    , index_file_(index_file) {
+    if (index_file_.empty()) {
+        std::string release = module_dir_.substr(module_dir_.rfind('/') + 1);
+        index_file_ = "/var/cache/cloudflow/modules.alias-" + release + ".idx";
+    }
+}
+
+ModuleAliasIndex::~ModuleAliasIndex() = default;
+
+bool ModuleAliasIndex::stale(const Mapping& mapping) const {
+    for (size_t i = 0; i < kSourceCount; ++i) {
+        SourceStamp stamp;
+        stampOf(module_dir_ + "/" + kSources[i], stamp);
+        if (stamp.size != mapping.header->sources[i].size || stamp.mtime_ns != mapping.header->sources[i].mtime_ns) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModuleAliasIndex::open() {
+    int fd = ::open(index_file_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+        auto mapping = std::make_shared<Mapping>();
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            mapping->size = static_cast<size_t>(st.st_size);
+            mapping->address = mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        
+        if (mapping->address != MAP_FAILED &&
+            mapping->attach(static_cast<const char*>(mapping->address)) && !stale(*mapping)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            mapping_ = std::move(mapping);
+            last_check_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+            return true;
+        }
+    }
+    return rebuild();
+}
+
+bool ModuleAliasIndex::rebuild() {
+    std::lock_guard<std::mutex> rebuild_lock(rebuild_mutex_);
+    
+    // 格式：alias pci:v00008086d00001533sv*sd*bc*sc*i* igb
+    TrieBuilder builder;
+    SourceStamp sources[kSourceCount];
+    bool found = false;
+    uint32_t line_number = 0;
+    for (size_t i = 0; i < kSourceCount; ++i) {
+        std::string path = module_dir_ + "/" + kSources[i];
+        stampOf(path, sources[i]);
+        std::ifstream file(path);
+        found = found || file.is_open();
+        
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string keyword;
+            std::string pattern;
+            std::string module;
+            if (fields >> keyword >> pattern >> module && keyword == "alias") {
+                std::replace(module.begin(), module.end(), '-', '_');
+                builder.add(pattern, module, line_number++);
+            }
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    
+    std::vector<char> data = builder.serialize(sources);
+    auto mapping = std::make_shared<Mapping>();
+    mapping->size = data.size();
+    
+    // 写入临时文件后改名，正在使用旧映射的进程不受影响
+    std::string directory = index_file_.substr(0, index_file_.rfind('/'));
+    mkdir(directory.c_str(), 0755);
+    std::string temporary = index_file_ + ".tmp";
+    int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd != -1) {
+        bool written = ::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()) &&
+                       fsync(fd) == 0 && rename(temporary.c_str(), index_file_.c_str()) == 0;
+        if (written) {
+            mapping->address = mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+        } else {
+            unlink(temporary.c_str());
+        }
+        close(fd);
+    }
+    
+    if (mapping->address != MAP_FAILED) {
+        mapping->attach(static_cast<const char*>(mapping->address));
+    } else {
+        mapping->buffer = std::move(data);
+        mapping->attach(mapping->buffer.data());
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    mapping_ = std::move(mapping);
+    last_check_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    return true;
+}
+
+std::shared_ptr<const ModuleAliasIndex::Mapping> ModuleAliasIndex::current() {
+    std::shared_ptr<const Mapping> mapping;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        mapping = mapping_;
+    }
+    if (!mapping) {
+        open();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return mapping_;
+    }
+    
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t last = last_check_.load();
+    if (now - last >= 1000 && last_check_.compare_exchange_strong(last, now) && stale(*mapping)) {
+        // depmod重新生成了别名文件
+        if (rebuild()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            mapping = mapping_;
+        }
+    }
+    return mapping;
+}
+
+std::vector<std::string> ModuleAliasIndex::lookup(const std::string& modalias) {
+    std::shared_ptr<const Mapping> mapping = current();
+    if (!mapping) {
+        return {};
+    }
+    
+    // 沿modalias走一条路径，对经过的每个节点上的模式余下部分做fnmatch
+    std::vector<const FileValue*> matches;
+    uint32_t index = 0;
+    size_t position = 0;
+    for (;;) {
+        const FileNode& node = mapping->nodes[index];
+        const char* rest = modalias.c_str() + position;
+        uint32_t tail = UINT32_MAX;
+        bool matched = false;
+        for (uint32_t i = 0; i < node.value_count; ++i) {
+            const FileValue& value = mapping->values[node.first_value + i];
+            if (value.tail != tail) {
+                tail = value.tail;
+                const char* pattern = mapping->strings + tail;
+                matched = *pattern == '\0' ? *rest == '\0' : fnmatch(pattern, rest, 0) == 0;
+            }
+            if (matched) {
+                matches.push_back(&value);
+            }
+        }
+        if (position == modalias.size()) {
+            break;
+        }
+        
+        const FileEdge* begin = mapping->edges + node.first_edge;
+        const FileEdge* end = begin + node.edge_count;
+        uint8_t c = static_cast<uint8_t>(modalias[position]);
+        const FileEdge* edge = std::lower_bound(begin, end, c,
+                                                [](const FileEdge& e, uint8_t value) { return e.first < value; });
+        if (edge == end || edge->first != c || modalias.size() - position < edge->length ||
+            modalias.compare(position, edge->length, mapping->strings + edge->label, edge->length) != 0) {
+            break;
+        }
+        index = edge->child;
+        position += edge->length;
+    }
+    
+    std::sort(matches.begin(), matches.end(),
+              [](const FileValue* a, const FileValue* b) { return a->line < b->line; });
+    std::vector<std::string> modules;
+    for (const FileValue* match : matches) {
+        std::string name = mapping->strings + match->name;
+        if (std::find(modules.begin(), modules.end(), name) == modules.end()) {
+            modules.push_back(std::move(name));
+        }
+    }
+    return modules;
+}
+
+} // namespace CloudFlow::Kernel
@@ -0,0 +1,84 @@
+/**
+ * @file module_alias.h
+ * @brief 模块别名索引
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 把modules.alias和modules.builtin.alias编译成可直接mmap的二进制前缀树，
+ * 用设备的modalias字符串查找候选模块。模式中第一个通配符之前的部分建成压缩前缀树，
+ * 查找时沿modalias只走一条路径，仅对路径上节点挂着的模式余下部分做fnmatch，
+ * 而不是对全部别名逐条匹配。
+ * 索引文件记录源文件的大小和修改时间，源文件未变化时直接映射已有索引，
+ * 变化时才重新编译并原子替换
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CloudFlow::Kernel {
+
+/**
+ * @class ModuleAliasIndex
+ * @brief 模块别名索引
+ *
+ * 线程安全；重新编译期间查找继续使用旧索引
+ */
+class ModuleAliasIndex {
+public:
+    /**
+     * @brief 构造函数
+     * @param module_dir 模块目录，如/lib/modules/<内核版本>
+     * @param index_file 索引文件路径，为空时使用/var/cache/cloudflow/modules.alias-<内核版本>.idx
+     */
+    explicit ModuleAliasIndex(const std::string& module_dir, const std::string& index_file = "");
+    
+    ~ModuleAliasIndex();
+    
+    ModuleAliasIndex(const ModuleAliasIndex&) = delete;
+    ModuleAliasIndex& operator=(const ModuleAliasIndex&) = delete;
+    
+    /**
+     * @brief 映射索引文件，索引不存在或已过期时重新编译
+     * @return 索引可用返回true
+     */
+    bool open();
+    
+    /**
+     * @brief 重新编译索引
+     *
+     * 索引文件无法写入时只在内存中使用编译结果
+     * @return 编译成功返回true
+     */
+    bool rebuild();
+    
+    /**
+     * @brief 查找modalias对应的候选模块
+     *
+     * 每秒至多检查一次源文件是否变化，变化时先重新编译
+     * @param modalias 设备modalias，如/sys/devices/.../modalias的内容
+     * @return 候选模块名称，按别名在源文件中的顺序排列，不重复
+     */
+    std::vector<std::string> lookup(const std::string& modalias);
+
+private:
+    struct Mapping;
+    
+    bool stale(const Mapping& mapping) const;
+    std::shared_ptr<const Mapping> current();
+    
+    std::string module_dir_;
+    std::string index_file_;
+    
+    std::mutex mutex_;
+    std::shared_ptr<const Mapping> mapping_;
+    std::mutex rebuild_mutex_;                          ///< 同一时刻只有一个线程重新编译
+    std::atomic<int64_t> last_check_{0};                ///< 上次检查源文件的时间，毫秒
+};
+
+} // namespace CloudFlow::Kernel
@@ -0,0 +1,697 @@
+/**
+ * @file module_loader.cpp
+ * @brief 内核模块加载器实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "module_loader.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <fcntl.h>
+#include <linux/module.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#ifdef CLOUDFLOW_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CLOUDFLOW_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef CLOUDFLOW_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace CloudFlow::Kernel {
+
+namespace {
+
+enum class Compression {
+    None,
+    Gzip,
+    Xz,
+    Zstd
+};
+
+Compression compressionOf(const std::string& path) {
+    auto endsWith = [&path](const char* suffix) {
+        size_t length = std::strlen(suffix);
+        return path.size() >= length && path.compare(path.size() - length, length, suffix) == 0;
+    };
+    if (endsWith(".gz")) {
+        return Compression::Gzip;
+    }
+    if (endsWith(".xz")) {
+        return Compression::Xz;
+    }
+    if (endsWith(".zst")) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+// 模块文件名去掉目录、".ko"及压缩后缀
+std::string moduleNameOf(const std::string& path) {
+    std::string name = path.substr(path.rfind('/') + 1);
+    size_t ko = name.find(".ko");
+    if (ko != std::string::npos) {
+        name.erase(ko);
+    }
+    return ModuleLoader::normalizeName(name);
+}
+
+bool readFile(int fd, std::vector<unsigned char>& data) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+    data.resize(static_cast<size_t>(st.st_size));
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t count = ::read(fd, data.data() + offset, data.size() - offset);
+        if (count == -1 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+#ifdef CLOUDFLOW_HAVE_ZLIB
+bool inflateGzip(const std::vector<unsigned char>& input, std::vector<unsigned char>& output) {
+    z_stream stream{};
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        return false;
+    }
+    stream.next_in = const_cast<unsigned char*>(input.data());
+    stream.avail_in = static_cast<uInt>(input.size());
+    
+    output.resize(std::max<size_t>(input.size() * 4, 65536));
+    int status = Z_OK;
+    while (status == Z_OK) {
+        if (stream.total_out == output.size()) {
+            output.resize(output.size() * 2);
+        }
+        stream.next_out = output.data() + stream.total_out;
+        stream.avail_out = static_cast<uInt>(output.size() - stream.total_out);
+        status = inflate(&stream, Z_NO_FLUSH);
+    }
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+    return status == Z_STREAM_END;
+}
+#endif
+
+#ifdef CLOUDFLOW_HAVE_LZMA
+bool decodeXz(const std::vector<unsigned char>& input, std::vector<unsigned char>& output) {
+    lzma_stream stream = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+        return false;
+    }
+    stream.next_in = input.data();
+    stream.avail_in = input.size();
+    
+    output.resize(std::max<size_t>(input.size() * 4, 65536));
+    lzma_ret status = LZMA_OK;
+    while (status == LZMA_OK) {
+        if (stream.total_out == output.size()) {
+            output.resize(output.size() * 2);
+        }
+        stream.next_out = output.data() + stream.total_out;
+        stream.avail_out = output.size() - stream.total_out;
+        status = lzma_code(&stream, LZMA_FINISH);
+    }
+    output.resize(stream.total_out);
+    lzma_end(&stream);
+    return status == LZMA_STREAM_END;
+}
+#endif
+
+#ifdef CLOUDFLOW_HAVE_ZSTD
+bool decodeZstd(const std::vector<unsigned char>& input, std::vector<unsigned char>& output) {
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    if (context == nullptr) {
+        return false;
+    }
+    
+    ZSTD_inBuffer in{input.data(), input.size(), 0};
+    ZSTD_outBuffer out{nullptr, 0, 0};
+    output.resize(std::max<size_t>(input.size() * 4, 65536));
+    size_t status = 1;
+    while (status != 0 || in.pos < in.size) {
+        if (out.pos == output.size()) {
+            output.resize(output.size() * 2);
+        }
+        out.dst = output.data();
+        out.size = output.size();
+        size_t consumed = in.pos;
+        size_t produced = out.pos;
+        status = ZSTD_decompressStream(context, &out, &in);
+        if (ZSTD_isError(status) || (in.pos == consumed && out.pos == produced)) {
+            break; // 数据损坏或输入截断
+        }
+    }
+    output.resize(out.pos);
+    ZSTD_freeDCtx(context);
+    return status == 0 && in.pos == in.size;
+}
+#endif
+
+// 构建时找到了对应的解压库
+bool canDecompress(Compression compression) {
+    switch (compression) {
+        #ifdef CLOUDFLOW_HAVE_ZLIB
+            case Compression::Gzip: return true;
+        #endif
+        #ifdef CLOUDFLOW_HAVE_LZMA
+            case Compression::Xz: return true;
+        #endif
+        #ifdef CLOUDFLOW_HAVE_ZSTD
+            case Compression::Zstd: return true;
+        #endif
+        default: return false;
+    }
+}
+
+bool decompress(Compression compression, const std::vector<unsigned char>& input, std::vector<unsigned char>& output) {
+    switch (compression) {
+        #ifdef CLOUDFLOW_HAVE_ZLIB
+            case Compression::Gzip: return inflateGzip(input, output);
+        #endif
+        #ifdef CLOUDFLOW_HAVE_LZMA
+            case Compression::Xz: return decodeXz(input, output);
+        #endif
+        #ifdef CLOUDFLOW_HAVE_ZSTD
+            case Compression::Zstd: return decodeZstd(input, output);
+        #endif
+        default:
+            (void)input;
+            (void)output;
+            return false;
+    }
+}
+
+// 内核自带解压支持的格式，见/sys/module/compression
+Compression kernelCompression() {
+    std::ifstream file("/sys/module/compression");
+    std::string format;
+    file >> format;
+    if (format == "gzip") {
+        return Compression::Gzip;
+    }
+    if (format == "xz") {
+        return Compression::Xz;
+    }
+    if (format == "zstd") {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+std::unordered_set<std::string> readLoadedModules() {
+    std::unordered_set<std::string> loaded;
+    std::ifstream file("/proc/modules");
+    std::string line;
+    while (std::getline(file, line)) {
+        loaded.insert(line.substr(0, line.find(' ')));
+    }
+    return loaded;
+}
+
+std::string moduleRefcount(const std::string& name) {
+    std::ifstream file("/sys/module/" + name + "/refcnt");
+    std::string refcount;
+    file >> refcount;
+    return refcount;
+}
+
+} // namespace
+
+struct ModuleLoader::Index {
+    struct Module {
+        std::string path;                       ///< 绝对路径
+        std::vector<std::string> closure;       ///< modules.dep中的全部依赖
+        std::vector<std::string> dependencies;  ///< 直接依赖
+        std::vector<std::string> pre;           ///< softdep pre，先于本模块加载
+        std::vector<std::string> post;          ///< softdep post，在本模块之后加载
+    };
+    
+    std::unordered_map<std::string, Module> modules;
+    std::unordered_set<std::string> builtin;
+    Compression kernel_compression = Compression::None;
+};
+
+struct ModuleLoader::Node {
+    std::string path;
+    std::string options;
+    std::vector<size_t> hard_dependents;    ///< 依赖本模块，本模块失败时随之失败
+    std::vector<size_t> soft_dependents;    ///< 只需排在本模块之后
+    size_t hard_pending = 0;
+    size_t soft_pending = 0;
+    std::string failed_dependency;
+    ModuleLoadResult result;
+};
+
+ModuleLoader::ModuleLoader(const std::string& module_dir) : module_dir_(module_dir) {
+    if (module_dir_.empty()) {
+        struct utsname info;
+        if (uname(&info) == 0) {
+            module_dir_ = std::string("/lib/modules/") + info.release;
+        }
+    }
+}
+
+ModuleLoader::~ModuleLoader() = default;
+
+std::string ModuleLoader::normalizeName(const std::string& name) {
+    std::string normalized = name;
+    std::replace(normalized.begin(), normalized.end(), '-', '_');
+    return normalized;
+}
+
+bool ModuleLoader::loadIndex() {
+    std::ifstream dep_file(module_dir_ + "/modules.dep");
+    if (!dep_file.is_open()) {
+        return false;
+    }
+    
+    auto index = std::make_shared<Index>();
+    auto absolute = [this](const std::string& path) {
+        return path.front() == '/' ? path : module_dir_ + "/" + path;
+    };
+    
+    // 格式：kernel/drivers/a.ko.xz: kernel/lib/b.ko.xz kernel/lib/c.ko.xz
+    std::string line;
+    while (std::getline(dep_file, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || colon == 0) {
+            continue;
+        }
+        
+        std::string path = line.substr(0, colon);
+        Index::Module& module = index->modules[moduleNameOf(path)];
+        module.path = absolute(path);
+        
+        std::istringstream deps(line.substr(colon + 1));
+        std::string dep;
+        while (deps >> dep) {
+            module.closure.push_back(moduleNameOf(dep));
+        }
+    }
+    
+    // 闭包中能经由其他依赖得到的模块不是直接依赖
+    for (auto& entry : index->modules) {
+        Index::Module& module = entry.second;
+        std::unordered_set<std::string> indirect;
+        for (const auto& dep : module.closure) {
+            auto it = index->modules.find(dep);
+            if (it != index->modules.end()) {
+                indirect.insert(it->second.closure.begin(), it->second.closure.end());
+            }
+        }
+        for (const auto& dep : module.closure) {
+            if (indirect.count(dep) == 0) {
+                module.dependencies.push_back(dep);
+            }
+        }
+    }
+    
+    // 格式：softdep name pre: a b post: c
+    std::ifstream softdep_file(module_dir_ + "/modules.softdep");
+    while (std::getline(softdep_file, line)) {
+        std::istringstream fields(line);
+        std::string keyword;
+        std::string name;
+        if (!(fields >> keyword >> name) || keyword != "softdep") {
+            continue;
+        }
+        
+        auto it = index->modules.find(normalizeName(name));
+        if (it == index->modules.end()) {
+            continue;
+        }
+        
+        std::vector<std::string>* target = nullptr;
+        std::string token;
+        while (fields >> token) {
+            if (token == "pre:") {
+                target = &it->second.pre;
+            } else if (token == "post:") {
+                target = &it->second.post;
+            } else if (target != nullptr) {
+                target->push_back(normalizeName(token));
+            }
+        }
+    }
+    
+    std::ifstream builtin_file(module_dir_ + "/modules.builtin");
+    while (std::getline(builtin_file, line)) {
+        if (!line.empty()) {
+            index->builtin.insert(moduleNameOf(line));
+        }
+    }
+    
+    index->kernel_compression = kernelCompression();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_ = std::move(index);
+    return true;
+}
+
+std::shared_ptr<const ModuleLoader::Index> ModuleLoader::index() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_) {
+            return index_;
+        }
+    }
+    loadIndex();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_;
+}
+
+std::vector<std::string> ModuleLoader::dependencies(const std::string& name) {
+    std::shared_ptr<const Index> current = index();
+    if (current) {
+        auto it = current->modules.find(normalizeName(name));
+        if (it != current->modules.end()) {
+            return it->second.dependencies;
+        }
+    }
+    return {};
+}
+
+std::string ModuleLoader::modulePath(const std::string& name) {
+    std::shared_ptr<const Index> current = index();
+    if (current) {
+        auto it = current->modules.find(normalizeName(name));
+        if (it != current->modules.end()) {
+            return it->second.path;
+        }
+    }
+    return std::string();
+}
+
+void ModuleLoader::loadOne(const Index& index, Node& node) {
+    ModuleLoadResult& result = node.result;
+    auto begin = std::chrono::steady_clock::now();
+    
+    int fd = open(node.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        result.error = std::string("无法打开模块文件: ") + std::strerror(errno);
+        return;
+    }
+    
+    Compression compression = compressionOf(node.path);
+    long status;
+    if (compression == Compression::None) {
+        status = syscall(SYS_finit_module, fd, node.options.c_str(), 0);
+    } else if (compression == index.kernel_compression) {
+        status = syscall(SYS_finit_module, fd, node.options.c_str(), MODULE_INIT_COMPRESSED_FILE);
+    } else if (!canDecompress(compression)) {
+        close(fd);
+        result.error = "内核不支持该模块的压缩格式，构建时也未找到对应的解压库";
+        return;
+    } else {
+        std::vector<unsigned char> data;
+        std::vector<unsigned char> image;
+        bool decoded = readFile(fd, data) && decompress(compression, data, image);
+        if (!decoded) {
+            close(fd);
+            result.error = "模块文件解压失败";
+            return;
+        }
+        status = syscall(SYS_init_module, image.data(), image.size(), node.options.c_str());
+    }
+    int saved_errno = errno;
+    close(fd);
+    
+    result.load_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin);
+    if (status == 0) {
+        result.success = true;
+    } else if (saved_errno == EEXIST) {
+        // 其他进程同时加载了该模块
+        result.success = true;
+        result.already_loaded = true;
+    } else {
+        result.error = std::strerror(saved_errno);
+    }
+}
+
+bool ModuleLoader::load(const std::vector<std::string>& names,
+                        const std::unordered_map<std::string, std::string>& options,
+                        std::vector<ModuleLoadResult>& results) {
+    std::shared_ptr<const Index> current = index();
+    if (!current) {
+        for (const auto& name : names) {
+            ModuleLoadResult result;
+            result.name = normalizeName(name);
+            result.error = "无法读取" + module_dir_ + "/modules.dep";
+            results.push_back(std::move(result));
+        }
+        return false;
+    }
+    
+    // 求依赖闭包；已加载和内置的模块直接记为成功，不参与调度
+    std::unordered_set<std::string> loaded = readLoadedModules();
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, size_t> positions;
+    std::unordered_map<std::string, bool> satisfied;    // 不参与调度的模块，是否已在内核中
+    std::vector<std::pair<std::string, bool>> stack;    // 模块名称，是否为请求或硬依赖
+    for (auto name = names.rbegin(); name != names.rend(); ++name) {
+        stack.emplace_back(normalizeName(*name), true);
+    }
+    while (!stack.empty()) {
+        auto [name, required] = std::move(stack.back());
+        stack.pop_back();
+        if (positions.count(name) != 0 || satisfied.count(name) != 0) {
+            continue;
+        }
+        
+        auto it = current->modules.find(name);
+        bool present = loaded.count(name) != 0 || current->builtin.count(name) != 0;
+        if (present || it == current->modules.end()) {
+            if (!present && !required) {
+                continue; // softdep指向不存在的模块时忽略
+            }
+            ModuleLoadResult result;
+            result.name = name;
+            result.success = present;
+            result.already_loaded = present;
+            if (!present) {
+                result.error = "模块不存在";
+            }
+            results.push_back(std::move(result));
+            satisfied.emplace(name, present);
+            continue;
+        }
+        
+        positions.emplace(name, nodes.size());
+        Node node;
+        node.path = it->second.path;
+        node.result.name = name;
+        auto option = options.find(name);
+        if (option != options.end()) {
+            node.options = option->second;
+        }
+        nodes.push_back(std::move(node));
+        
+        for (const auto& dep : it->second.post) {
+            stack.emplace_back(dep, false);
+        }
+        for (const auto& dep : it->second.pre) {
+            stack.emplace_back(dep, false);
+        }
+        for (const auto& dep : it->second.dependencies) {
+            stack.emplace_back(dep, true);
+        }
+    }
+    
+    // 建立依赖边：直接依赖为硬边，softdep只约束顺序
+    for (const auto& position : positions) {
+        const Index::Module& module = current->modules.at(position.first);
+        Node& node = nodes[position.second];
+        for (const auto& dep : module.dependencies) {
+            auto other = positions.find(dep);
+            if (other != positions.end()) {
+                nodes[other->second].hard_dependents.push_back(position.second);
+                ++node.hard_pending;
+            } else if (!satisfied.at(dep)) {
+                node.failed_dependency = dep;
+            }
+        }
+        for (const auto& dep : module.pre) {
+            auto other = positions.find(dep);
+            if (other != positions.end()) {
+                nodes[other->second].soft_dependents.push_back(position.second);
+                ++node.soft_pending;
+            }
+        }
+        for (const auto& dep : module.post) {
+            auto other = positions.find(dep);
+            if (other != positions.end()) {
+                node.soft_dependents.push_back(other->second);
+                ++nodes[other->second].soft_pending;
+            }
+        }
+    }
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> ready;
+    size_t remaining = nodes.size();
+    size_t running = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].hard_pending == 0 && nodes[i].soft_pending == 0) {
+            ready.push_back(i);
+        }
+    }
+    
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [&]() { return !ready.empty() || remaining == 0 || running == 0; });
+            if (remaining == 0) {
+                return;
+            }
+            
+            if (ready.empty()) {
+                // 无可执行模块又无正在加载的模块：softdep成环，先忽略softdep顺序；
+                // 仍无法推进则是modules.dep本身成环
+                for (size_t i = 0; i < nodes.size(); ++i) {
+                    Node& node = nodes[i];
+                    if (node.soft_pending != 0) {
+                        node.soft_pending = 0;
+                        if (node.hard_pending == 0) {
+                            ready.push_back(i);
+                        }
+                    }
+                }
+                if (ready.empty()) {
+                    for (auto& node : nodes) {
+                        if (node.hard_pending != 0) {
+                            node.result.error = "模块依赖成环";
+                            node.hard_pending = 0;
+                        }
+                    }
+                    remaining = 0;
+                    cv.notify_all();
+                    return;
+                }
+            }
+            
+            size_t position = ready.front();
+            ready.pop_front();
+            Node& node = nodes[position];
+            ++running;
+            lock.unlock();
+            
+            if (!node.failed_dependency.empty()) {
+                node.result.error = "依赖模块加载失败: " + node.failed_dependency;
+            } else {
+                loadOne(*current, node);
+            }
+            
+            lock.lock();
+            --running;
+            --remaining;
+            for (size_t dependent : node.hard_dependents) {
+                Node& other = nodes[dependent];
+                if (!node.result.success && other.failed_dependency.empty()) {
+                    other.failed_dependency = node.result.name;
+                }
+                if (--other.hard_pending == 0 && other.soft_pending == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+            for (size_t dependent : node.soft_dependents) {
+                Node& other = nodes[dependent];
+                if (other.soft_pending != 0 && --other.soft_pending == 0 && other.hard_pending == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+            cv.notify_all();
+        }
+    };
+    
+    size_t worker_count = std::min<size_t>(nodes.size(), std::max(2u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    if (!nodes.empty()) {
+        worker();
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    
+    for (auto& node : nodes) {
+        results.push_back(std::move(node.result));
+    }
+    
+    bool all_loaded = true;
+    for (const auto& name : names) {
+        std::string normalized = normalizeName(name);
+        auto it = std::find_if(results.begin(), results.end(),
+                               [&normalized](const ModuleLoadResult& result) { return result.name == normalized; });
+        if (it == results.end() || !it->success) {
+            all_loaded = false;
+        }
+    }
+    return all_loaded;
+}
+
+bool ModuleLoader::unload(const std::string& name, std::vector<std::string>& removed, std::string& error) {
+    std::string normalized = normalizeName(name);
+    if (syscall(SYS_delete_module, normalized.c_str(), O_NONBLOCK) != 0) {
+        error = errno == EWOULDBLOCK ? "模块正在使用" :
+                errno == ENOENT ? "模块未加载" : std::strerror(errno);
+        return false;
+    }
+    removed.push_back(normalized);
+    
+    // 与modprobe -r一致，继续卸载引用计数已降为0的依赖模块
+    std::shared_ptr<const Index> current = index();
+    if (!current) {
+        return true;
+    }
+    auto it = current->modules.find(normalized);
+    if (it == current->modules.end()) {
+        return true;
+    }
+    
+    std::vector<std::string> candidates = it->second.closure;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (auto candidate = candidates.begin(); candidate != candidates.end();) {
+            if (moduleRefcount(*candidate) == "0" &&
+                syscall(SYS_delete_module, candidate->c_str(), O_NONBLOCK) == 0) {
+                removed.push_back(*candidate);
+                candidate = candidates.erase(candidate);
+                progress = true;
+            } else {
+                ++candidate;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace CloudFlow::Kernel
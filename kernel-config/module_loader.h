@@ -0,0 +1,124 @@
+/**
+ * @file module_loader.h
+ * @brief 内核模块加载器
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 直接通过finit_module/delete_module加载和卸载模块，不经过modprobe。
+ * 依赖关系来自depmod生成的modules.dep和modules.softdep；一次加载请求先求出
+ * 全部依赖的闭包，再由多个线程按依赖顺序并行加载，互不依赖的链同时进行。
+ * 压缩模块优先交给内核解压，内核不支持该压缩格式时在用户态解压后用init_module加载；
+ * 用户态解压需要构建时找到zlib、liblzma或libzstd，缺少的格式只能由内核解压
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudFlow::Kernel {
+
+/**
+ * @struct ModuleLoadResult
+ * @brief 单个模块的加载结果
+ */
+struct ModuleLoadResult {
+    std::string name;                       ///< 模块名称
+    bool success = false;                   ///< 模块已在内核中
+    bool already_loaded = false;            ///< 加载前已在内核中或为内置模块，未执行加载
+    std::string error;                      ///< 失败原因
+    std::chrono::microseconds load_time{0}; ///< 读取、解压和加载的耗时
+};
+
+/**
+ * @class ModuleLoader
+ * @brief 内核模块加载器
+ *
+ * 线程安全；索引整体替换，加载过程中重新读取索引不影响正在进行的加载
+ */
+class ModuleLoader {
+public:
+    /**
+     * @brief 构造函数
+     * @param module_dir 模块目录，为空时使用/lib/modules/<当前内核版本>
+     */
+    explicit ModuleLoader(const std::string& module_dir = "");
+    
+    ~ModuleLoader();
+    
+    ModuleLoader(const ModuleLoader&) = delete;
+    ModuleLoader& operator=(const ModuleLoader&) = delete;
+    
+    /**
+     * @brief 读取modules.dep、modules.softdep和modules.builtin
+     * @return modules.dep读取成功返回true
+     */
+    bool loadIndex();
+    
+    /**
+     * @brief 获取模块的直接依赖
+     *
+     * modules.dep给出的是依赖闭包，这里去掉能经由其他依赖间接得到的模块
+     * @param name 模块名称
+     * @return 依赖模块名称，模块不存在时为空
+     */
+    std::vector<std::string> dependencies(const std::string& name);
+    
+    /**
+     * @brief 获取模块文件路径
+     * @param name 模块名称
+     * @return 绝对路径，模块不存在或为内置模块时为空
+     */
+    std::string modulePath(const std::string& name);
+    
+    /**
+     * @brief 加载模块及其依赖
+     * @param names 模块名称
+     * @param options 模块名称到模块参数（"key=value key2=value2"）
+     * @param results 输出闭包中每个模块的加载结果
+     * @return 请求的模块全部在内核中返回true
+     */
+    bool load(const std::vector<std::string>& names,
+              const std::unordered_map<std::string, std::string>& options,
+              std::vector<ModuleLoadResult>& results);
+    
+    /**
+     * @brief 卸载模块，随后卸载不再被使用的依赖模块
+     * @param name 模块名称
+     * @param removed 输出已卸载的模块
+     * @param error 失败时输出原因
+     * @return 模块本身卸载成功返回true
+     */
+    bool unload(const std::string& name, std::vector<std::string>& removed, std::string& error);
+    
+    /**
+     * @brief 规范化模块名称，"-"与"_"等价
+     * @param name 模块名称或模块文件名
+     * @return 规范化后的名称
+     */
+    static std::string normalizeName(const std::string& name);
+    
+    /**
+     * @brief 获取模块目录
+     * @return 模块目录路径
+     */
+    const std::string& moduleDirectory() const { return module_dir_; }
+
+private:
+    struct Index;
+    struct Node;
+    
+    std::shared_ptr<const Index> index();
+    void loadOne(const Index& index, Node& node);
+    
+    std::string module_dir_;
+    std::mutex mutex_;
+    std::shared_ptr<const Index> index_;
+};
+
+} // namespace CloudFlow::Kernel
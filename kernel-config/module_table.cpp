@@ -0,0 +1,266 @@
+/**
+ * @file module_table.cpp
+ * @brief 已加载模块表实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "module_table.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CloudFlow::Kernel {
+
+namespace {
+
+// uevent消息：头部"ACTION@DEVPATH"后跟若干"KEY=VALUE"，均以'\0'分隔
+bool isModuleEvent(const char* message, size_t length) {
+    for (size_t offset = std::strlen(message) + 1; offset < length;) {
+        const char* field = message + offset;
+        if (std::strcmp(field, "SUBSYSTEM=module") == 0) {
+            return true;
+        }
+        offset += std::strlen(field) + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+LoadedModuleTable::LoadedModuleTable(const std::string& proc_modules)
+    : proc_modules_(proc_modules)
+    , uevent_fd_(-1)
+    , wake_fd_(-1)
+    , monitoring_(false) {
+}
+
+LoadedModuleTable::~LoadedModuleTable() {
+    stopMonitor();
+}
+
+void LoadedModuleTable::setListener(Listener listener) {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    listener_ = std::move(listener);
+}
+
+bool LoadedModuleTable::parse(const std::string& path, std::vector<LoadedModule>& modules) {
+    // 内核未启用模块支持（CONFIG_MODULES=n）或容器中没有该文件时，视为没有已加载的模块
+    struct stat info;
+    if (stat(path.c_str(), &info) == -1 && errno == ENOENT) {
+        return true;
+    }
+    
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // 格式：name size refcount holders state address，holders为"-"或"a,b,"
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        LoadedModule module;
+        std::string refcount;
+        std::string holders;
+        if (!(fields >> module.name >> module.size >> refcount >> holders >> module.state)) {
+            continue;
+        }
+        module.refcount = refcount == "-" ? -1 : std::atoi(refcount.c_str());
+        
+        std::istringstream holder_stream(holders);
+        std::string holder;
+        while (std::getline(holder_stream, holder, ',')) {
+            if (!holder.empty() && holder != "-") {
+                module.holders.push_back(holder);
+            }
+        }
+        modules.push_back(std::move(module));
+    }
+    
+    std::sort(modules.begin(), modules.end(),
+              [](const LoadedModule& a, const LoadedModule& b) { return a.name < b.name; });
+    return true;
+}
+
+bool LoadedModuleTable::refresh() {
+    auto modules = std::make_shared<std::vector<LoadedModule>>();
+    std::unique_lock<std::mutex> refresh_lock(refresh_mutex_);
+    if (!parse(proc_modules_, *modules)) {
+        return false;
+    }
+    
+    std::shared_ptr<const std::vector<LoadedModule>> previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous = std::move(modules_);
+        modules_ = modules;
+    }
+    if (!previous) {
+        return true;
+    }
+    
+    // 两个表都按名称排序，归并比较Live状态的变化
+    auto live = [](const LoadedModule& module) { return module.state == "Live"; };
+    auto before = previous->begin();
+    auto after = modules->begin();
+    while (before != previous->end() || after != modules->end()) {
+        if (after == modules->end() || (before != previous->end() && before->name < after->name)) {
+            if (live(*before)) {
+                pending_.emplace_back(before->name, false);
+            }
+            ++before;
+        } else if (before == previous->end() || after->name < before->name) {
+            if (live(*after)) {
+                pending_.emplace_back(after->name, true);
+            }
+            ++after;
+        } else {
+            if (live(*before) != live(*after)) {
+                pending_.emplace_back(after->name, live(*after));
+            }
+            ++before;
+            ++after;
+        }
+    }
+    
+    // 在锁外通知，监听器中可以再加载模块；同一时刻只有一个线程负责通知，
+    // 其他线程（包括监听器内部触发的刷新）产生的变化由它按顺序送出
+    if (delivering_) {
+        return true;
+    }
+    delivering_ = true;
+    while (!pending_.empty()) {
+        std::deque<std::pair<std::string, bool>> changes;
+        changes.swap(pending_);
+        Listener listener = listener_;
+        refresh_lock.unlock();
+        if (listener) {
+            for (const auto& change : changes) {
+                listener(change.first, change.second);
+            }
+        }
+        refresh_lock.lock();
+    }
+    delivering_ = false;
+    return true;
+}
+
+std::shared_ptr<const std::vector<LoadedModule>> LoadedModuleTable::modules() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!modules_) {
+        // 尚未刷新过时直接读取一次，不通知监听器
+        auto modules = std::make_shared<std::vector<LoadedModule>>();
+        parse(proc_modules_, *modules);
+        modules_ = std::move(modules);
+    }
+    return modules_;
+}
+
+bool LoadedModuleTable::find(const std::string& name, LoadedModule& module) const {
+    std::shared_ptr<const std::vector<LoadedModule>> current = modules();
+    auto it = std::lower_bound(current->begin(), current->end(), name,
+                               [](const LoadedModule& entry, const std::string& key) { return entry.name < key; });
+    if (it == current->end() || it->name != name) {
+        return false;
+    }
+    module = *it;
+    return true;
+}
+
+bool LoadedModuleTable::startMonitor() {
+    if (monitoring_) {
+        return true;
+    }
+    
+    uevent_fd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (uevent_fd_ == -1) {
+        return false;
+    }
+    
+    struct sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1; // 内核直接发出的uevent
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ == -1 || bind(uevent_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        close(uevent_fd_);
+        uevent_fd_ = -1;
+        if (wake_fd_ != -1) {
+            close(wake_fd_);
+            wake_fd_ = -1;
+        }
+        return false;
+    }
+    
+    monitoring_ = true;
+    monitor_thread_ = std::thread(&LoadedModuleTable::monitorLoop, this);
+    return true;
+}
+
+void LoadedModuleTable::stopMonitor() {
+    if (!monitoring_.exchange(false)) {
+        return;
+    }
+    
+    uint64_t value = 1;
+    ssize_t written = write(wake_fd_, &value, sizeof(value));
+    (void)written;
+    if (monitor_thread_.joinable()) {
+        monitor_thread_.join();
+    }
+    close(uevent_fd_);
+    close(wake_fd_);
+    uevent_fd_ = -1;
+    wake_fd_ = -1;
+}
+
+void LoadedModuleTable::monitorLoop() {
+    char buffer[8192];
+    while (monitoring_) {
+        struct pollfd fds[2] = {{uevent_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0) {
+            break;
+        }
+        
+        // 一次取完积压的消息，批量加载时只刷新一次
+        bool changed = false;
+        for (;;) {
+            ssize_t length = recv(uevent_fd_, buffer, sizeof(buffer) - 1, 0);
+            if (length < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == ENOBUFS) {
+                    changed = true; // 接收缓冲区溢出丢失了消息，按有变化处理
+                    continue;
+                }
+                break;
+            }
+            buffer[length] = '\0';
+            if (isModuleEvent(buffer, static_cast<size_t>(length))) {
+                changed = true;
+            }
+        }
+        
+        if (changed) {
+            refresh();
+        }
+    }
+}
+
+} // namespace CloudFlow::Kernel
@@ -0,0 +1,127 @@
+/**
+ * @file module_table.h
+ * @brief 已加载模块表
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 缓存/proc/modules的解析结果，查询时不再读取和解析文件。
+ * 只在收到模块add/remove uevent或本进程加载、卸载模块后刷新；
+ * 刷新时与上一次结果比较，模块进入或离开Live状态时通知监听器，
+ * 因此其他工具（modprobe、udev等）加载的模块同样能被发现
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CloudFlow::Kernel {
+
+/**
+ * @struct LoadedModule
+ * @brief 已加载模块信息
+ */
+struct LoadedModule {
+    std::string name;                   ///< 模块名称
+    size_t size = 0;                    ///< 模块占用内存，字节
+    int refcount = 0;                   ///< 引用计数，-1表示不可卸载
+    std::vector<std::string> holders;   ///< 使用本模块的模块
+    std::string state;                  ///< Live、Loading或Unloading
+};
+
+/**
+ * @class LoadedModuleTable
+ * @brief 已加载模块表
+ *
+ * 线程安全；监听器按变化发生的顺序调用，不会并发，可以在监听器中加载或卸载模块
+ */
+class LoadedModuleTable {
+public:
+    /**
+     * @brief 模块状态变更回调
+     * @param name 模块名称
+     * @param loaded 进入Live状态为true，被卸载为false
+     */
+    using Listener = std::function<void(const std::string& name, bool loaded)>;
+    
+    /**
+     * @brief 构造函数
+     * @param proc_modules 模块列表文件
+     */
+    explicit LoadedModuleTable(const std::string& proc_modules = "/proc/modules");
+    
+    /**
+     * @brief 析构函数，停止uevent监听
+     */
+    ~LoadedModuleTable();
+    
+    LoadedModuleTable(const LoadedModuleTable&) = delete;
+    LoadedModuleTable& operator=(const LoadedModuleTable&) = delete;
+    
+    /**
+     * @brief 设置状态变更监听器
+     * @param listener 回调函数
+     */
+    void setListener(Listener listener);
+    
+    /**
+     * @brief 重新读取模块列表并通知变化
+     *
+     * 第一次读取只建立基准，不通知监听器；模块列表文件不存在时视为空表
+     * @return 读取成功返回true
+     */
+    bool refresh();
+    
+    /**
+     * @brief 开始监听模块uevent，收到事件后刷新
+     * @return 监听启动成功返回true
+     */
+    bool startMonitor();
+    
+    /**
+     * @brief 停止监听
+     */
+    void stopMonitor();
+    
+    /**
+     * @brief 获取模块表快照
+     * @return 按名称排序的模块列表
+     */
+    std::shared_ptr<const std::vector<LoadedModule>> modules() const;
+    
+    /**
+     * @brief 查询单个模块
+     * @param name 模块名称
+     * @param module 输出模块信息
+     * @return 模块已加载返回true
+     */
+    bool find(const std::string& name, LoadedModule& module) const;
+
+private:
+    static bool parse(const std::string& path, std::vector<LoadedModule>& modules);
+    void monitorLoop();
+    
+    std::string proc_modules_;
+    
+    mutable std::mutex mutex_;
+    mutable std::shared_ptr<const std::vector<LoadedModule>> modules_;
+    
+    std::mutex refresh_mutex_;              ///< 保护以下成员，刷新串行进行
+    Listener listener_;
+    std::deque<std::pair<std::string, bool>> pending_;  ///< 待通知的变化
+    bool delivering_ = false;               ///< 已有线程在通知监听器
+    
+    int uevent_fd_;
+    int wake_fd_;
+    std::atomic<bool> monitoring_;
+    std::thread monitor_thread_;
+};
+
+} // namespace CloudFlow::Kernel
@@ -0,0 +1,149 @@
+/**
+ * @file parameter_registry.cpp
+ * @brief 内核参数索引实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "parameter_registry.h"
+#include "kernel_config.h"
+#include <functional>
+
+namespace CloudFlow::Kernel {
+
+ParameterRegistry::ParameterRegistry() : parameters_(nullptr), generation_(0) {}
+
+void ParameterRegistry::rebuild(const std::vector<KernelParameter>& parameters) {
+    parameters_ = &parameters;
+    ++generation_;
+    
+    size_t capacity = 8;
+    while (capacity < parameters.size() * 2) {
+        capacity *= 2;
+    }
+    slots_.assign(capacity, Slot{0, kEmpty});
+    
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        uint64_t hash = std::hash<std::string>{}(parameters[i].name);
+        size_t slot = hash & mask;
+        while (slots_[slot].index != kEmpty &&
+               !(slots_[slot].hash == hash && parameters[slots_[slot].index].name == parameters[i].name)) {
+            slot = (slot + 1) & mask;
+        }
+        if (slots_[slot].index == kEmpty) {
+            slots_[slot] = Slot{hash, static_cast<uint32_t>(i)};
+        }
+    }
+    
+    // 把依赖和冲突的名称解析成下标
+    dependency_offsets_.assign(1, 0);
+    dependency_edges_.clear();
+    missing_dependencies_.clear();
+    conflict_offsets_.assign(1, 0);
+    conflict_edges_.clear();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        for (const auto& dependency : parameters[i].dependencies) {
+            ParameterHandle handle = find(dependency);
+            if (handle.valid()) {
+                dependency_edges_.push_back(handle.index);
+            } else {
+                missing_dependencies_.emplace_back(static_cast<uint32_t>(i), dependency);
+            }
+        }
+        for (const auto& conflict : parameters[i].conflicts) {
+            ParameterHandle handle = find(conflict);
+            if (handle.valid()) {
+                conflict_edges_.push_back(handle.index);
+            }
+        }
+        dependency_offsets_.push_back(static_cast<uint32_t>(dependency_edges_.size()));
+        conflict_offsets_.push_back(static_cast<uint32_t>(conflict_edges_.size()));
+    }
+    
+    // 迭代三色深度优先搜索检测依赖环
+    enum : uint8_t { White, Gray, Black };
+    std::vector<uint8_t> color(parameters.size(), White);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;  // 参数下标，下一条待访问的边
+    cycle_.clear();
+    for (uint32_t root = 0; root < parameters.size() && cycle_.empty(); ++root) {
+        if (color[root] != White) {
+            continue;
+        }
+        color[root] = Gray;
+        stack.emplace_back(root, dependency_offsets_[root]);
+        while (!stack.empty() && cycle_.empty()) {
+            auto& [node, edge] = stack.back();
+            if (edge == dependency_offsets_[node + 1]) {
+                color[node] = Black;
+                stack.pop_back();
+                continue;
+            }
+            uint32_t next = dependency_edges_[edge++];
+            if (color[next] == Gray) {
+                cycle_ = parameters[next].name;
+            } else if (color[next] == White) {
+                color[next] = Gray;
+                stack.emplace_back(next, dependency_offsets_[next]);
+            }
+        }
+        stack.clear();
+    }
+}
+
+ParameterHandle ParameterRegistry::find(const std::string& name) const {
+    if (parameters_ == nullptr) {
+        return ParameterHandle{};
+    }
+    
+    uint64_t hash = std::hash<std::string>{}(name);
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask; slots_[slot].index != kEmpty; slot = (slot + 1) & mask) {
+        if (slots_[slot].hash == hash && (*parameters_)[slots_[slot].index].name == name) {
+            return ParameterHandle{slots_[slot].index, generation_};
+        }
+    }
+    return ParameterHandle{};
+}
+
+bool ParameterRegistry::resolve(ParameterHandle handle, size_t& index) const {
+    if (!handle.valid() || handle.generation != generation_ || parameters_ == nullptr ||
+        handle.index >= parameters_->size()) {
+        return false;
+    }
+    index = handle.index;
+    return true;
+}
+
+bool ParameterRegistry::validate(const std::vector<KernelParameter>& parameters, std::string& error) const {
+    if (!missing_dependencies_.empty()) {
+        const auto& missing = missing_dependencies_.front();
+        error = parameters[missing.first].name + " 的依赖参数不存在: " + missing.second;
+        return false;
+    }
+    if (!cycle_.empty()) {
+        error = "参数依赖成环: " + cycle_;
+        return false;
+    }
+    
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        for (uint32_t edge = dependency_offsets_[i]; edge < dependency_offsets_[i + 1]; ++edge) {
+            const KernelParameter& dependency = parameters[dependency_edges_[edge]];
+            if (dependency.value.empty() && dependency.is_required) {
+                error = parameters[i].name + " 的必需依赖参数未设置: " + dependency.name;
+                return false;
+            }
+        }
+        for (uint32_t edge = conflict_offsets_[i]; edge < conflict_offsets_[i + 1]; ++edge) {
+            const KernelParameter& conflict = parameters[conflict_edges_[edge]];
+            if (!conflict.value.empty()) {
+                error = parameters[i].name + " 的冲突参数已设置: " + conflict.name;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace CloudFlow::Kernel
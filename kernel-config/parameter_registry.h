@@ -0,0 +1,102 @@
+/**
+ * @file parameter_registry.h
+ * @brief 内核参数索引
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 参数名到参数列表下标的开放寻址哈希索引（线性探测），以及预先解析成下标的
+ * 依赖/冲突图。参数列表整体替换后需要重建；只修改参数值时索引和图保持有效，
+ * 验证只需按图遍历一遍，不再为每条依赖在列表中查找
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CloudFlow::Kernel {
+
+struct KernelParameter;
+
+/**
+ * @struct ParameterHandle
+ * @brief 参数句柄
+ *
+ * 在参数列表被替换（如重新加载配置）之前一直有效，之后解析为无效
+ */
+struct ParameterHandle {
+    uint32_t index = UINT32_MAX;        ///< 参数列表下标
+    uint32_t generation = 0;            ///< 创建句柄时索引的版本
+    
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+/**
+ * @class ParameterRegistry
+ * @brief 内核参数索引
+ *
+ * 非线程安全，与所索引的参数列表由同一把锁（或同一线程）保护
+ */
+class ParameterRegistry {
+public:
+    ParameterRegistry();
+    
+    /**
+     * @brief 为参数列表重建索引和依赖图
+     *
+     * 名称重复时只索引第一个，与按顺序查找的结果一致
+     * @param parameters 参数列表，重建后直到下一次重建前不得增删元素
+     */
+    void rebuild(const std::vector<KernelParameter>& parameters);
+    
+    /**
+     * @brief 按名称查找参数
+     * @param name 参数名称
+     * @return 参数句柄，参数不存在时无效
+     */
+    ParameterHandle find(const std::string& name) const;
+    
+    /**
+     * @brief 把句柄解析为参数列表下标
+     * @param handle 参数句柄
+     * @param index 输出下标
+     * @return 句柄属于当前索引版本返回true
+     */
+    bool resolve(ParameterHandle handle, size_t& index) const;
+    
+    /**
+     * @brief 按依赖/冲突图验证参数
+     *
+     * 依赖参数必须存在，必需的依赖参数必须已设置，冲突参数不能已设置，依赖关系不能成环
+     * @param parameters 建立索引时的参数列表，值可以已被修改
+     * @param error 失败时输出原因
+     * @return 验证通过返回true
+     */
+    bool validate(const std::vector<KernelParameter>& parameters, std::string& error) const;
+
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+    
+    struct Slot {
+        uint64_t hash;
+        uint32_t index;                 ///< kEmpty表示空槽
+    };
+    
+    const std::vector<KernelParameter>* parameters_;
+    uint32_t generation_;
+    std::vector<Slot> slots_;           ///< 容量为2的幂，装载因子不超过1/2
+    
+    // 依赖和冲突按参数展平存放，第i个参数的边为[offsets[i], offsets[i + 1])；
+    // 指向不存在参数的冲突边不记录
+    std::vector<uint32_t> dependency_offsets_;
+    std::vector<uint32_t> dependency_edges_;
+    std::vector<std::pair<uint32_t, std::string>> missing_dependencies_;   ///< 参数下标和不存在的依赖名称
+    std::vector<uint32_t> conflict_offsets_;
+    std::vector<uint32_t> conflict_edges_;
+    std::string cycle_;                 ///< 依赖环上的一个参数，无环时为空
+};
+
+} // namespace CloudFlow::Kernel
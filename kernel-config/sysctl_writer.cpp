@@ -0,0 +1,290 @@
+/**
+ * @file sysctl_writer.cpp
+ * @brief sysctl参数读写实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "sysctl_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace CloudFlow::Kernel {
+
+namespace {
+
+// /proc/sys按空白分隔多个数值，读出的格式可能与写入时不同（制表符、多个空格）
+std::string normalizeValue(const std::string& value) {
+    std::istringstream stream(value);
+    std::string token;
+    std::string normalized;
+    while (stream >> token) {
+        if (!normalized.empty()) {
+            normalized += ' ';
+        }
+        normalized += token;
+    }
+    return normalized;
+}
+
+} // namespace
+
+struct SysctlWriter::Entry {
+    std::string key;
+    std::string value;
+    std::string name;
+    int dir_fd = -1;
+    std::string previous;       ///< 写入前的值
+    bool written = false;       ///< 已写入，失败时需要回滚
+};
+
+SysctlWriter::SysctlWriter(const std::string& root) : root_(root) {}
+
+SysctlWriter::~SysctlWriter() {
+    for (const auto& directory : directories_) {
+        close(directory.second);
+    }
+}
+
+bool SysctlWriter::resolve(const std::string& key, std::string& directory, std::string& name) const {
+    std::string path = key;
+    if (path.find('/') == std::string::npos) {
+        std::replace(path.begin(), path.end(), '.', '/');
+    }
+    
+    // 只接受/proc/sys之下的相对路径，拒绝空分量、"."和".."
+    std::vector<std::string> components;
+    std::istringstream stream(path);
+    std::string component;
+    while (std::getline(stream, component, '/')) {
+        if (component.empty() || component == "." || component == "..") {
+            return false;
+        }
+        components.push_back(component);
+    }
+    if (components.empty() || path.back() == '/') {
+        return false;
+    }
+    
+    name = components.back();
+    components.pop_back();
+    directory.clear();
+    for (const auto& part : components) {
+        if (!directory.empty()) {
+            directory += '/';
+        }
+        directory += part;
+    }
+    return true;
+}
+
+int SysctlWriter::directoryFd(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // 从已缓存的最深祖先目录开始逐级openat
+    std::string opened = directory;
+    auto cached = directories_.find(opened);
+    while (cached == directories_.end() && !opened.empty()) {
+        size_t slash = opened.rfind('/');
+        opened = slash == std::string::npos ? std::string() : opened.substr(0, slash);
+        cached = directories_.find(opened);
+    }
+    
+    int fd;
+    if (cached != directories_.end()) {
+        fd = cached->second;
+    } else {
+        fd = open(root_.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (fd == -1) {
+            return -1;
+        }
+        directories_.emplace(std::string(), fd);
+    }
+    
+    while (opened.size() < directory.size()) {
+        size_t begin = opened.empty() ? 0 : opened.size() + 1;
+        size_t end = directory.find('/', begin);
+        if (end == std::string::npos) {
+            end = directory.size();
+        }
+        
+        int child = openat(fd, directory.substr(begin, end - begin).c_str(),
+                           O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (child == -1) {
+            return -1;
+        }
+        opened = directory.substr(0, end);
+        directories_.emplace(opened, child);
+        fd = child;
+    }
+    return fd;
+}
+
+bool SysctlWriter::readAt(int dir_fd, const std::string& name, std::string& value) const {
+    int fd = openat(dir_fd, name.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    
+    value.clear();
+    char buffer[4096];
+    for (;;) {
+        ssize_t count = ::read(fd, buffer, sizeof(buffer));
+        if (count == -1 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            close(fd);
+            if (count == -1) {
+                return false;
+            }
+            break;
+        }
+        value.append(buffer, static_cast<size_t>(count));
+    }
+    
+    while (!value.empty() && value.back() == '\n') {
+        value.pop_back();
+    }
+    return true;
+}
+
+bool SysctlWriter::writeAt(int dir_fd, const std::string& name, const std::string& value, std::string& error) const {
+    int fd = openat(dir_fd, name.c_str(), O_WRONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd == -1) {
+        error = std::strerror(errno);
+        return false;
+    }
+    
+    // 内核按一次write解析整个值，不能分段写入
+    ssize_t count;
+    do {
+        count = ::write(fd, value.data(), value.size());
+    } while (count == -1 && errno == EINTR);
+    
+    if (count == -1) {
+        error = std::strerror(errno);
+    } else if (static_cast<size_t>(count) != value.size()) {
+        error = "写入不完整";
+    }
+    close(fd);
+    return error.empty();
+}
+
+bool SysctlWriter::read(const std::string& key, std::string& value) {
+    std::string directory;
+    std::string name;
+    if (!resolve(key, directory, name)) {
+        return false;
+    }
+    
+    int dir_fd = directoryFd(directory);
+    return dir_fd != -1 && readAt(dir_fd, name, value);
+}
+
+bool SysctlWriter::write(const std::string& key, const std::string& value, std::string& error) {
+    std::string directory;
+    std::string name;
+    if (!resolve(key, directory, name)) {
+        error = "无效的参数键";
+        return false;
+    }
+    
+    int dir_fd = directoryFd(directory);
+    if (dir_fd == -1) {
+        error = std::strerror(errno);
+        return false;
+    }
+    
+    error.clear();
+    return writeAt(dir_fd, name, value, error);
+}
+
+bool SysctlWriter::apply(const std::vector<std::pair<std::string, std::string>>& settings,
+                         std::vector<SysctlFailure>& failures) {
+    // 先解析全部键，有无效的键时整批不写入
+    std::vector<Entry> entries(settings.size());
+    std::map<std::string, std::vector<size_t>> groups;
+    for (size_t i = 0; i < settings.size(); ++i) {
+        Entry& entry = entries[i];
+        entry.key = settings[i].first;
+        entry.value = settings[i].second;
+        
+        std::string directory;
+        if (!resolve(entry.key, directory, entry.name)) {
+            failures.push_back(SysctlFailure{entry.key, "无效的参数键"});
+            continue;
+        }
+        entry.dir_fd = directoryFd(directory);
+        if (entry.dir_fd == -1) {
+            failures.push_back(SysctlFailure{entry.key, std::strerror(errno)});
+            continue;
+        }
+        groups[directory.substr(0, directory.find('/'))].push_back(i);
+    }
+    if (!failures.empty()) {
+        return false;
+    }
+    
+    // 每个子系统一个线程；任一线程失败后其他线程不再开始新的写入
+    std::atomic<bool> failed(false);
+    std::mutex failures_mutex;
+    auto writeGroup = [&](const std::vector<size_t>& indices) {
+        for (size_t index : indices) {
+            if (failed.load(std::memory_order_relaxed)) {
+                return;
+            }
+            
+            Entry& entry = entries[index];
+            std::string error;
+            if (!readAt(entry.dir_fd, entry.name, entry.previous)) {
+                error = std::string("读取原值失败: ") + std::strerror(errno);
+            } else if (normalizeValue(entry.previous) == normalizeValue(entry.value)) {
+                continue;
+            } else if (writeAt(entry.dir_fd, entry.name, entry.value, error)) {
+                entry.written = true;
+                continue;
+            }
+            
+            failed.store(true, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(failures_mutex);
+            failures.push_back(SysctlFailure{entry.key, error});
+            return;
+        }
+    };
+    
+    if (groups.size() == 1) {
+        writeGroup(groups.begin()->second);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(groups.size());
+        for (const auto& group : groups) {
+            threads.emplace_back(writeGroup, std::cref(group.second));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    if (!failed.load()) {
+        return true;
+    }
+    
+    for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+        std::string error;
+        if (entry->written && !writeAt(entry->dir_fd, entry->name, entry->previous, error)) {
+            failures.push_back(SysctlFailure{entry->key, "回滚失败: " + error});
+        }
+    }
+    return false;
+}
+
+} // namespace CloudFlow::Kernel
@@ -0,0 +1,96 @@
+/**
+ * @file sysctl_writer.h
+ * @brief sysctl参数读写
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 直接读写/proc/sys，不经过sysctl命令。目录描述符按路径缓存，每个键只需一次openat；
+ * 批量写入时不同子系统（net、vm、kernel等）的键并行写入，同一子系统内按给定顺序写入。
+ * 键可以用"."或"/"分隔，含"/"时按路径解释，此时名称中的"."是普通字符（如网卡名eth0.100）
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CloudFlow::Kernel {
+
+/**
+ * @struct SysctlFailure
+ * @brief 批量写入中失败的键
+ */
+struct SysctlFailure {
+    std::string key;            ///< 参数键
+    std::string error;          ///< 失败原因
+};
+
+/**
+ * @class SysctlWriter
+ * @brief sysctl参数读写器
+ *
+ * 线程安全
+ */
+class SysctlWriter {
+public:
+    /**
+     * @brief 构造函数
+     * @param root sysctl根目录
+     */
+    explicit SysctlWriter(const std::string& root = "/proc/sys");
+    
+    /**
+     * @brief 析构函数，关闭缓存的目录描述符
+     */
+    ~SysctlWriter();
+    
+    SysctlWriter(const SysctlWriter&) = delete;
+    SysctlWriter& operator=(const SysctlWriter&) = delete;
+    
+    /**
+     * @brief 读取参数当前值
+     * @param key 参数键
+     * @param value 输出参数值，去掉末尾换行
+     * @return 读取是否成功
+     */
+    bool read(const std::string& key, std::string& value);
+    
+    /**
+     * @brief 写入单个参数
+     * @param key 参数键
+     * @param value 参数值
+     * @param error 失败时输出原因
+     * @return 写入是否成功
+     */
+    bool write(const std::string& key, const std::string& value, std::string& error);
+    
+    /**
+     * @brief 批量写入参数
+     *
+     * 先读出全部原值，当前值与目标值相同的键跳过；任一键写入失败时，
+     * 把已写入的键按相反顺序恢复为原值，整批要么全部生效要么全部回滚
+     * @param settings 参数键和值
+     * @param failures 输出失败的键，包括回滚失败的键
+     * @return 全部写入成功返回true
+     */
+    bool apply(const std::vector<std::pair<std::string, std::string>>& settings,
+               std::vector<SysctlFailure>& failures);
+
+private:
+    struct Entry;
+    
+    bool resolve(const std::string& key, std::string& directory, std::string& name) const;
+    int directoryFd(const std::string& directory);
+    bool readAt(int dir_fd, const std::string& name, std::string& value) const;
+    bool writeAt(int dir_fd, const std::string& name, const std::string& value, std::string& error) const;
+    
+    std::string root_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, int> directories_;     ///< 相对路径到目录描述符，""为根目录
+};
+
+} // namespace CloudFlow::Kernel
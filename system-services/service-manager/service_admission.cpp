@@ -0,0 +1,341 @@
+/**
+ * @file service_admission.cpp
+ * @brief 服务启动准入控制实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_admission.h"
+#include "service_pressure.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+enum class JobState {
+    Pending,
+    Running,
+    Succeeded,
+    Failed
+};
+
+int64_t toMilliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+} // namespace
+
+StartAdmissionController::StartAdmissionController(const StartAdmissionPolicy& policy, DecisionLog log)
+    : policy_(policy)
+    , log_(std::move(log)) {
+}
+
+std::vector<std::chrono::milliseconds> StartAdmissionController::computeRemainingPaths(const std::vector<StartJob>& jobs) {
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        index.emplace(jobs[i].name, i);
+    }
+    
+    // 反向边：dependents[i]为依赖jobs[i]的服务
+    std::vector<std::vector<size_t>> dependents(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        for (const auto& dependency : jobs[i].dependencies) {
+            auto it = index.find(dependency);
+            if (it != index.end() && it->second != i) {
+                dependents[it->second].push_back(i);
+            }
+        }
+    }
+    
+    // 记忆化深度优先搜索，0未访问、1访问中、2已完成；循环依赖中的回边不计入路径
+    std::vector<std::chrono::milliseconds> paths(jobs.size(), std::chrono::milliseconds(0));
+    std::vector<int> marks(jobs.size(), 0);
+    std::function<void(size_t)> visit = [&](size_t i) {
+        marks[i] = 1;
+        std::chrono::milliseconds longest(0);
+        for (size_t dependent : dependents[i]) {
+            if (marks[dependent] == 0) {
+                visit(dependent);
+            }
+            if (marks[dependent] == 2) {
+                longest = std::max(longest, paths[dependent]);
+            }
+        }
+        paths[i] = jobs[i].expected + longest;
+        marks[i] = 2;
+    };
+    
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (marks[i] == 0) {
+            visit(i);
+        }
+    }
+    return paths;
+}
+
+void StartAdmissionController::sortReady(const std::vector<StartJob>& jobs,
+                                         const std::vector<std::chrono::milliseconds>& paths,
+                                         std::vector<size_t>& ready) {
+    std::sort(ready.begin(), ready.end(), [&](size_t a, size_t b) {
+        if (jobs[a].priority != jobs[b].priority) {
+            return static_cast<int>(jobs[a].priority) < static_cast<int>(jobs[b].priority);
+        }
+        if (paths[a] != paths[b]) {
+            return paths[a] > paths[b];
+        }
+        return jobs[a].name < jobs[b].name;
+    });
+}
+
+std::vector<std::chrono::milliseconds> StartAdmissionController::predictReadyTimes(const std::vector<StartJob>& jobs) const {
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        index.emplace(jobs[i].name, i);
+    }
+    std::vector<std::chrono::milliseconds> paths = computeRemainingPaths(jobs);
+    
+    size_t limit = static_cast<size_t>(budget());
+    std::vector<JobState> states(jobs.size(), JobState::Pending);
+    std::vector<std::chrono::milliseconds> ready_times(jobs.size(), std::chrono::milliseconds(0));
+    std::vector<size_t> running;
+    std::chrono::milliseconds now(0);
+    size_t remaining = jobs.size();
+    bool ignore_dependencies = false;
+    
+    while (remaining > 0) {
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (states[i] != JobState::Pending) {
+                continue;
+            }
+            
+            bool blocked = false;
+            for (const auto& dependency : jobs[i].dependencies) {
+                auto it = index.find(dependency);
+                if (it != index.end() && it->second != i && states[it->second] != JobState::Succeeded) {
+                    blocked = !ignore_dependencies;
+                }
+            }
+            if (!blocked) {
+                ready.push_back(i);
+            }
+        }
+        
+        if (ready.empty() && running.empty()) {
+            ignore_dependencies = true;
+            continue;
+        }
+        
+        sortReady(jobs, paths, ready);
+        for (size_t i : ready) {
+            if (running.size() >= limit) {
+                break;
+            }
+            states[i] = JobState::Running;
+            ready_times[i] = now + jobs[i].expected;
+            running.push_back(i);
+        }
+        
+        // 推进到最早结束的启动，同时结束的一并完成
+        auto earliest = std::min_element(running.begin(), running.end(), [&](size_t a, size_t b) {
+            return ready_times[a] < ready_times[b];
+        });
+        now = ready_times[*earliest];
+        for (auto it = running.begin(); it != running.end();) {
+            if (ready_times[*it] <= now) {
+                states[*it] = JobState::Succeeded;
+                --remaining;
+                it = running.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return ready_times;
+}
+
+int StartAdmissionController::budget() const {
+    if (policy_.max_concurrent_starts > 0) {
+        return policy_.max_concurrent_starts;
+    }
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+bool StartAdmissionController::pressureExceeded(std::string& reason) const {
+    const std::pair<PressureResource, double> gates[] = {
+        {PressureResource::Cpu, policy_.cpu_pressure_limit},
+        {PressureResource::Io, policy_.io_pressure_limit}
+    };
+    
+    for (const auto& gate : gates) {
+        if (gate.second <= 0.0) {
+            continue;
+        }
+        
+        double average = readPressureAverage(gate.first);
+        if (average >= gate.second) {
+            char buffer[96];
+            std::snprintf(buffer, sizeof(buffer), "%s压力%.2f%%超过门限%.2f%%",
+                          gate.first == PressureResource::Cpu ? "CPU" : "IO", average, gate.second);
+            reason = buffer;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StartAdmissionController::log(std::chrono::steady_clock::time_point begin, const std::string& message) const {
+    if (log_) {
+        log_("+" + std::to_string(toMilliseconds(std::chrono::steady_clock::now() - begin)) + "ms " + message);
+    }
+}
+
+bool StartAdmissionController::run(const std::vector<StartJob>& jobs, const Starter& starter) {
+    auto begin = std::chrono::steady_clock::now();
+    int limit = budget();
+    log(begin, "开始启动" + std::to_string(jobs.size()) + "个服务，并发预算" + std::to_string(limit));
+    
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        index.emplace(jobs[i].name, i);
+    }
+    std::vector<std::chrono::milliseconds> paths = computeRemainingPaths(jobs);
+    
+    std::vector<JobState> states(jobs.size(), JobState::Pending);
+    size_t remaining = jobs.size();
+    int in_flight = 0;
+    bool all_started = true;
+    bool ignore_dependencies = false;
+    std::string deferred_reason;
+    
+    std::mutex mutex;
+    std::condition_variable finished_cv;
+    std::vector<std::pair<size_t, bool>> finished;
+    std::vector<std::thread> threads;
+    
+    while (remaining > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& result : finished) {
+                states[result.first] = result.second ? JobState::Succeeded : JobState::Failed;
+                all_started = all_started && result.second;
+                --in_flight;
+                --remaining;
+                log(begin, (result.second ? "完成 " : "失败 ") + jobs[result.first].name);
+            }
+            finished.clear();
+        }
+        
+        // 收集依赖全部完成的服务，依赖失败的服务直接跳过
+        std::vector<size_t> ready;
+        bool skipped = false;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (states[i] != JobState::Pending) {
+                continue;
+            }
+            
+            bool blocked = false;
+            const std::string* failed_dependency = nullptr;
+            for (const auto& dependency : jobs[i].dependencies) {
+                auto it = index.find(dependency);
+                if (it == index.end() || it->second == i) {
+                    continue;
+                }
+                if (states[it->second] == JobState::Failed) {
+                    failed_dependency = &dependency;
+                    break;
+                }
+                if (states[it->second] != JobState::Succeeded && !ignore_dependencies) {
+                    blocked = true;
+                }
+            }
+            
+            if (failed_dependency) {
+                states[i] = JobState::Failed;
+                all_started = false;
+                --remaining;
+                skipped = true;
+                log(begin, "跳过 " + jobs[i].name + "：依赖 " + *failed_dependency + " 启动失败");
+            } else if (!blocked) {
+                ready.push_back(i);
+            }
+        }
+        
+        if (skipped) {
+            continue; // 跳过的服务可能使其他服务的依赖失败，重新收集
+        }
+        
+        if (ready.empty() && in_flight == 0) {
+            if (remaining == 0) {
+                break;
+            }
+            ignore_dependencies = true;
+            log(begin, "剩余" + std::to_string(remaining) + "个服务存在循环依赖，忽略依赖启动");
+            continue;
+        }
+        
+        sortReady(jobs, paths, ready);
+        
+        // 压力门限只在已有启动进行时生效，保证总能推进；关键服务不受压力门限限制
+        bool deferred = false;
+        for (size_t i : ready) {
+            if (in_flight >= limit) {
+                break;
+            }
+            
+            std::string reason;
+            if (in_flight > 0 && jobs[i].priority != ServicePriority::Critical && pressureExceeded(reason)) {
+                if (reason != deferred_reason) {
+                    log(begin, "暂缓启动 " + jobs[i].name + "：" + reason);
+                    deferred_reason = reason;
+                }
+                deferred = true;
+                break;
+            }
+            deferred_reason.clear();
+            
+            states[i] = JobState::Running;
+            ++in_flight;
+            log(begin, "放行 " + jobs[i].name + "：优先级" + std::to_string(static_cast<int>(jobs[i].priority)) +
+                       "，剩余关键路径" + std::to_string(paths[i].count()) + "ms，进行中" +
+                       std::to_string(in_flight) + "/" + std::to_string(limit));
+            
+            threads.emplace_back([&, i]() {
+                bool started = starter(jobs[i].name);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.emplace_back(i, started);
+                }
+                finished_cv.notify_one();
+            });
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        if (deferred) {
+            finished_cv.wait_for(lock, std::chrono::milliseconds(std::max(policy_.pressure_retry_ms, 1)),
+                                 [&finished]() { return !finished.empty(); });
+        } else {
+            finished_cv.wait(lock, [&finished]() { return !finished.empty(); });
+        }
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    log(begin, std::string("启动结束，") + (all_started ? "全部成功" : "存在失败"));
+    return all_started;
+}
+
+} // namespace System
+} // namespace CloudFlow
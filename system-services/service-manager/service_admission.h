@@ -0,0 +1,100 @@
+/**
+ * @file service_admission.h
+ * @brief 服务启动准入控制
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 批量启动服务时按依赖关系逐步放行：依赖全部启动完成的服务进入就绪集合，
+ * 在全局并发预算和压力门限内按优先级、剩余关键路径长度依次启动，
+ * 避免同时启动全部服务使磁盘和CPU饱和而拖慢整体启动
+ */
+
+#ifndef CLOUDFLOW_SERVICE_ADMISSION_H
+#define CLOUDFLOW_SERVICE_ADMISSION_H
+
+#include "service_manager.h"
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 待启动的服务
+ */
+struct StartJob {
+    std::string name;                       ///< 服务名称
+    std::vector<std::string> dependencies;  ///< 依赖服务，不在本批中的依赖视为已满足
+    ServicePriority priority;               ///< 优先级
+    std::chrono::milliseconds expected;     ///< 预计启动耗时，未知时为0
+};
+
+/**
+ * @brief 启动准入控制器
+ *
+ * 每次run()由调用线程调度，每个被放行的启动在独立线程上执行
+ */
+class StartAdmissionController {
+public:
+    /**
+     * @brief 启动函数
+     * @param name 服务名称
+     * @return 启动成功返回true
+     */
+    using Starter = std::function<bool(const std::string& name)>;
+    
+    /**
+     * @brief 决策日志函数
+     * @param decision 一条决策记录
+     */
+    using DecisionLog = std::function<void(const std::string& decision)>;
+    
+    StartAdmissionController(const StartAdmissionPolicy& policy, DecisionLog log);
+    
+    /**
+     * @brief 启动一批服务，全部结束后返回
+     *
+     * 依赖启动失败的服务不再启动；存在循环依赖时，剩余服务忽略依赖按顺序启动
+     * @param jobs 待启动的服务
+     * @param starter 启动函数
+     * @return 全部启动成功返回true
+     */
+    bool run(const std::vector<StartJob>& jobs, const Starter& starter);
+    
+    /**
+     * @brief 计算每个服务的剩余关键路径长度
+     *
+     * 即该服务的预计耗时加上依赖它的服务中最长剩余关键路径
+     * @param jobs 待启动的服务
+     * @return 与jobs对应的路径长度
+     */
+    static std::vector<std::chrono::milliseconds> computeRemainingPaths(const std::vector<StartJob>& jobs);
+    
+    /**
+     * @brief 按与run()相同的排序和并发预算模拟调度，预测各服务的就绪时刻
+     *
+     * 假定每个服务恰好耗时expected且全部成功，不考虑压力门限
+     * @param jobs 待启动的服务
+     * @return 与jobs对应的就绪时刻（相对开始）
+     */
+    std::vector<std::chrono::milliseconds> predictReadyTimes(const std::vector<StartJob>& jobs) const;
+
+private:
+    static void sortReady(const std::vector<StartJob>& jobs, const std::vector<std::chrono::milliseconds>& paths,
+                          std::vector<size_t>& ready);
+    
+    int budget() const;
+    bool pressureExceeded(std::string& reason) const;
+    void log(std::chrono::steady_clock::time_point begin, const std::string& message) const;
+    
+    StartAdmissionPolicy policy_;
+    DecisionLog log_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_ADMISSION_H
@@ -0,0 +1,409 @@
+/**
+ * @file service_bench.cpp
+ * @brief 服务管理器规模基准测试
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 为每个规模生成N个合成服务，依赖关系为随机有向无环图，服务进程是本程序以--stub参数运行的桩进程：
+ * 启动后立即通过心跳页发送第一次心跳表示就绪，之后周期性心跳，收到SIGTERM时退出。
+ * 测量项：
+ *   - startAllServices()和stopAllServices()的墙钟时间
+ *   - 故障检测延迟：SIGKILL服务主进程到服务进入Failed状态
+ *   - 重启延迟：SIGKILL到服务以新进程重新进入Running状态
+ *   - 管理器空闲CPU：全部服务运行期间管理器进程（监管线程与各服务监控线程）的CPU占用
+ *   - 管理器RSS：注册前、全部启动后
+ *
+ * 用法：service_bench [--counts 100,1000,10000] [--max-deps 3] [--failures 10]
+ *                     [--idle-seconds 5] [--watchdog 5000] [--shutdown-timeout 500] [--seed 1]
+ *
+ * 桩进程收到SIGTERM立即退出，停止超时只在桩进程不响应时才会耗尽
+ */
+
+#include "service_manager.h"
+#include "service_heartbeat.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace CloudFlow::System;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using EventClock = std::chrono::system_clock;   ///< 状态变化事件的时间戳
+
+// 桩服务：第一次心跳即表示就绪，之后每200毫秒心跳一次；
+// 阻塞在sigtimedwait中等待SIGTERM，收到后立即退出，停止和重启的测量不含桩进程的轮询延迟
+int runStub() {
+    HeartbeatClient heartbeat;
+    heartbeat.attach();
+    heartbeat.beat();
+    
+    #ifdef __linux__
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGINT);
+        sigprocmask(SIG_BLOCK, &signals, nullptr);
+        
+        const timespec period{0, 200 * 1000 * 1000};
+        for (;;) {
+            int received = sigtimedwait(&signals, nullptr, &period);
+            if (received == SIGTERM || received == SIGINT) {
+                break;
+            }
+            heartbeat.beat();
+        }
+    #endif
+    return 0;
+}
+
+struct BenchOptions {
+    std::vector<size_t> counts = {100, 1000, 10000};
+    int max_deps = 3;
+    int failures = 10;
+    int idle_seconds = 5;
+    int watchdog_ms = 5000;
+    int shutdown_timeout_ms = 500;
+    unsigned seed = 1;
+};
+
+struct BenchResult {
+    size_t services = 0;
+    size_t running = 0;
+    double start_ms = 0;
+    double stop_ms = 0;
+    std::vector<double> detect_ms;
+    std::vector<double> restart_ms;
+    int lost_failures = 0;
+    double idle_cpu_percent = 0;
+    double start_cpu_ms = 0;
+    double baseline_rss_mb = 0;
+    double running_rss_mb = 0;
+};
+
+// 等待指定服务的下一次失败和恢复，时刻取事件中记录的状态变化时刻，不含投递延迟
+class FailureWatcher {
+public:
+    void arm(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        victim_ = name;
+        failed_ = false;
+        recovered_ = false;
+    }
+    
+    void onTransition(const StatusChangeEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (event.service != victim_) {
+            return;
+        }
+        if (event.new_state == ServiceState::Failed && !failed_) {
+            failed_ = true;
+            failed_at_ = event.timestamp;
+        } else if (event.new_state == ServiceState::Running && failed_ && !recovered_) {
+            recovered_ = true;
+            recovered_at_ = event.timestamp;
+        }
+        cv_.notify_all();
+    }
+    
+    bool wait(std::chrono::milliseconds timeout, EventClock::time_point& failed_at, EventClock::time_point& recovered_at) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool done = cv_.wait_for(lock, timeout, [this]() { return recovered_; });
+        failed_at = failed_at_;
+        recovered_at = recovered_at_;
+        victim_.clear();
+        return done;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string victim_;
+    bool failed_ = false;
+    bool recovered_ = false;
+    EventClock::time_point failed_at_;
+    EventClock::time_point recovered_at_;
+};
+
+template <typename TimePoint>
+double elapsedMs(TimePoint from, TimePoint to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+double processCpuMs() {
+    #ifdef __linux__
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+        auto toMs = [](const timeval& tv) { return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0; };
+        return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+    #else
+        return 0;
+    #endif
+}
+
+double residentMb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::strtod(line.c_str() + 6, nullptr) / 1024.0;
+        }
+    }
+    return 0;
+}
+
+std::string selfPath() {
+    #ifdef __linux__
+        char path[4096];
+        ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if (length > 0) {
+            return std::string(path, static_cast<size_t>(length));
+        }
+    #endif
+    return std::string();
+}
+
+// 每个服务、每个描述符（pidfd、心跳页、输出管道）都占用文件描述符，万级规模需要调高软限制
+void raiseFileLimit() {
+    #ifdef __linux__
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    #endif
+}
+
+// 服务i只依赖编号更小的服务，保证无环
+std::vector<ServiceConfig> generateServices(size_t count, const BenchOptions& options, const std::string& stub) {
+    std::mt19937 rng(options.seed + static_cast<unsigned>(count));
+    std::vector<ServiceConfig> configs;
+    configs.reserve(count);
+    
+    for (size_t i = 0; i < count; ++i) {
+        ServiceConfig config{};
+        char name[32];
+        std::snprintf(name, sizeof(name), "bench-%05zu", i);
+        config.name = name;
+        config.type = ServiceType::Application;
+        config.priority = ServicePriority::Normal;
+        config.executable_path = stub;
+        config.args = {"--stub"};
+        config.auto_start = true;
+        config.restart_delay = 0;
+        config.max_restart_attempts = 1000;
+        config.shutdown_timeout = options.shutdown_timeout_ms;
+        config.watchdog_timeout = options.watchdog_ms;
+        config.log.capture_output = false;
+        
+        if (i > 0 && options.max_deps > 0) {
+            int deps = std::uniform_int_distribution<int>(0, options.max_deps)(rng);
+            std::uniform_int_distribution<size_t> pick(0, i - 1);
+            for (int d = 0; d < deps; ++d) {
+                const std::string& dependency = configs[pick(rng)].name;
+                if (std::find(config.dependencies.begin(), config.dependencies.end(), dependency) == config.dependencies.end()) {
+                    config.dependencies.push_back(dependency);
+                }
+            }
+        }
+        configs.push_back(std::move(config));
+    }
+    return configs;
+}
+
+size_t countRunning(const ServiceManager& manager) {
+    auto snapshot = manager.getSnapshot();
+    return static_cast<size_t>(std::count_if(snapshot->services.begin(), snapshot->services.end(),
+        [](const ServiceSnapshot::Entry& entry) { return entry.status.state == ServiceState::Running; }));
+}
+
+bool runScale(size_t count, const BenchOptions& options, const std::string& stub, BenchResult& result) {
+    result = BenchResult();
+    result.services = count;
+    
+    // 订阅回调引用watcher，须在管理器之后销毁
+    FailureWatcher watcher;
+    
+    // 不加载也不改写系统的服务配置文件
+    ServiceManager manager;
+    manager.setConfigFile("");
+    if (!manager.initialize()) {
+        std::fprintf(stderr, "服务管理器初始化失败\n");
+        return false;
+    }
+    
+    StatusSubscriptionFilter filter;
+    filter.states = {ServiceState::Failed, ServiceState::Running};
+    manager.subscribeStatusChanges([&watcher](const StatusChangeEvent& event) { watcher.onTransition(event); }, filter);
+    
+    result.baseline_rss_mb = residentMb();
+    std::vector<ServiceConfig> configs = generateServices(count, options, stub);
+    for (const auto& config : configs) {
+        if (!manager.registerService(config)) {
+            std::fprintf(stderr, "注册服务失败: %s\n", config.name.c_str());
+            return false;
+        }
+    }
+    
+    double cpu_before = processCpuMs();
+    auto start_begin = Clock::now();
+    manager.startAllServices();
+    result.start_ms = elapsedMs(start_begin, Clock::now());
+    result.start_cpu_ms = processCpuMs() - cpu_before;
+    result.running = countRunning(manager);
+    result.running_rss_mb = residentMb();
+    
+    // 空闲窗口内管理器没有任何请求，CPU全部来自监管和监控
+    double idle_cpu_before = processCpuMs();
+    auto idle_begin = Clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(options.idle_seconds));
+    double idle_wall = elapsedMs(idle_begin, Clock::now());
+    result.idle_cpu_percent = idle_wall > 0 ? (processCpuMs() - idle_cpu_before) * 100.0 / idle_wall : 0;
+    
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    for (int i = 0; i < options.failures; ++i) {
+        const std::string& name = configs[pick(rng)].name;
+        ServiceStatus status = manager.getServiceStatus(name);
+        if (status.state != ServiceState::Running || status.pid <= 0) {
+            ++result.lost_failures;
+            continue;
+        }
+        
+        watcher.arm(name);
+        auto killed_at = EventClock::now();
+        kill(status.pid, SIGKILL);
+        
+        EventClock::time_point failed_at;
+        EventClock::time_point recovered_at;
+        if (!watcher.wait(std::chrono::seconds(30), failed_at, recovered_at)) {
+            ++result.lost_failures;
+            continue;
+        }
+        result.detect_ms.push_back(elapsedMs(killed_at, failed_at));
+        result.restart_ms.push_back(elapsedMs(killed_at, recovered_at));
+    }
+    
+    auto stop_begin = Clock::now();
+    manager.stopAllServices();
+    result.stop_ms = elapsedMs(stop_begin, Clock::now());
+    return true;
+}
+
+void printResult(const BenchResult& result) {
+    std::printf("%8zu %8zu %10.1f %10.1f %10.1f %8.1f/%-8.1f %8.1f/%-8.1f %6d %8.2f %8.1f/%-8.1f\n",
+                result.services, result.running, result.start_ms, result.start_cpu_ms, result.stop_ms,
+                percentile(result.detect_ms, 0.5), percentile(result.detect_ms, 1.0),
+                percentile(result.restart_ms, 0.5), percentile(result.restart_ms, 1.0),
+                result.lost_failures, result.idle_cpu_percent,
+                result.baseline_rss_mb, result.running_rss_mb);
+    std::fflush(stdout);
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--counts") {
+            options.counts.clear();
+            std::stringstream stream(value);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                size_t count = std::strtoul(item.c_str(), nullptr, 10);
+                if (count == 0) {
+                    return false;
+                }
+                options.counts.push_back(count);
+            }
+        } else if (arg == "--max-deps") {
+            options.max_deps = std::atoi(value.c_str());
+        } else if (arg == "--failures") {
+            options.failures = std::atoi(value.c_str());
+        } else if (arg == "--idle-seconds") {
+            options.idle_seconds = std::atoi(value.c_str());
+        } else if (arg == "--watchdog") {
+            options.watchdog_ms = std::atoi(value.c_str());
+        } else if (arg == "--shutdown-timeout") {
+            options.shutdown_timeout_ms = std::atoi(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return !options.counts.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--stub") == 0) {
+        return runStub();
+    }
+    
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "用法: %s [--counts 100,1000,10000] [--max-deps 3] [--failures 10] "
+                             "[--idle-seconds 5] [--watchdog 5000] [--shutdown-timeout 500] [--seed 1]\n", argv[0]);
+        return 2;
+    }
+    
+    std::string stub = selfPath();
+    if (stub.empty()) {
+        std::fprintf(stderr, "无法确定桩服务路径\n");
+        return 1;
+    }
+    raiseFileLimit();
+    
+    // 时间单位为毫秒；故障检测和重启为中位数/最大值；RSS为注册前/全部启动后（MiB）
+    std::printf("%8s %8s %10s %10s %10s %17s %17s %6s %8s %17s\n",
+                "services", "running", "start_ms", "start_cpu", "stop_ms",
+                "detect_p50/max", "restart_p50/max", "lost", "idle_cpu%", "rss_mb");
+    
+    int status = 0;
+    for (size_t count : options.counts) {
+        BenchResult result;
+        if (!runScale(count, options, stub, result)) {
+            status = 1;
+            continue;
+        }
+        printResult(result);
+        if (result.running != result.services || result.lost_failures > 0) {
+            status = 1;
+        }
+    }
+    return status;
+}
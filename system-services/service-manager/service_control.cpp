@@ -0,0 +1,499 @@
+/**
+ * @file service_control.cpp
+ * @brief 服务控制协议与客户端实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_control.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+// 客户端等待单个应答的最长时间，服务启停可能等待服务超时
+constexpr int kResponseTimeoutMs = 60000;
+
+void putU8(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xff));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+bool putString(std::string& out, const std::string& value) {
+    if (value.size() > 0xffff) {
+        return false;
+    }
+    putU16(out, static_cast<uint16_t>(value.size()));
+    out += value;
+    return true;
+}
+
+/**
+ * @brief 小端负载读取器，越界后所有读取返回0并置失败标志
+ */
+class PayloadReader {
+public:
+    explicit PayloadReader(const std::string& payload, size_t offset = 0)
+        : data_(payload)
+        , offset_(offset)
+        , ok_(true) {
+    }
+    
+    uint8_t u8() {
+        if (!require(1)) {
+            return 0;
+        }
+        return static_cast<uint8_t>(data_[offset_++]);
+    }
+    
+    uint16_t u16() {
+        if (!require(2)) {
+            return 0;
+        }
+        uint16_t value = static_cast<uint8_t>(data_[offset_]) |
+                         static_cast<uint16_t>(static_cast<uint8_t>(data_[offset_ + 1])) << 8;
+        offset_ += 2;
+        return value;
+    }
+    
+    uint32_t u32() {
+        if (!require(4)) {
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[offset_ + i])) << (i * 8);
+        }
+        offset_ += 4;
+        return value;
+    }
+    
+    std::string string() {
+        uint16_t length = u16();
+        if (!require(length)) {
+            return std::string();
+        }
+        std::string value = data_.substr(offset_, length);
+        offset_ += length;
+        return value;
+    }
+    
+    bool ok() const {
+        return ok_;
+    }
+    
+    bool finished() const {
+        return ok_ && offset_ == data_.size();
+    }
+
+private:
+    bool require(size_t count) {
+        if (!ok_ || data_.size() - offset_ < count) {
+            ok_ = false;
+        }
+        return ok_;
+    }
+    
+    const std::string& data_;
+    size_t offset_;
+    bool ok_;
+};
+
+bool validState(uint8_t state) {
+    return state <= static_cast<uint8_t>(ServiceState::Unknown);
+}
+
+} // namespace
+
+namespace ControlProtocol {
+
+std::string encodeFrame(uint16_t type, uint32_t request_id, const std::string& payload) {
+    std::string frame;
+    frame.reserve(kHeaderSize + payload.size());
+    putU32(frame, static_cast<uint32_t>(payload.size()));
+    putU16(frame, type);
+    putU16(frame, 0);
+    putU32(frame, request_id);
+    frame += payload;
+    return frame;
+}
+
+std::string encodeCommands(const std::vector<ControlCommand>& commands) {
+    std::string payload;
+    putU16(payload, static_cast<uint16_t>(commands.size()));
+    for (const auto& command : commands) {
+        putU8(payload, static_cast<uint8_t>(command.operation));
+        putString(payload, command.service_name);
+    }
+    return payload;
+}
+
+std::string encodeResults(const std::vector<ControlResult>& results) {
+    std::string payload;
+    payload.reserve(2 + results.size() * 10);
+    putU16(payload, static_cast<uint16_t>(results.size()));
+    for (const auto& result : results) {
+        putU8(payload, static_cast<uint8_t>(result.error));
+        putU8(payload, static_cast<uint8_t>(result.state));
+        putU32(payload, static_cast<uint32_t>(result.pid));
+        putU32(payload, result.restart_count);
+    }
+    return payload;
+}
+
+std::string encodeNames(const std::vector<std::string>& names) {
+    std::string payload;
+    putU16(payload, static_cast<uint16_t>(names.size()));
+    for (const auto& name : names) {
+        putString(payload, name);
+    }
+    return payload;
+}
+
+std::string encodeEvent(const ControlEvent& event) {
+    std::string payload;
+    putU8(payload, static_cast<uint8_t>(event.old_state));
+    putU8(payload, static_cast<uint8_t>(event.new_state));
+    putString(payload, event.service_name);
+    return payload;
+}
+
+int takeFrame(std::string& buffer, Frame& frame) {
+    size_t offset = 0;
+    int taken = takeFrameAt(buffer, offset, frame);
+    if (taken == 1) {
+        buffer.erase(0, offset);
+    }
+    return taken;
+}
+
+int takeFrameAt(const std::string& buffer, size_t& offset, Frame& frame) {
+    if (buffer.size() - offset < kHeaderSize) {
+        return 0;
+    }
+    
+    PayloadReader header(buffer, offset);
+    uint32_t length = header.u32();
+    frame.type = header.u16();
+    header.u16();
+    frame.request_id = header.u32();
+    
+    if (length > kMaxPayloadSize) {
+        return -1;
+    }
+    if (buffer.size() - offset < kHeaderSize + length) {
+        return 0;
+    }
+    
+    frame.payload.assign(buffer, offset + kHeaderSize, length);
+    offset += kHeaderSize + length;
+    return 1;
+}
+
+bool decodeCommands(const std::string& payload, std::vector<ControlCommand>& commands) {
+    PayloadReader reader(payload);
+    uint16_t count = reader.u16();
+    commands.clear();
+    commands.reserve(count);
+    for (uint16_t i = 0; i < count && reader.ok(); ++i) {
+        ControlCommand command;
+        command.operation = static_cast<ControlOperation>(reader.u8());
+        command.service_name = reader.string();
+        commands.push_back(std::move(command));
+    }
+    return reader.finished();
+}
+
+bool decodeResults(const std::string& payload, std::vector<ControlResult>& results) {
+    PayloadReader reader(payload);
+    uint16_t count = reader.u16();
+    results.clear();
+    results.reserve(count);
+    for (uint16_t i = 0; i < count && reader.ok(); ++i) {
+        ControlResult result;
+        result.error = static_cast<ControlError>(reader.u8());
+        uint8_t state = reader.u8();
+        result.state = validState(state) ? static_cast<ServiceState>(state) : ServiceState::Unknown;
+        result.pid = static_cast<int>(reader.u32());
+        result.restart_count = reader.u32();
+        results.push_back(result);
+    }
+    return reader.finished();
+}
+
+bool decodeNames(const std::string& payload, std::vector<std::string>& names) {
+    PayloadReader reader(payload);
+    uint16_t count = reader.u16();
+    names.clear();
+    names.reserve(count);
+    for (uint16_t i = 0; i < count && reader.ok(); ++i) {
+        names.push_back(reader.string());
+    }
+    return reader.finished();
+}
+
+bool decodeEvent(const std::string& payload, ControlEvent& event) {
+    PayloadReader reader(payload);
+    uint8_t old_state = reader.u8();
+    uint8_t new_state = reader.u8();
+    event.service_name = reader.string();
+    if (!reader.finished() || !validState(old_state) || !validState(new_state)) {
+        return false;
+    }
+    event.old_state = static_cast<ServiceState>(old_state);
+    event.new_state = static_cast<ServiceState>(new_state);
+    return true;
+}
+
+} // namespace ControlProtocol
+
+ServiceControlClient::ServiceControlClient()
+    : fd_(-1)
+    , next_request_id_(1) {
+}
+
+ServiceControlClient::~ServiceControlClient() {
+    disconnect();
+}
+
+bool ServiceControlClient::isConnected() const {
+    return fd_ != -1;
+}
+
+bool ServiceControlClient::queryStatus(const std::vector<std::string>& service_names,
+                                       std::vector<ControlResult>& results) {
+    std::vector<ControlCommand> commands;
+    commands.reserve(service_names.size());
+    for (const auto& name : service_names) {
+        commands.push_back(ControlCommand{ControlOperation::Status, name});
+    }
+    return execute(commands, results);
+}
+
+bool ServiceControlClient::execute(const std::vector<ControlCommand>& commands,
+                                   std::vector<ControlResult>& results) {
+    if (commands.size() > 0xffff) {
+        return false;
+    }
+    
+    uint32_t request_id = 0;
+    ControlProtocol::Frame frame;
+    if (!sendFrame(ControlProtocol::Batch, ControlProtocol::encodeCommands(commands), request_id) ||
+        !waitFrame(ControlProtocol::Result, request_id, frame)) {
+        return false;
+    }
+    
+    return ControlProtocol::decodeResults(frame.payload, results) && results.size() == commands.size();
+}
+
+bool ServiceControlClient::subscribe(const std::vector<std::string>& service_names) {
+    uint32_t request_id = 0;
+    ControlProtocol::Frame frame;
+    return service_names.size() <= 0xffff &&
+           sendFrame(ControlProtocol::Subscribe, ControlProtocol::encodeNames(service_names), request_id) &&
+           waitFrame(ControlProtocol::Ack, request_id, frame) &&
+           frame.payload.size() == 1 && frame.payload[0] == static_cast<char>(ControlError::None);
+}
+
+bool ServiceControlClient::unsubscribe() {
+    uint32_t request_id = 0;
+    ControlProtocol::Frame frame;
+    return sendFrame(ControlProtocol::Unsubscribe, std::string(), request_id) &&
+           waitFrame(ControlProtocol::Ack, request_id, frame);
+}
+
+bool ServiceControlClient::readEvent(ControlEvent& event, int timeout_ms) {
+    if (!pending_events_.empty()) {
+        event = std::move(pending_events_.front());
+        pending_events_.pop_front();
+        return true;
+    }
+    
+    ControlProtocol::Frame frame;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+        int remaining = -1;
+        if (timeout_ms >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            remaining = static_cast<int>(std::max<long long>(left, 0));
+        }
+        
+        if (!receiveFrame(frame, remaining)) {
+            return false;
+        }
+        if (frame.type == ControlProtocol::Event && ControlProtocol::decodeEvent(frame.payload, event)) {
+            return true;
+        }
+    }
+}
+
+bool ServiceControlClient::waitFrame(uint16_t type, uint32_t request_id, ControlProtocol::Frame& frame) {
+    for (;;) {
+        if (!receiveFrame(frame, kResponseTimeoutMs)) {
+            disconnect(); // 应答丢失后请求ID无法再对齐
+            return false;
+        }
+        
+        if (frame.type == ControlProtocol::Event) {
+            ControlEvent event;
+            if (ControlProtocol::decodeEvent(frame.payload, event)) {
+                pending_events_.push_back(std::move(event));
+            }
+            continue;
+        }
+        
+        if (frame.type == type && frame.request_id == request_id) {
+            return true;
+        }
+    }
+}
+
+#ifdef __linux__
+
+bool ServiceControlClient::connect(const std::string& socket_path) {
+    disconnect();
+    
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return false;
+    }
+    
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return false;
+    }
+    
+    fd_ = fd;
+    return true;
+}
+
+void ServiceControlClient::disconnect() {
+    if (fd_ != -1) {
+        close(fd_);
+        fd_ = -1;
+    }
+    buffer_.clear();
+    pending_events_.clear();
+}
+
+bool ServiceControlClient::sendFrame(uint16_t type, const std::string& payload, uint32_t& request_id) {
+    if (fd_ == -1 || payload.size() > ControlProtocol::kMaxPayloadSize) {
+        return false;
+    }
+    
+    request_id = next_request_id_++;
+    std::string frame = ControlProtocol::encodeFrame(type, request_id, payload);
+    
+    size_t written = 0;
+    while (written < frame.size()) {
+        ssize_t count = send(fd_, frame.data() + written, frame.size() - written, MSG_NOSIGNAL);
+        if (count > 0) {
+            written += count;
+        } else if (count == -1 && errno == EINTR) {
+            continue;
+        } else {
+            disconnect();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ServiceControlClient::receiveFrame(ControlProtocol::Frame& frame, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    
+    while (fd_ != -1) {
+        int taken = ControlProtocol::takeFrame(buffer_, frame);
+        if (taken == 1) {
+            return true;
+        }
+        if (taken == -1) {
+            disconnect();
+            return false;
+        }
+        
+        int wait = -1;
+        if (timeout_ms >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            wait = static_cast<int>(std::max<long long>(left, 0));
+        }
+        
+        pollfd descriptor{fd_, POLLIN, 0};
+        int ready = poll(&descriptor, 1, wait);
+        if (ready == -1 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return false; // 超时，连接保持可用
+        }
+        
+        char chunk[16384];
+        ssize_t count = recv(fd_, chunk, sizeof(chunk), 0);
+        if (count > 0) {
+            buffer_.append(chunk, count);
+        } else if (count == -1 && errno == EINTR) {
+            continue;
+        } else {
+            disconnect();
+            return false;
+        }
+    }
+    return false;
+}
+
+#else
+
+bool ServiceControlClient::connect(const std::string&) {
+    return false; // 当前平台不支持
+}
+
+void ServiceControlClient::disconnect() {
+    fd_ = -1;
+    buffer_.clear();
+    pending_events_.clear();
+}
+
+bool ServiceControlClient::sendFrame(uint16_t, const std::string&, uint32_t&) {
+    return false;
+}
+
+bool ServiceControlClient::receiveFrame(ControlProtocol::Frame&, int) {
+    return false;
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,224 @@
+/**
+ * @file service_control.h
+ * @brief 服务控制协议与客户端
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 定义服务管理器unix socket控制接口的二进制协议，并提供同步客户端。
+ * 一个请求帧可携带多条命令，在一次往返中完成对多个服务的启动、停止和状态查询；
+ * 订阅后服务器会主动推送状态变化事件。
+ */
+
+#ifndef CLOUDFLOW_SERVICE_CONTROL_H
+#define CLOUDFLOW_SERVICE_CONTROL_H
+
+#include "service_manager.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 控制命令类型
+ */
+enum class ControlOperation : uint8_t {
+    Start = 1,      ///< 启动服务
+    Stop = 2,       ///< 停止服务
+    Restart = 3,    ///< 重启服务
+    Status = 4      ///< 查询状态
+};
+
+/**
+ * @brief 控制命令结果码
+ */
+enum class ControlError : uint8_t {
+    None = 0,               ///< 成功
+    NotFound = 1,           ///< 服务不存在
+    Failed = 2,             ///< 操作失败
+    PermissionDenied = 3,   ///< 权限不足
+    BadRequest = 4          ///< 请求格式错误
+};
+
+/**
+ * @brief 控制命令
+ */
+struct ControlCommand {
+    ControlOperation operation;     ///< 命令类型
+    std::string service_name;       ///< 服务名称
+};
+
+/**
+ * @brief 控制命令结果
+ */
+struct ControlResult {
+    ControlError error;             ///< 结果码
+    ServiceState state;             ///< 执行后的服务状态
+    int pid;                        ///< 进程ID
+    uint32_t restart_count;         ///< 启动次数
+};
+
+/**
+ * @brief 状态变化事件
+ */
+struct ControlEvent {
+    std::string service_name;       ///< 服务名称
+    ServiceState old_state;         ///< 原状态
+    ServiceState new_state;         ///< 新状态
+};
+
+/**
+ * @brief 控制协议编码
+ *
+ * 帧格式（小端）：u32负载长度 | u16帧类型 | u16保留 | u32请求ID | 负载
+ * - Batch负载：u16命令数，每条命令为u8类型、u16名称长度、名称
+ * - Result负载：u16结果数，每条结果为u8结果码、u8状态、i32进程ID、u32启动次数
+ * - Subscribe负载：u16名称数，每个名称为u16长度加内容；名称数为0表示订阅全部
+ * - Event负载：u8原状态、u8新状态、u16名称长度、名称；请求ID为0
+ * - Ack负载：u8结果码
+ */
+namespace ControlProtocol {
+
+constexpr size_t kHeaderSize = 12;
+constexpr size_t kMaxPayloadSize = 1024 * 1024;
+
+/**
+ * @brief 帧类型
+ */
+enum FrameType : uint16_t {
+    Batch = 1,          ///< 客户端：批量命令
+    Result = 2,         ///< 服务器：批量结果
+    Subscribe = 3,      ///< 客户端：订阅状态变化
+    Unsubscribe = 4,    ///< 客户端：取消订阅
+    Event = 5,          ///< 服务器：状态变化事件
+    Ack = 6             ///< 服务器：订阅确认
+};
+
+/**
+ * @brief 解码后的帧
+ */
+struct Frame {
+    uint16_t type;
+    uint32_t request_id;
+    std::string payload;
+};
+
+std::string encodeFrame(uint16_t type, uint32_t request_id, const std::string& payload);
+std::string encodeCommands(const std::vector<ControlCommand>& commands);
+std::string encodeResults(const std::vector<ControlResult>& results);
+std::string encodeNames(const std::vector<std::string>& names);
+std::string encodeEvent(const ControlEvent& event);
+
+/**
+ * @brief 从缓冲区头部取出一个完整帧
+ * @param buffer 接收缓冲区，成功时移除已取出的字节
+ * @param frame 输出帧
+ * @return 取出完整帧返回1，数据不足返回0，帧非法返回-1
+ */
+int takeFrame(std::string& buffer, Frame& frame);
+
+/**
+ * @brief 从缓冲区的指定位置取出一个完整帧，不修改缓冲区
+ *
+ * 连续解析多个帧后由调用方一次移除已取出的字节
+ * @param buffer 接收缓冲区
+ * @param offset 帧的起始位置，成功时前移到下一帧
+ * @param frame 输出帧
+ * @return 同takeFrame()
+ */
+int takeFrameAt(const std::string& buffer, size_t& offset, Frame& frame);
+
+bool decodeCommands(const std::string& payload, std::vector<ControlCommand>& commands);
+bool decodeResults(const std::string& payload, std::vector<ControlResult>& results);
+bool decodeNames(const std::string& payload, std::vector<std::string>& names);
+bool decodeEvent(const std::string& payload, ControlEvent& event);
+
+} // namespace ControlProtocol
+
+/**
+ * @brief 服务控制客户端
+ *
+ * 同步阻塞实现，不是线程安全的。订阅后在等待命令结果期间收到的事件会被缓存，
+ * 之后由readEvent()按顺序返回。
+ */
+class ServiceControlClient {
+public:
+    ServiceControlClient();
+    ~ServiceControlClient();
+    
+    ServiceControlClient(const ServiceControlClient&) = delete;
+    ServiceControlClient& operator=(const ServiceControlClient&) = delete;
+    
+    /**
+     * @brief 连接控制套接字
+     * @param socket_path 套接字路径
+     * @return 成功返回true
+     */
+    bool connect(const std::string& socket_path);
+    
+    /**
+     * @brief 断开连接
+     */
+    void disconnect();
+    
+    /**
+     * @brief 检查是否已连接
+     * @return 已连接返回true
+     */
+    bool isConnected() const;
+    
+    /**
+     * @brief 在一次往返中执行多条命令
+     * @param commands 命令列表
+     * @param results 输出结果，与命令一一对应
+     * @return 通信成功返回true（单条命令的失败见结果码）
+     */
+    bool execute(const std::vector<ControlCommand>& commands, std::vector<ControlResult>& results);
+    
+    /**
+     * @brief 批量查询服务状态
+     * @param service_names 服务名称列表
+     * @param results 输出结果
+     * @return 通信成功返回true
+     */
+    bool queryStatus(const std::vector<std::string>& service_names, std::vector<ControlResult>& results);
+    
+    /**
+     * @brief 订阅状态变化
+     * @param service_names 关注的服务，为空表示全部
+     * @return 成功返回true
+     */
+    bool subscribe(const std::vector<std::string>& service_names = {});
+    
+    /**
+     * @brief 取消订阅
+     * @return 成功返回true
+     */
+    bool unsubscribe();
+    
+    /**
+     * @brief 读取一个状态变化事件
+     * @param event 输出事件
+     * @param timeout_ms 超时时间（毫秒），负数表示一直等待
+     * @return 读到事件返回true
+     */
+    bool readEvent(ControlEvent& event, int timeout_ms = -1);
+
+private:
+    bool sendFrame(uint16_t type, const std::string& payload, uint32_t& request_id);
+    bool waitFrame(uint16_t type, uint32_t request_id, ControlProtocol::Frame& frame);
+    bool receiveFrame(ControlProtocol::Frame& frame, int timeout_ms);
+    
+    int fd_;
+    uint32_t next_request_id_;
+    std::string buffer_;
+    std::deque<ControlEvent> pending_events_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_CONTROL_H
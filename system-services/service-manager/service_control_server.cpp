@@ -0,0 +1,447 @@
+/**
+ * @file service_control_server.cpp
+ * @brief 服务控制接口服务端实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_control_server.h"
+#include "service_supervisor.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+// 单个连接未发出数据的上限，订阅者消费过慢时断开连接而不是无限堆积
+constexpr size_t kMaxPendingOutput = 4 * 1024 * 1024;
+
+bool isMutating(ControlOperation operation) {
+    return operation != ControlOperation::Status;
+}
+
+} // namespace
+
+struct ServiceControlServer::Connection {
+    int fd;
+    uint64_t watch_id;
+    uint32_t uid;
+    int pid;
+    bool admin;
+    std::string input;                          ///< 只在事件循环线程访问
+    
+    std::mutex output_mutex;                    ///< 保护以下字段
+    std::string output;
+    size_t written;
+    bool closed;
+    bool want_write;                            ///< 是否已关注可写事件
+    bool in_handler;                            ///< 事件循环正在处理该连接，返回前会直接发送
+    bool subscribed;
+    std::unordered_set<std::string> filter;     ///< 为空表示订阅全部服务
+};
+
+ServiceControlServer::ServiceControlServer(ServiceSupervisor& supervisor, CommandHandler handler)
+    : supervisor_(supervisor)
+    , handler_(std::move(handler))
+    , listen_watch_(0)
+    , worker_running_(false) {
+}
+
+ServiceControlServer::~ServiceControlServer() {
+    stop();
+}
+
+void ServiceControlServer::publish(const ControlEvent& event) {
+    std::vector<std::shared_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (connections_.empty()) {
+            return;
+        }
+        connections.reserve(connections_.size());
+        for (const auto& pair : connections_) {
+            connections.push_back(pair.second);
+        }
+    }
+    
+    std::string frame;
+    for (const auto& connection : connections) {
+        std::lock_guard<std::mutex> lock(connection->output_mutex);
+        if (!connection->subscribed ||
+            (!connection->filter.empty() && connection->filter.count(event.service_name) == 0)) {
+            continue;
+        }
+        if (frame.empty()) {
+            frame = ControlProtocol::encodeFrame(ControlProtocol::Event, 0, ControlProtocol::encodeEvent(event));
+        }
+        queueOutputLocked(*connection, frame);
+    }
+}
+
+void ServiceControlServer::enqueueOutput(Connection& connection, const std::string& data) {
+    std::lock_guard<std::mutex> lock(connection.output_mutex);
+    queueOutputLocked(connection, data);
+}
+
+std::vector<ControlResult> ServiceControlServer::executeBatch(const Connection& connection,
+                                                              const std::vector<ControlCommand>& commands) {
+    std::vector<ControlResult> results;
+    results.reserve(commands.size());
+    
+    for (const auto& command : commands) {
+        ControlResult result{ControlError::None, ServiceState::Unknown, 0, 0};
+        bool allowed = isMutating(command.operation) ? connection.admin
+                                                     : connection.admin || policy_.allow_unprivileged_status;
+        
+        if (command.operation < ControlOperation::Start || command.operation > ControlOperation::Status) {
+            result.error = ControlError::BadRequest;
+        } else if (!allowed) {
+            result.error = ControlError::PermissionDenied;
+        } else {
+            result = handler_(command);
+        }
+        results.push_back(result);
+    }
+    
+    return results;
+}
+
+void ServiceControlServer::workerLoop() {
+    std::unique_lock<std::mutex> lock(job_mutex_);
+    for (;;) {
+        job_cv_.wait(lock, [this]() { return !worker_running_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            return; // 已停止且没有剩余批次
+        }
+        
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        
+        std::vector<ControlResult> results = executeBatch(*job.connection, job.commands);
+        enqueueOutput(*job.connection, ControlProtocol::encodeFrame(ControlProtocol::Result, job.request_id,
+                                                                    ControlProtocol::encodeResults(results)));
+        
+        lock.lock();
+    }
+}
+
+bool ServiceControlServer::handleFrame(const std::shared_ptr<Connection>& connection,
+                                       ControlProtocol::Frame& frame) {
+    switch (frame.type) {
+        case ControlProtocol::Batch: {
+            std::vector<ControlCommand> commands;
+            if (!ControlProtocol::decodeCommands(frame.payload, commands)) {
+                return false;
+            }
+            
+            // 纯状态查询只读取发布的状态，直接在事件循环上应答
+            bool mutating = std::any_of(commands.begin(), commands.end(), [](const ControlCommand& command) {
+                return isMutating(command.operation);
+            });
+            if (!mutating) {
+                std::vector<ControlResult> results = executeBatch(*connection, commands);
+                enqueueOutput(*connection, ControlProtocol::encodeFrame(ControlProtocol::Result, frame.request_id,
+                                                                        ControlProtocol::encodeResults(results)));
+                return true;
+            }
+            
+            std::lock_guard<std::mutex> lock(job_mutex_);
+            jobs_.push_back(Job{connection, frame.request_id, std::move(commands)});
+            job_cv_.notify_one();
+            return true;
+        }
+        
+        case ControlProtocol::Subscribe:
+        case ControlProtocol::Unsubscribe: {
+            std::vector<std::string> names;
+            if (frame.type == ControlProtocol::Subscribe && !ControlProtocol::decodeNames(frame.payload, names)) {
+                return false;
+            }
+            
+            ControlError error = ControlError::None;
+            std::lock_guard<std::mutex> lock(connection->output_mutex);
+            if (frame.type == ControlProtocol::Unsubscribe) {
+                connection->subscribed = false;
+                connection->filter.clear();
+            } else if (connection->admin || policy_.allow_unprivileged_status) {
+                connection->subscribed = true;
+                connection->filter = std::unordered_set<std::string>(names.begin(), names.end());
+            } else {
+                error = ControlError::PermissionDenied;
+            }
+            
+            std::string payload(1, static_cast<char>(error));
+            queueOutputLocked(*connection, ControlProtocol::encodeFrame(ControlProtocol::Ack, frame.request_id, payload));
+            return true;
+        }
+        
+        default:
+            return false; // 未知帧类型，协议不同步
+    }
+}
+
+#ifdef __linux__
+
+bool ServiceControlServer::start(const std::string& socket_path, const ControlAccessPolicy& policy) {
+    stop();
+    
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return false;
+    }
+    
+    unlink(socket_path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 || listen(fd, 64) == -1) {
+        close(fd);
+        return false;
+    }
+    
+    // 权限由SO_PEERCRED逐条判定，允许普通用户查询时套接字需对所有人可连接
+    chmod(socket_path.c_str(), policy.allow_unprivileged_status ? 0666 : 0660);
+    
+    policy_ = policy;
+    listen_watch_ = supervisor_.addWatch(fd, EPOLLIN, [this, fd](uint32_t) {
+        acceptClients(fd);
+        return true;
+    }, true);
+    if (listen_watch_ == 0) {
+        close(fd);
+        unlink(socket_path.c_str());
+        return false;
+    }
+    socket_path_ = socket_path;
+    
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        worker_running_ = true;
+    }
+    worker_ = std::thread([this]() { workerLoop(); });
+    return true;
+}
+
+void ServiceControlServer::stop() {
+    if (listen_watch_ != 0) {
+        supervisor_.removeWatch(listen_watch_);
+        unlink(socket_path_.c_str());
+        socket_path_.clear();
+        listen_watch_ = 0;
+    }
+    
+    std::unordered_map<uint64_t, std::shared_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections.swap(connections_);
+    }
+    for (const auto& pair : connections) {
+        {
+            std::lock_guard<std::mutex> lock(pair.second->output_mutex);
+            pair.second->closed = true;
+        }
+        supervisor_.removeWatch(pair.first);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        worker_running_ = false;
+        jobs_.clear();
+    }
+    job_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void ServiceControlServer::acceptClients(int listen_fd) {
+    for (;;) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            return; // EAGAIN或出错，等待下一次事件
+        }
+        
+        ucred credentials{};
+        socklen_t length = sizeof(credentials);
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == -1) {
+            close(fd);
+            continue;
+        }
+        
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+        connection->watch_id = 0;
+        connection->uid = credentials.uid;
+        connection->pid = credentials.pid;
+        connection->admin = credentials.uid == 0 || credentials.uid == geteuid() ||
+                            std::find(policy_.admin_uids.begin(), policy_.admin_uids.end(),
+                                      credentials.uid) != policy_.admin_uids.end();
+        connection->written = 0;
+        connection->closed = false;
+        connection->want_write = false;
+        connection->in_handler = false;
+        connection->subscribed = false;
+        
+        // 先登记再监视，事件到来时连接一定在表中
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t watch_id = supervisor_.addWatch(fd, EPOLLIN, [this, connection](uint32_t events) {
+            return handleClient(connection, events);
+        }, true);
+        if (watch_id == 0) {
+            close(fd);
+            continue;
+        }
+        connection->watch_id = watch_id;
+        connections_[watch_id] = connection;
+    }
+}
+
+bool ServiceControlServer::handleClient(const std::shared_ptr<Connection>& connection, uint32_t events) {
+    auto finish = [this, &connection]() {
+        {
+            std::lock_guard<std::mutex> lock(connection->output_mutex);
+            connection->closed = true;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.erase(connection->watch_id);
+        return false;
+    };
+    
+    if (events & EPOLLERR) {
+        return finish();
+    }
+    
+    if (events & (EPOLLIN | EPOLLHUP)) {
+        // 已缓冲的数据足够一个最大帧时先处理，其余留在套接字中，水平触发会再次通知
+        char buffer[16384];
+        while (connection->input.size() <= ControlProtocol::kHeaderSize + ControlProtocol::kMaxPayloadSize) {
+            ssize_t count = read(connection->fd, buffer, sizeof(buffer));
+            if (count > 0) {
+                connection->input.append(buffer, count);
+                continue;
+            }
+            if (count == -1 && errno == EINTR) {
+                continue;
+            }
+            if (count == -1 && errno == EAGAIN) {
+                break;
+            }
+            return finish(); // 对端关闭或出错
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(connection->output_mutex);
+            connection->in_handler = true;
+        }
+        
+        // 按偏移逐帧解析，本轮结束时一次移除已处理的字节
+        ControlProtocol::Frame frame;
+        size_t offset = 0;
+        for (;;) {
+            int taken = ControlProtocol::takeFrameAt(connection->input, offset, frame);
+            if (taken == 0) {
+                break;
+            }
+            if (taken == -1 || !handleFrame(connection, frame)) {
+                return finish();
+            }
+        }
+        connection->input.erase(0, offset);
+    }
+    
+    // 应答尽量在本轮直接发出，只有发送缓冲区满时才关注可写事件
+    std::unique_lock<std::mutex> lock(connection->output_mutex);
+    connection->in_handler = false;
+    bool failed = connection->closed;
+    
+    while (!failed && connection->written < connection->output.size()) {
+        ssize_t count = send(connection->fd, connection->output.data() + connection->written,
+                             connection->output.size() - connection->written, MSG_NOSIGNAL);
+        if (count > 0) {
+            connection->written += count;
+        } else if (count == -1 && errno == EAGAIN) {
+            break;
+        } else if (count == -1 && errno != EINTR) {
+            failed = true;
+        }
+    }
+    
+    if (failed) {
+        lock.unlock();
+        return finish();
+    }
+    
+    bool drained = connection->written == connection->output.size();
+    if (drained) {
+        connection->output.clear();
+        connection->written = 0;
+    }
+    
+    // 在输出锁内修改关注事件，避免覆盖其他线程刚登记的可写关注
+    if (drained == connection->want_write) {
+        connection->want_write = !drained;
+        supervisor_.modifyWatch(connection->watch_id, drained ? EPOLLIN : EPOLLIN | EPOLLOUT);
+    }
+    return true;
+}
+
+void ServiceControlServer::queueOutputLocked(Connection& connection, const std::string& data) {
+    if (connection.closed) {
+        return;
+    }
+    
+    size_t pending = connection.output.size() - connection.written;
+    if (pending + data.size() > kMaxPendingOutput) {
+        connection.closed = true; // 由事件循环在下一次可写事件中断开
+    } else {
+        connection.output += data;
+    }
+    
+    // 事件循环正在处理该连接时会在返回前发送，无需额外唤醒
+    if (!connection.want_write && (!connection.in_handler || connection.closed)) {
+        connection.want_write = true;
+        supervisor_.modifyWatch(connection.watch_id, EPOLLIN | EPOLLOUT);
+    }
+}
+
+#else
+
+bool ServiceControlServer::start(const std::string&, const ControlAccessPolicy&) {
+    return false; // 当前平台不支持
+}
+
+void ServiceControlServer::stop() {
+}
+
+void ServiceControlServer::acceptClients(int) {
+}
+
+bool ServiceControlServer::handleClient(const std::shared_ptr<Connection>&, uint32_t) {
+    return false;
+}
+
+void ServiceControlServer::queueOutputLocked(Connection&, const std::string&) {
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
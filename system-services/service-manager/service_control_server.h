@@ -0,0 +1,112 @@
+/**
+ * @file service_control_server.h
+ * @brief 服务控制接口服务端
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 在监管事件循环上提供unix socket控制接口，协议见service_control.h
+ */
+
+#ifndef CLOUDFLOW_SERVICE_CONTROL_SERVER_H
+#define CLOUDFLOW_SERVICE_CONTROL_SERVER_H
+
+#include "service_control.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+class ServiceSupervisor;
+
+/**
+ * @brief 控制接口的访问策略
+ *
+ * root和管理器自身的有效用户总是拥有管理权限
+ */
+struct ControlAccessPolicy {
+    std::vector<uint32_t> admin_uids;       ///< 额外允许启停服务的用户
+    bool allow_unprivileged_status = true;  ///< 其他用户是否可以查询状态和订阅
+};
+
+/**
+ * @brief 服务控制接口服务端
+ *
+ * 连接的读写都在监管事件循环上完成。只含状态查询的批次直接在事件循环上应答，
+ * 含启停命令的批次交给工作线程执行，避免阻塞其他连接；
+ * 应答通过请求ID对应，不保证与请求顺序一致。
+ */
+class ServiceControlServer {
+public:
+    using CommandHandler = std::function<ControlResult(const ControlCommand& command)>;
+    
+    ServiceControlServer(ServiceSupervisor& supervisor, CommandHandler handler);
+    ~ServiceControlServer();
+    
+    ServiceControlServer(const ServiceControlServer&) = delete;
+    ServiceControlServer& operator=(const ServiceControlServer&) = delete;
+    
+    /**
+     * @brief 开始监听
+     * @param socket_path 套接字路径
+     * @param policy 访问策略
+     * @return 成功返回true
+     */
+    bool start(const std::string& socket_path, const ControlAccessPolicy& policy);
+    
+    /**
+     * @brief 停止监听并断开所有连接
+     */
+    void stop();
+    
+    /**
+     * @brief 向订阅者推送状态变化，可在任意线程调用
+     * @param event 状态变化事件
+     */
+    void publish(const ControlEvent& event);
+
+private:
+    struct Connection;
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        uint32_t request_id;
+        std::vector<ControlCommand> commands;
+    };
+    
+    void acceptClients(int listen_fd);
+    bool handleClient(const std::shared_ptr<Connection>& connection, uint32_t events);
+    bool handleFrame(const std::shared_ptr<Connection>& connection, ControlProtocol::Frame& frame);
+    std::vector<ControlResult> executeBatch(const Connection& connection, const std::vector<ControlCommand>& commands);
+    void enqueueOutput(Connection& connection, const std::string& data);
+    void queueOutputLocked(Connection& connection, const std::string& data);
+    void workerLoop();
+    
+    ServiceSupervisor& supervisor_;
+    CommandHandler handler_;
+    ControlAccessPolicy policy_;
+    std::string socket_path_;
+    uint64_t listen_watch_;
+    
+    std::mutex mutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<Connection>> connections_;
+    
+    std::mutex job_mutex_;
+    std::condition_variable job_cv_;
+    std::deque<Job> jobs_;
+    bool worker_running_;
+    std::thread worker_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_CONTROL_SERVER_H
@@ -0,0 +1,237 @@
+/**
+ * @file service_fdstore.cpp
+ * @brief 服务文件描述符存储与进程身份校验实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_fdstore.h"
+#include <cstdlib>
+#include <fstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+#ifdef __linux__
+
+unsigned long long readProcessStartTicks(int pid) {
+    if (pid <= 0) {
+        return 0;
+    }
+    
+    std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(file, line)) {
+        return 0;
+    }
+    
+    // 进程名可能含有空格和括号，从最后一个')'之后开始计数：其后第20个字段为starttime
+    size_t pos = line.rfind(')');
+    if (pos == std::string::npos) {
+        return 0;
+    }
+    
+    const char* cursor = line.c_str() + pos + 1;
+    for (int field = 3; field < 22; ++field) {
+        while (*cursor == ' ') {
+            ++cursor;
+        }
+        while (*cursor != ' ' && *cursor != '\0') {
+            ++cursor;
+        }
+    }
+    return std::strtoull(cursor, nullptr, 10);
+}
+
+int openPidfd(int pid) {
+    #ifdef SYS_pidfd_open
+        if (pid <= 0) {
+            return -1;
+        }
+        // pidfd_open返回的描述符总是带CLOEXEC标志
+        return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    #else
+        (void)pid;
+        return -1;
+    #endif
+}
+
+bool verifyProcess(int pid, unsigned long long start_ticks, int& pidfd) {
+    pidfd = -1;
+    if (pid <= 0 || start_ticks == 0) {
+        return false;
+    }
+    
+    int fd = openPidfd(pid);
+    if (readProcessStartTicks(pid) != start_ticks) {
+        if (fd != -1) {
+            close(fd);
+        }
+        return false;
+    }
+    
+    pidfd = fd;
+    return true;
+}
+
+bool pidfdExited(int pidfd) {
+    pollfd entry{};
+    entry.fd = pidfd;
+    entry.events = POLLIN;
+    return poll(&entry, 1, 0) == 1 && (entry.revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) != 0;
+}
+
+int signalProcess(int pid, int pidfd, int sig) {
+    #ifdef SYS_pidfd_send_signal
+        if (pidfd != -1) {
+            return static_cast<int>(syscall(SYS_pidfd_send_signal, pidfd, sig, nullptr, 0));
+        }
+    #else
+        (void)pidfd;
+    #endif
+    return kill(pid, sig);
+}
+
+ServiceFdStore::~ServiceFdStore() {
+    clear();
+}
+
+int ServiceFdStore::put(const std::string& key, int fd) {
+    int copy = fcntl(fd, F_DUPFD_CLOEXEC, 3);
+    if (copy == -1) {
+        return -1;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = fds_.find(key);
+    if (it != fds_.end()) {
+        close(it->second);
+        it->second = copy;
+    } else {
+        fds_.emplace(key, copy);
+    }
+    return copy;
+}
+
+bool ServiceFdStore::adopt(const std::string& key, int fd) {
+    if (fd < 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = fds_.find(key);
+    if (it != fds_.end() && it->second != fd) {
+        close(it->second);
+    }
+    fds_[key] = fd;
+    return true;
+}
+
+int ServiceFdStore::take(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = fds_.find(key);
+    if (it == fds_.end()) {
+        return -1;
+    }
+    
+    int fd = it->second;
+    fds_.erase(it);
+    return fd;
+}
+
+void ServiceFdStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : fds_) {
+        close(entry.second);
+    }
+    fds_.clear();
+}
+
+bool ServiceFdStore::preserveForExec() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : fds_) {
+        if (fcntl(entry.second, F_SETFD, 0) == -1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ServiceFdStore::restoreCloseOnExec() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : fds_) {
+        fcntl(entry.second, F_SETFD, FD_CLOEXEC);
+    }
+}
+
+#else
+
+unsigned long long readProcessStartTicks(int) {
+    return 0;
+}
+
+int openPidfd(int) {
+    return -1;
+}
+
+bool verifyProcess(int, unsigned long long, int& pidfd) {
+    pidfd = -1;
+    return false; // 当前平台不支持
+}
+
+bool pidfdExited(int) {
+    return true;
+}
+
+int signalProcess(int, int, int) {
+    return -1; // 当前平台不支持
+}
+
+ServiceFdStore::~ServiceFdStore() {
+}
+
+int ServiceFdStore::put(const std::string&, int) {
+    return -1;
+}
+
+bool ServiceFdStore::adopt(const std::string&, int) {
+    return false;
+}
+
+int ServiceFdStore::take(const std::string&) {
+    return -1;
+}
+
+void ServiceFdStore::clear() {
+}
+
+bool ServiceFdStore::preserveForExec() {
+    return false;
+}
+
+void ServiceFdStore::restoreCloseOnExec() {
+}
+
+#endif
+
+std::map<std::string, int> ServiceFdStore::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fds_;
+}
+
+std::shared_mutex& ServiceFdStore::spawnMutex() {
+    static std::shared_mutex mutex;
+    return mutex;
+}
+
+} // namespace System
+} // namespace CloudFlow
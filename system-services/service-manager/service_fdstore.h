@@ -0,0 +1,145 @@
+/**
+ * @file service_fdstore.h
+ * @brief 服务文件描述符存储与进程身份校验
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 管理器重新exec自身升级时，服务进程的pidfd、输出管道和心跳页描述符保存在存储中，
+ * 仅在exec前的一瞬间清除CLOEXEC标志，新的管理器映像据状态文件中的编号重新接管。
+ * 进程以PID加启动时刻（/proc/<pid>/stat第22项）标识，PID被复用时不会误接管
+ */
+
+#ifndef CLOUDFLOW_SERVICE_FDSTORE_H
+#define CLOUDFLOW_SERVICE_FDSTORE_H
+
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 读取进程启动时刻
+ * @param pid 进程ID
+ * @return 自系统启动以来的时钟滴答数，进程不存在时返回0
+ */
+unsigned long long readProcessStartTicks(int pid);
+
+/**
+ * @brief 打开进程的pidfd（带CLOEXEC标志）
+ * @param pid 进程ID
+ * @return 文件描述符，内核不支持或进程不存在时返回-1
+ */
+int openPidfd(int pid);
+
+/**
+ * @brief 打开并校验进程的pidfd
+ *
+ * 先打开pidfd再核对启动时刻，核对通过时pidfd一定指向预期的进程
+ * @param pid 进程ID
+ * @param start_ticks 预期的启动时刻
+ * @param pidfd 输出pidfd，内核不支持pidfd时为-1
+ * @return 进程存在且身份一致返回true
+ */
+bool verifyProcess(int pid, unsigned long long start_ticks, int& pidfd);
+
+/**
+ * @brief 检查pidfd指向的进程是否已退出
+ * @param pidfd 文件描述符
+ * @return 已退出返回true
+ */
+bool pidfdExited(int pidfd);
+
+/**
+ * @brief 向进程发送信号
+ *
+ * 有pidfd时经pidfd发送，进程退出后PID被复用也不会误发给其他进程
+ * @param pid 进程ID
+ * @param pidfd 进程的pidfd，为-1时按PID发送
+ * @param sig 信号
+ * @return 成功返回0，失败返回-1并设置errno，与kill()相同
+ */
+int signalProcess(int pid, int pidfd, int sig);
+
+/**
+ * @brief 文件描述符存储
+ *
+ * 存储持有描述符的副本，平时带CLOEXEC标志，不会泄漏给启动的服务进程。
+ * 管理器exec前调用preserveForExec()，启动服务的fork与之以spawnMutex()互斥
+ */
+class ServiceFdStore {
+public:
+    ServiceFdStore() = default;
+    ~ServiceFdStore();
+    
+    ServiceFdStore(const ServiceFdStore&) = delete;
+    ServiceFdStore& operator=(const ServiceFdStore&) = delete;
+    
+    /**
+     * @brief 存入描述符的副本，替换同名的旧描述符
+     * @param key 名称，约定为"服务名/用途"
+     * @param fd 文件描述符，调用方保留原描述符
+     * @return 存储中的描述符编号，失败返回-1
+     */
+    int put(const std::string& key, int fd);
+    
+    /**
+     * @brief 接管exec前继承下来的描述符
+     * @param key 名称
+     * @param fd 文件描述符编号，无效时忽略
+     * @return 描述符有效返回true
+     */
+    bool adopt(const std::string& key, int fd);
+    
+    /**
+     * @brief 取出描述符，所有权转移给调用方
+     * @param key 名称
+     * @return 文件描述符，不存在时返回-1
+     */
+    int take(const std::string& key);
+    
+    /**
+     * @brief 关闭并清空全部描述符
+     */
+    void clear();
+    
+    /**
+     * @brief 获取全部描述符
+     * @return 名称到编号的映射
+     */
+    std::map<std::string, int> entries() const;
+    
+    /**
+     * @brief 清除全部描述符的CLOEXEC标志，使其在exec后保留
+     *
+     * 调用方应持有spawnMutex()的独占锁直到exec返回
+     * @return 成功返回true
+     */
+    bool preserveForExec();
+    
+    /**
+     * @brief 恢复全部描述符的CLOEXEC标志，exec失败时调用
+     */
+    void restoreCloseOnExec();
+    
+    /**
+     * @brief 进程内fork与管理器exec之间的互斥锁
+     *
+     * 启动服务时以共享方式持有，避免在CLOEXEC清除期间fork的子进程继承存储中的描述符
+     * @return 互斥锁
+     */
+    static std::shared_mutex& spawnMutex();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, int> fds_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_FDSTORE_H
@@ -0,0 +1,145 @@
+/**
+ * @file service_heartbeat.h
+ * @brief 服务看门狗心跳客户端
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 配置了看门狗超时的服务启动时会继承一个共享内存心跳页，
+ * 其文件描述符由环境变量CLOUDFLOW_HEARTBEAT_FD给出。
+ * 服务只需周期性调用HeartbeatClient::beat()，每次心跳是一次原子存储，
+ * 不涉及系统调用或进程间通信。第一次心跳同时表示服务已就绪，须在看门狗超时之内发出。
+ * 本头文件不依赖服务管理器的其他部分。
+ */
+
+#ifndef CLOUDFLOW_SERVICE_HEARTBEAT_H
+#define CLOUDFLOW_SERVICE_HEARTBEAT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+constexpr uint32_t kHeartbeatMagic = 0x43464842;    ///< "CFHB"
+constexpr uint32_t kHeartbeatVersion = 1;
+constexpr const char* kHeartbeatFdEnv = "CLOUDFLOW_HEARTBEAT_FD";
+
+/**
+ * @brief 心跳页布局
+ *
+ * counter由服务写入，last_seen_ns由监管线程在观察到计数变化时写入（CLOCK_MONOTONIC纳秒）
+ */
+struct HeartbeatPage {
+    uint32_t magic;
+    uint32_t version;
+    alignas(64) std::atomic<uint64_t> counter;  ///< 心跳计数，服务独占写入
+    alignas(64) std::atomic<int64_t> last_seen_ns; ///< 最近一次观察到心跳的时间
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "心跳页要求无锁原子变量以便跨进程共享");
+static_assert(std::atomic<int64_t>::is_always_lock_free, "心跳页要求无锁原子变量以便跨进程共享");
+
+/**
+ * @brief 心跳客户端
+ *
+ * beat()不是线程安全的，多线程服务应由一个线程负责心跳，
+ * 例如在主事件循环中每轮调用一次
+ */
+class HeartbeatClient {
+public:
+    HeartbeatClient()
+        : page_(nullptr)
+        , count_(0) {
+    }
+    
+    ~HeartbeatClient() {
+        detach();
+    }
+    
+    HeartbeatClient(const HeartbeatClient&) = delete;
+    HeartbeatClient& operator=(const HeartbeatClient&) = delete;
+    
+    /**
+     * @brief 映射服务管理器传入的心跳页
+     * @return 成功返回true；服务未配置看门狗时返回false
+     */
+    bool attach() {
+        #ifdef __linux__
+            if (page_) {
+                return true;
+            }
+            
+            const char* value = std::getenv(kHeartbeatFdEnv);
+            if (!value) {
+                return false;
+            }
+            
+            int fd = std::atoi(value);
+            void* mapping = mmap(nullptr, sizeof(HeartbeatPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                return false;
+            }
+            
+            HeartbeatPage* page = static_cast<HeartbeatPage*>(mapping);
+            if (page->magic != kHeartbeatMagic || page->version != kHeartbeatVersion) {
+                munmap(mapping, sizeof(HeartbeatPage));
+                return false;
+            }
+            
+            // 映射建立后不再需要描述符，避免泄漏给子进程
+            close(fd);
+            unsetenv(kHeartbeatFdEnv);
+            
+            page_ = page;
+            count_ = page->counter.load(std::memory_order_relaxed);
+            return true;
+        #else
+            return false;
+        #endif
+    }
+    
+    /**
+     * @brief 解除映射
+     */
+    void detach() {
+        #ifdef __linux__
+            if (page_) {
+                munmap(page_, sizeof(HeartbeatPage));
+                page_ = nullptr;
+            }
+        #endif
+    }
+    
+    /**
+     * @brief 检查是否已映射心跳页
+     * @return 已映射返回true
+     */
+    bool isAttached() const {
+        return page_ != nullptr;
+    }
+    
+    /**
+     * @brief 发送一次心跳
+     */
+    void beat() {
+        if (page_) {
+            page_->counter.store(++count_, std::memory_order_release);
+        }
+    }
+
+private:
+    HeartbeatPage* page_;
+    uint64_t count_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_HEARTBEAT_H
@@ -0,0 +1,214 @@
+/**
+ * @file service_history.cpp
+ * @brief 服务启动耗时历史实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_history.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+std::string formatSeconds(std::chrono::milliseconds duration) {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3)
+           << std::chrono::duration<double>(duration).count() << "s";
+    return stream.str();
+}
+
+// 最近邻秩法：排序后第ceil(0.95 * n)个样本
+double percentile95(const std::deque<uint32_t>& samples) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    
+    std::vector<uint32_t> sorted(samples.begin(), samples.end());
+    size_t rank = (sorted.size() * 95 + 99) / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + (rank - 1), sorted.end());
+    return sorted[rank - 1];
+}
+
+} // namespace
+
+StartDurationHistory::StartDurationHistory(double alpha, size_t window)
+    : alpha_(alpha)
+    , window_(std::max<size_t>(window, 1)) {
+}
+
+bool StartDurationHistory::load(const std::string& path) {
+    std::unordered_map<std::string, Entry> entries;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        return false;
+    }
+    
+    std::string name;
+    Entry entry{0.0, 0, {}};
+    auto flush = [&]() {
+        if (!name.empty() && entry.samples > 0) {
+            entries[name] = entry;
+        }
+        name.clear();
+        entry = Entry{0.0, 0, {}};
+    };
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line == "[service_start]") {
+            flush();
+            continue;
+        }
+        
+        size_t pos = line.find('=');
+        if (pos == std::string::npos) {
+            continue;
+        }
+        
+        std::string key = line.substr(0, pos);
+        std::string value = line.substr(pos + 1);
+        if (key == "name") {
+            name = value;
+        } else if (key == "ewma_ms") {
+            entry.ewma_ms = std::strtod(value.c_str(), nullptr);
+        } else if (key == "samples") {
+            entry.samples = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "recent") {
+            std::istringstream stream(value);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                if (!item.empty()) {
+                    entry.recent.push_back(static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10)));
+                }
+            }
+            while (entry.recent.size() > window_) {
+                entry.recent.pop_front();
+            }
+        }
+    }
+    flush();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.swap(entries);
+    return true;
+}
+
+bool StartDurationHistory::save(const std::string& path) const {
+    std::ostringstream content;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::string> names;
+        for (const auto& pair : entries_) {
+            names.push_back(pair.first);
+        }
+        std::sort(names.begin(), names.end());
+        
+        for (const auto& name : names) {
+            const Entry& entry = entries_.at(name);
+            content << "[service_start]\n";
+            content << "name=" << name << "\n";
+            content << "ewma_ms=" << std::fixed << std::setprecision(1) << entry.ewma_ms << "\n";
+            content << "samples=" << entry.samples << "\n";
+            content << "recent=";
+            for (size_t i = 0; i < entry.recent.size(); ++i) {
+                content << (i > 0 ? "," : "") << entry.recent[i];
+            }
+            content << "\n\n";
+        }
+    }
+    
+    // 改名是原子的，断电时不会留下截断的历史文件
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << content.str();
+        file.flush();
+        if (!file.good()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+void StartDurationHistory::record(const std::string& name, std::chrono::milliseconds duration) {
+    double sample = static_cast<double>(std::max<int64_t>(duration.count(), 0));
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[name];
+    entry.ewma_ms = entry.samples == 0 ? sample : alpha_ * sample + (1.0 - alpha_) * entry.ewma_ms;
+    ++entry.samples;
+    entry.recent.push_back(static_cast<uint32_t>(sample));
+    while (entry.recent.size() > window_) {
+        entry.recent.pop_front();
+    }
+}
+
+bool StartDurationHistory::lookup(const std::string& name, StartDurationStats& stats) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+        return false;
+    }
+    
+    stats.ewma_ms = it->second.ewma_ms;
+    stats.p95_ms = percentile95(it->second.recent);
+    stats.samples = it->second.samples;
+    return true;
+}
+
+std::string formatBootPrediction(const BootPrediction& prediction) {
+    std::ostringstream report;
+    report << "=== 预计与实际启动耗时 ===\n";
+    if (!prediction.valid) {
+        report << "没有批量启动记录\n";
+        return report.str();
+    }
+    
+    report << "预计: " << formatSeconds(prediction.predicted)
+           << "（p95: " << formatSeconds(prediction.predicted_p95) << "）"
+           << "  实际: " << formatSeconds(prediction.actual) << "\n";
+    
+    // 偏差最大的服务排在最前，便于发现估计失准的服务
+    std::vector<BootPrediction::Entry> entries = prediction.entries;
+    std::sort(entries.begin(), entries.end(), [](const BootPrediction::Entry& a, const BootPrediction::Entry& b) {
+        auto error_a = a.actual.count() < 0 ? a.actual.max() : a.actual - a.predicted;
+        auto error_b = b.actual.count() < 0 ? b.actual.max() : b.actual - b.predicted;
+        error_a = error_a.count() < 0 ? -error_a : error_a;
+        error_b = error_b.count() < 0 ? -error_b : error_b;
+        if (error_a != error_b) {
+            return error_a > error_b;
+        }
+        return a.name < b.name;
+    });
+    
+    for (const auto& entry : entries) {
+        report << "\n" << entry.name << " 预计@" << formatSeconds(entry.predicted);
+        if (!entry.learned) {
+            report << "（无历史）";
+        }
+        if (entry.actual.count() < 0) {
+            report << " 未就绪";
+        } else {
+            report << " 实际@" << formatSeconds(entry.actual);
+        }
+    }
+    report << "\n";
+    return report.str();
+}
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,119 @@
+/**
+ * @file service_history.h
+ * @brief 服务启动耗时历史
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 跨启动记录每个服务从创建进程到就绪的耗时，以指数加权平均作为调度估计，
+ * 以最近若干次的p95作为悲观估计，供启动准入按关键路径排序和预测启动总耗时
+ */
+
+#ifndef CLOUDFLOW_SERVICE_HISTORY_H
+#define CLOUDFLOW_SERVICE_HISTORY_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 单个服务的启动耗时统计
+ */
+struct StartDurationStats {
+    double ewma_ms;         ///< 指数加权平均（毫秒）
+    double p95_ms;          ///< 最近样本的第95百分位（毫秒）
+    uint64_t samples;       ///< 累计样本数
+};
+
+/**
+ * @brief 批量启动的预测与实际结果
+ */
+struct BootPrediction {
+    struct Entry {
+        std::string name;
+        std::chrono::milliseconds predicted;    ///< 预计就绪时刻（相对批量启动开始）
+        std::chrono::milliseconds actual;       ///< 实际就绪时刻，未就绪时为负数
+        bool learned;                           ///< 预测是否基于历史记录
+    };
+    
+    bool valid = false;
+    std::chrono::milliseconds predicted{0};     ///< 按平均耗时预测的总耗时
+    std::chrono::milliseconds predicted_p95{0}; ///< 按p95耗时预测的总耗时
+    std::chrono::milliseconds actual{0};        ///< 实际总耗时
+    std::vector<Entry> entries;
+};
+
+/**
+ * @brief 启动耗时历史
+ *
+ * 线程安全，文件格式与服务状态文件相同：每个服务一节，节内为键值对
+ */
+class StartDurationHistory {
+public:
+    /**
+     * @brief 构造函数
+     * @param alpha 指数加权平均中新样本的权重
+     * @param window 计算p95保留的最近样本数
+     */
+    explicit StartDurationHistory(double alpha = 0.3, size_t window = 32);
+    
+    /**
+     * @brief 从文件加载，替换当前记录
+     * @param path 文件路径
+     * @return 成功返回true，文件不存在时返回false且记录为空
+     */
+    bool load(const std::string& path);
+    
+    /**
+     * @brief 保存到文件，先写临时文件再改名
+     * @param path 文件路径
+     * @return 成功返回true
+     */
+    bool save(const std::string& path) const;
+    
+    /**
+     * @brief 记录一次启动耗时
+     * @param name 服务名称
+     * @param duration 从创建进程到就绪的耗时
+     */
+    void record(const std::string& name, std::chrono::milliseconds duration);
+    
+    /**
+     * @brief 查询服务的统计
+     * @param name 服务名称
+     * @param stats 输出统计
+     * @return 有记录返回true
+     */
+    bool lookup(const std::string& name, StartDurationStats& stats) const;
+
+private:
+    struct Entry {
+        double ewma_ms;
+        uint64_t samples;
+        std::deque<uint32_t> recent;    ///< 最近样本（毫秒），最旧的在前
+    };
+    
+    double alpha_;
+    size_t window_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+/**
+ * @brief 生成预测与实际启动耗时的对比报告
+ * @param prediction 最近一次批量启动的结果
+ * @return 报告文本
+ */
+std::string formatBootPrediction(const BootPrediction& prediction);
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_HISTORY_H
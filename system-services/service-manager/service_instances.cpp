@@ -0,0 +1,274 @@
+/**
+ * @file service_instances.cpp
+ * @brief 多实例服务实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_instances.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+// 管理器进程可用的CPU，受cpuset和亲和性限制
+std::vector<int> availableCpus() {
+    std::vector<int> cpus;
+    #ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+    #endif
+    
+    if (cpus.empty()) {
+        unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+// 解析sysfs中"0-3,8-11"格式的CPU列表
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::istringstream stream(text);
+    std::string range;
+    
+    while (std::getline(stream, range, ',')) {
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // 忽略无法解析的片段
+        }
+    }
+    return cpus;
+}
+
+std::vector<std::vector<int>> numaNodeCpus(const std::vector<int>& available) {
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    
+    #ifdef __linux__
+        const std::string base = "/sys/devices/system/node";
+        DIR* dir = opendir(base.c_str());
+        if (dir) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                    !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                    continue;
+                }
+                
+                std::ifstream file(base + "/" + name + "/cpulist");
+                std::string text;
+                std::getline(file, text);
+                
+                // 只保留管理器可用的CPU，没有可用CPU的节点（如纯内存节点）不放置实例
+                std::vector<int> cpus;
+                for (int cpu : parseCpuList(text)) {
+                    if (std::binary_search(available.begin(), available.end(), cpu)) {
+                        cpus.push_back(cpu);
+                    }
+                }
+                if (!cpus.empty()) {
+                    nodes.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+                }
+            }
+            closedir(dir);
+        }
+    #endif
+    
+    std::sort(nodes.begin(), nodes.end());
+    
+    std::vector<std::vector<int>> placements;
+    for (auto& node : nodes) {
+        placements.push_back(std::move(node.second));
+    }
+    if (placements.empty()) {
+        placements.push_back(available); // 非NUMA系统视为单节点
+    }
+    return placements;
+}
+
+std::string expandSpecifiers(const std::string& text, const ServiceConfig& template_config,
+                             const std::string& instance_name, int index, const std::string& cpus) {
+    if (text.find('%') == std::string::npos) {
+        return text;
+    }
+    
+    std::string expanded;
+    expanded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '%' || i + 1 == text.size()) {
+            expanded += text[i];
+            continue;
+        }
+        
+        switch (text[++i]) {
+            case 'n': expanded += template_config.name; break;
+            case 'N': expanded += instance_name; break;
+            case 'i': expanded += std::to_string(index); break;
+            case 'c': expanded += cpus; break;
+            case '%': expanded += '%'; break;
+            default:
+                // 未知占位符原样保留
+                expanded += '%';
+                expanded += text[i];
+                break;
+        }
+    }
+    return expanded;
+}
+
+} // namespace
+
+std::vector<std::vector<int>> computeInstancePlacements(InstanceMode mode) {
+    std::vector<std::vector<int>> placements;
+    
+    switch (mode) {
+        case InstanceMode::PerCpu:
+            for (int cpu : availableCpus()) {
+                placements.push_back({cpu});
+            }
+            break;
+        case InstanceMode::PerNumaNode:
+            placements = numaNodeCpus(availableCpus());
+            break;
+        case InstanceMode::Single:
+        case InstanceMode::Fixed:
+            break;
+    }
+    
+    return placements;
+}
+
+int defaultInstanceCount(const ServiceConfig& config, const std::vector<std::vector<int>>& placements) {
+    if (config.instances.count > 0) {
+        return config.instances.count;
+    }
+    return placements.empty() ? 1 : static_cast<int>(placements.size());
+}
+
+std::string makeInstanceName(const std::string& template_name, int index) {
+    return template_name + "@" + std::to_string(index);
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string text;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t end = i;
+        while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) {
+            ++end;
+        }
+        
+        if (!text.empty()) {
+            text += ",";
+        }
+        text += std::to_string(cpus[i]);
+        if (end > i) {
+            text += "-" + std::to_string(cpus[end]);
+        }
+        i = end + 1;
+    }
+    return text;
+}
+
+ServiceConfig makeInstanceConfig(const ServiceConfig& template_config, int index,
+                                 const std::vector<std::vector<int>>& placements) {
+    ServiceConfig config = template_config;
+    config.name = makeInstanceName(template_config.name, index);
+    config.instance_index = index;
+    config.instances.mode = InstanceMode::Single;
+    config.instances.count = 0;
+    
+    // 实例数超过放置位置时循环复用
+    if (!placements.empty()) {
+        config.cpu_affinity = placements[index % placements.size()];
+    }
+    std::string cpus = formatCpuList(config.cpu_affinity);
+    
+    auto expand = [&](const std::string& text) {
+        return expandSpecifiers(text, template_config, config.name, index, cpus);
+    };
+    
+    for (auto& arg : config.args) {
+        arg = expand(arg);
+    }
+    for (auto& env : config.environment) {
+        env.second = expand(env.second);
+    }
+    config.working_directory = expand(config.working_directory);
+    config.log.file_path = expand(config.log.file_path);
+    
+    config.environment["CLOUDFLOW_INSTANCE"] = std::to_string(index);
+    if (!cpus.empty()) {
+        config.environment["CLOUDFLOW_CPUS"] = cpus;
+    }
+    
+    return config;
+}
+
+#ifdef __linux__
+
+int openReusePortListener(const std::string& address, int port) {
+    sockaddr_in socket_address{};
+    socket_address.sin_family = AF_INET;
+    socket_address.sin_port = htons(static_cast<uint16_t>(port));
+    if (port <= 0 || port > 65535 || inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) != 1) {
+        return -1;
+    }
+    
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    
+    int enable = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) == -1 ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == -1 ||
+        bind(fd, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) == -1 ||
+        listen(fd, SOMAXCONN) == -1) {
+        close(fd);
+        return -1;
+    }
+    
+    return fd;
+}
+
+#else
+
+int openReusePortListener(const std::string&, int) {
+    return -1; // 当前平台不支持
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,74 @@
+/**
+ * @file service_instances.h
+ * @brief 多实例服务
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 计算实例的CPU放置、生成实例配置，以及为实例创建SO_REUSEPORT监听套接字
+ */
+
+#ifndef CLOUDFLOW_SERVICE_INSTANCES_H
+#define CLOUDFLOW_SERVICE_INSTANCES_H
+
+#include "service_manager.h"
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 获取实例的CPU放置方案
+ * @param mode 实例模式
+ * @return 每个放置位置的CPU列表；PerCpu每个CPU一项，PerNumaNode每个节点一项，其他模式为空
+ */
+std::vector<std::vector<int>> computeInstancePlacements(InstanceMode mode);
+
+/**
+ * @brief 计算模板的默认实例数
+ * @param config 模板配置
+ * @param placements 放置方案
+ * @return 实例数
+ */
+int defaultInstanceCount(const ServiceConfig& config, const std::vector<std::vector<int>>& placements);
+
+/**
+ * @brief 生成实例名称
+ * @param template_name 模板名称
+ * @param index 实例序号
+ * @return "模板名称@序号"
+ */
+std::string makeInstanceName(const std::string& template_name, int index);
+
+/**
+ * @brief 将CPU列表格式化为"0-3,8"形式
+ * @param cpus 升序CPU列表
+ * @return 格式化文本
+ */
+std::string formatCpuList(const std::vector<int>& cpus);
+
+/**
+ * @brief 由模板配置生成实例配置
+ * @param template_config 模板配置
+ * @param index 实例序号
+ * @param placements 放置方案，为空时不绑定CPU
+ * @return 实例配置
+ */
+ServiceConfig makeInstanceConfig(const ServiceConfig& template_config, int index,
+                                 const std::vector<std::vector<int>>& placements);
+
+/**
+ * @brief 创建启用SO_REUSEPORT的TCP监听套接字
+ *
+ * 同一端口上各实例各自持有一个套接字，由内核在实例间分发连接
+ * @param address IPv4监听地址
+ * @param port 端口
+ * @return 带CLOEXEC标志的套接字，失败返回-1
+ */
+int openReusePortListener(const std::string& address, int port);
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_INSTANCES_H
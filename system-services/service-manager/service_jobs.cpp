@@ -0,0 +1,336 @@
+/**
+ * @file service_jobs.cpp
+ * @brief 服务启停作业实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_jobs.h"
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+namespace CloudFlow {
+namespace System {
+
+struct ServiceJobEngine::Job {
+    std::string name;
+    JobType type;
+    bool running = false;
+    bool done = false;                  ///< 尚未执行即被相反作业取代时也置位，结果为失败
+    bool success = false;
+    std::shared_ptr<Job> predecessor;   ///< 登记时正在执行的相反作业，本作业在它结束后执行
+};
+
+ServiceJobEngine::ServiceJobEngine(Describe describe, Scheduler scheduler)
+    : describe_(std::move(describe))
+    , scheduler_(std::move(scheduler)) {
+}
+
+bool ServiceJobEngine::collect(const std::vector<std::string>& names, std::vector<std::string>& order,
+                               std::unordered_map<std::string, UnitInfo>& units, std::string& error) {
+    // 深度优先拉入依赖；已在运行的依赖不再展开，除非它有待执行的停止作业需要取消
+    std::unordered_set<std::string> roots(names.begin(), names.end());
+    std::vector<std::string> stack(names.rbegin(), names.rend());
+    while (!stack.empty()) {
+        std::string name = std::move(stack.back());
+        stack.pop_back();
+        if (units.count(name) != 0) {
+            continue;
+        }
+        
+        UnitInfo info;
+        if (!describe_(name, info)) {
+            error = "服务不存在: " + name;
+            return false;
+        }
+        
+        if (info.active && roots.count(name) == 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = jobs_.find(name);
+            if (it == jobs_.end() || it->second->type != JobType::Stop) {
+                continue;
+            }
+        }
+        
+        for (auto dependency = info.dependencies.rbegin(); dependency != info.dependencies.rend(); ++dependency) {
+            if (units.count(*dependency) == 0) {
+                stack.push_back(*dependency);
+            }
+        }
+        order.push_back(name);
+        units.emplace(std::move(name), std::move(info));
+    }
+    return true;
+}
+
+std::vector<std::string> ServiceJobEngine::dependencyOrder(const std::vector<std::string>& names,
+                                                           const std::unordered_map<std::string, UnitInfo>& units) {
+    // 深度优先后序遍历，依赖排在依赖它的服务之前；只考虑units中的服务，循环依赖按遇到的顺序断开
+    std::vector<std::string> order;
+    std::unordered_set<std::string> visited;
+    for (const auto& root : names) {
+        if (units.count(root) == 0 || visited.count(root) != 0) {
+            continue;
+        }
+        
+        std::vector<std::pair<std::string, bool>> stack{{root, false}};
+        while (!stack.empty()) {
+            std::pair<std::string, bool> entry = std::move(stack.back());
+            stack.pop_back();
+            if (entry.second) {
+                order.push_back(std::move(entry.first));
+                continue;
+            }
+            if (!visited.insert(entry.first).second) {
+                continue;
+            }
+            
+            const std::vector<std::string>& dependencies = units.at(entry.first).dependencies;
+            stack.emplace_back(entry.first, true);
+            for (auto dependency = dependencies.rbegin(); dependency != dependencies.rend(); ++dependency) {
+                if (units.count(*dependency) != 0 && visited.count(*dependency) == 0) {
+                    stack.emplace_back(*dependency, false);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+std::shared_ptr<ServiceJobEngine::Job> ServiceJobEngine::installLocked(const std::string& name, JobType type, bool& merged) {
+    merged = false;
+    std::shared_ptr<Job>& slot = jobs_[name];
+    if (slot && slot->type == type) {
+        merged = true;
+        return slot;
+    }
+    
+    auto job = std::make_shared<Job>();
+    job->name = name;
+    job->type = type;
+    if (slot) {
+        if (slot->running) {
+            job->predecessor = slot;
+        } else {
+            slot->done = true;
+            finished_cv_.notify_all();
+        }
+    }
+    slot = job;
+    return job;
+}
+
+bool ServiceJobEngine::execute(const std::shared_ptr<Job>& job, const Action& action) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (job->predecessor) {
+            std::shared_ptr<Job> predecessor = job->predecessor;
+            finished_cv_.wait(lock, [&predecessor]() { return predecessor->done; });
+            job->predecessor.reset();
+        }
+        if (job->done) {
+            return job->success; // 等待期间被取消
+        }
+        job->running = true;
+    }
+    
+    bool success = action(job->name);
+    finish(job, success);
+    return success;
+}
+
+bool ServiceJobEngine::wait(const std::shared_ptr<Job>& job) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_cv_.wait(lock, [&job]() { return job->done; });
+    return job->success;
+}
+
+void ServiceJobEngine::finish(const std::shared_ptr<Job>& job, bool success) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!job->done) {
+        job->done = true;
+        job->success = success;
+    }
+    
+    auto it = jobs_.find(job->name);
+    if (it != jobs_.end() && it->second == job) {
+        jobs_.erase(it);
+    }
+    finished_cv_.notify_all();
+}
+
+bool ServiceJobEngine::start(const std::vector<std::string>& names, const Action& starter, std::string& error) {
+    std::vector<std::string> order;
+    std::unordered_map<std::string, UnitInfo> units;
+    if (!collect(names, order, units, error)) {
+        return false;
+    }
+    
+    // 本事务新建的作业交给调度器，合并到已有作业的服务只等待结果
+    std::unordered_map<std::string, std::shared_ptr<Job>> owned;
+    std::unordered_map<std::string, std::shared_ptr<Job>> merged;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& name : order) {
+            bool is_merged = false;
+            std::shared_ptr<Job> job = installLocked(name, JobType::Start, is_merged);
+            (is_merged ? merged : owned).emplace(name, std::move(job));
+        }
+    }
+    
+    std::vector<StartJob> jobs;
+    jobs.reserve(owned.size());
+    for (const auto& name : order) {
+        if (owned.count(name) != 0) {
+            const UnitInfo& info = units.at(name);
+            jobs.push_back(StartJob{name, info.dependencies, info.priority, info.expected});
+        }
+    }
+    
+    if (!jobs.empty()) {
+        scheduler_(jobs, [&](const std::string& name) {
+            const std::shared_ptr<Job>& job = owned.at(name);
+            for (const auto& dependency : units.at(name).dependencies) {
+                auto other = merged.find(dependency);
+                if (other != merged.end() && !wait(other->second)) {
+                    finish(job, false);
+                    return false;
+                }
+            }
+            return execute(job, starter);
+        }, false);
+    }
+    
+    // 因依赖失败被调度器跳过的作业没有执行
+    std::vector<std::string> failed;
+    for (const auto& name : order) {
+        auto it = owned.find(name);
+        bool success;
+        if (it != owned.end()) {
+            finish(it->second, false);
+            success = wait(it->second);
+        } else {
+            success = wait(merged.at(name));
+        }
+        if (!success) {
+            failed.push_back(name);
+        }
+    }
+    
+    if (!failed.empty()) {
+        error = "启动失败:";
+        for (const auto& name : failed) {
+            error += " " + name;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool ServiceJobEngine::stop(const std::vector<std::string>& names, const Action& stopper, std::string& error) {
+    bool all_stopped = true;
+    std::unordered_map<std::string, UnitInfo> units;
+    for (const auto& name : names) {
+        UnitInfo info;
+        if (!describe_(name, info)) {
+            error = "服务不存在: " + name;
+            all_stopped = false;
+            continue;
+        }
+        units.emplace(name, std::move(info));
+    }
+    
+    // 依赖其他服务的先停止，被依赖的服务停止时不再有本事务内的服务使用它。
+    // 按依赖顺序倒序分波：本事务内依赖它的服务全部停止后才进入下一波，同一波交给调度器并行执行
+    std::vector<std::string> order = dependencyOrder(names, units);
+    std::unordered_map<std::string, std::vector<std::string>> dependents;
+    for (const auto& name : order) {
+        for (const auto& dependency : units.at(name).dependencies) {
+            if (units.count(dependency) != 0) {
+                dependents[dependency].push_back(name);
+            }
+        }
+    }
+    
+    // 倒序遍历时依赖它的服务已先分好波次；循环依赖中尚未分到的忽略
+    std::unordered_map<std::string, size_t> wave_of;
+    std::vector<std::vector<std::string>> waves;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        size_t wave = 0;
+        for (const auto& dependent : dependents[*it]) {
+            auto other = wave_of.find(dependent);
+            if (other != wave_of.end()) {
+                wave = std::max(wave, other->second + 1);
+            }
+        }
+        wave_of.emplace(*it, wave);
+        if (waves.size() <= wave) {
+            waves.resize(wave + 1);
+        }
+        waves[wave].push_back(*it);
+    }
+    
+    std::unordered_map<std::string, std::shared_ptr<Job>> owned;
+    std::unordered_map<std::string, std::shared_ptr<Job>> merged;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            bool is_merged = false;
+            std::shared_ptr<Job> job = installLocked(*it, JobType::Stop, is_merged);
+            (is_merged ? merged : owned).emplace(*it, std::move(job));
+        }
+    }
+    
+    for (const auto& wave : waves) {
+        std::vector<StartJob> jobs;
+        for (const auto& name : wave) {
+            if (owned.count(name) != 0) {
+                const UnitInfo& info = units.at(name);
+                jobs.push_back(StartJob{name, {}, info.priority, info.expected});
+            }
+        }
+        if (jobs.empty()) {
+            continue;
+        }
+        
+        // 合并到已有作业的依赖方只等待其结束，停止失败也不妨碍继续停止被依赖的服务
+        scheduler_(jobs, [&](const std::string& name) {
+            for (const auto& dependent : dependents[name]) {
+                auto other = merged.find(dependent);
+                if (other != merged.end()) {
+                    wait(other->second);
+                }
+            }
+            return execute(owned.at(name), stopper);
+        }, true);
+    }
+    
+    std::vector<std::string> failed;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        auto job = owned.find(*it);
+        bool success;
+        if (job != owned.end()) {
+            finish(job->second, false);
+            success = wait(job->second);
+        } else {
+            success = wait(merged.at(*it));
+        }
+        if (!success) {
+            failed.push_back(*it);
+        }
+    }
+    
+    if (!failed.empty()) {
+        error = "停止失败:";
+        for (const auto& name : failed) {
+            error += " " + name;
+        }
+        all_stopped = false;
+    }
+    return all_stopped;
+}
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,126 @@
+/**
+ * @file service_jobs.h
+ * @brief 服务启停作业
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 每次启动或停止请求构成一个事务：启动时沿依赖关系拉入尚未运行的依赖服务，
+ * 整个事务交给并行调度器按依赖顺序执行。每个服务同一时刻至多登记一个作业，
+ * 新事务与已登记作业的关系：
+ *   - 同类作业合并，新事务等待已有作业的结果，不重复执行
+ *   - 相反作业尚未开始执行时被取消，由新作业取代
+ *   - 相反作业正在执行时，新作业等它结束后再执行
+ */
+
+#ifndef CLOUDFLOW_SERVICE_JOBS_H
+#define CLOUDFLOW_SERVICE_JOBS_H
+
+#include "service_admission.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 服务启停作业引擎
+ *
+ * 线程安全；事务在调用线程上调度，结束后返回
+ */
+class ServiceJobEngine {
+public:
+    /**
+     * @brief 作业引擎需要的服务信息
+     */
+    struct UnitInfo {
+        std::vector<std::string> dependencies;  ///< 依赖服务
+        ServicePriority priority;               ///< 启动优先级
+        std::chrono::milliseconds expected;     ///< 预计启动耗时
+        bool active;                            ///< 已在运行或启动中，无需拉入
+    };
+    
+    /**
+     * @brief 查询服务信息
+     * @param name 服务名称
+     * @param info 输出服务信息
+     * @return 服务存在返回true
+     */
+    using Describe = std::function<bool(const std::string& name, UnitInfo& info)>;
+    
+    /**
+     * @brief 执行单个服务的启动或停止，可能在多个线程上并发调用
+     * @param name 服务名称
+     * @return 成功返回true
+     */
+    using Action = std::function<bool(const std::string& name)>;
+    
+    /**
+     * @brief 并行调度一批启动或停止作业，全部结束后返回
+     * @param jobs 作业，依赖只在本批中排序
+     * @param action 启动或停止函数
+     * @param stopping 本批为停止作业
+     * @return 全部成功返回true
+     */
+    using Scheduler = std::function<bool(const std::vector<StartJob>& jobs, const StartAdmissionController::Starter& action,
+                                         bool stopping)>;
+    
+    ServiceJobEngine(Describe describe, Scheduler scheduler);
+    
+    ServiceJobEngine(const ServiceJobEngine&) = delete;
+    ServiceJobEngine& operator=(const ServiceJobEngine&) = delete;
+    
+    /**
+     * @brief 启动服务及其尚未运行的依赖
+     * @param names 服务名称
+     * @param starter 启动单个服务
+     * @param error 失败时输出原因
+     * @return 全部服务及其依赖启动成功返回true
+     */
+    bool start(const std::vector<std::string>& names, const Action& starter, std::string& error);
+    
+    /**
+     * @brief 停止服务，不影响依赖它的服务
+     *
+     * 本事务内依赖其他服务的先停止：按依赖关系倒序分波，每一波交给调度器并行执行
+     * @param names 服务名称
+     * @param stopper 停止单个服务
+     * @param error 失败时输出原因
+     * @return 全部停止成功返回true
+     */
+    bool stop(const std::vector<std::string>& names, const Action& stopper, std::string& error);
+
+private:
+    enum class JobType {
+        Start,
+        Stop
+    };
+    
+    struct Job;
+    
+    bool collect(const std::vector<std::string>& names, std::vector<std::string>& order,
+                 std::unordered_map<std::string, UnitInfo>& units, std::string& error);
+    static std::vector<std::string> dependencyOrder(const std::vector<std::string>& names,
+                                                    const std::unordered_map<std::string, UnitInfo>& units);
+    std::shared_ptr<Job> installLocked(const std::string& name, JobType type, bool& merged);
+    bool execute(const std::shared_ptr<Job>& job, const Action& action);
+    bool wait(const std::shared_ptr<Job>& job);
+    void finish(const std::shared_ptr<Job>& job, bool success);
+    
+    Describe describe_;
+    Scheduler scheduler_;
+    
+    std::mutex mutex_;
+    std::condition_variable finished_cv_;
+    std::unordered_map<std::string, std::shared_ptr<Job>> jobs_;   ///< 每个服务当前登记的作业
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_JOBS_H
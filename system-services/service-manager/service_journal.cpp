@@ -0,0 +1,335 @@
+/**
+ * @file service_journal.cpp
+ * @brief 服务生命周期事件日志实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_journal.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+constexpr uint64_t kJournalMagic = 0x4C4E524A46574C43ULL; // "CLWFJRNL"
+constexpr uint32_t kJournalVersion = 1;
+constexpr size_t kHeaderSize = 4096;
+constexpr size_t kPayloadWords = 15;
+constexpr size_t kMaxNameLength = 72;
+
+// 槽位负载，按64位字原子存取
+struct JournalPayload {
+    int64_t timestamp_ns;
+    uint32_t type;
+    int32_t pid;
+    int32_t old_state;
+    int32_t new_state;
+    int32_t exit_code;
+    int32_t signal;
+    int32_t restart_count;
+    uint32_t name_length;
+    int64_t duration_ns;
+    char name[kMaxNameLength];
+};
+
+static_assert(sizeof(JournalPayload) == kPayloadWords * sizeof(uint64_t), "负载须恰好占满槽位");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "映射到文件的原子变量必须无锁");
+
+// 文件头中不变的部分，离线读取时先单独读出校验
+struct JournalFormat {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;
+};
+
+// 槽位序列号：偶数2*(seq+1)表示序号seq的记录已提交，奇数表示写入进行中
+uint64_t committedMark(uint64_t seq) {
+    return 2 * seq + 2;
+}
+
+} // namespace
+
+struct ServiceJournal::Header {
+    JournalFormat format;
+    std::atomic<uint64_t> next;     ///< 下一个待分配的序号
+};
+
+struct ServiceJournal::Slot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[kPayloadWords];
+};
+
+ServiceJournal::ServiceJournal()
+    : header_(nullptr)
+    , slots_(nullptr)
+    , capacity_(0)
+    , mapped_size_(0)
+    , writable_(false) {
+}
+
+ServiceJournal::~ServiceJournal() {
+    close();
+}
+
+bool ServiceJournal::isOpen() const {
+    return header_.load(std::memory_order_acquire) != nullptr;
+}
+
+#ifdef __linux__
+
+// 只建立映射，由调用方设置容量并完成初始化后再发布header_
+ServiceJournal::Header* ServiceJournal::map(int fd, size_t size, bool writable) {
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* address = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+    
+    mapped_size_ = size;
+    writable_ = writable;
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(address) + kHeaderSize);
+    return static_cast<Header*>(address);
+}
+
+bool ServiceJournal::open(const std::string& path, size_t capacity) {
+    close();
+    if (capacity == 0) {
+        return false;
+    }
+    
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return false;
+    }
+    
+    size_t size = kHeaderSize + capacity * sizeof(Slot);
+    struct stat info;
+    bool reuse = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == size;
+    if (!reuse && (ftruncate(fd, 0) == -1 || ftruncate(fd, static_cast<off_t>(size)) == -1)) {
+        ::close(fd);
+        return false;
+    }
+    
+    Header* header = map(fd, size, true);
+    ::close(fd);
+    if (!header) {
+        return false;
+    }
+    capacity_ = capacity;
+    
+    const JournalFormat& format = header->format;
+    if (reuse && format.magic == kJournalMagic && format.version == kJournalVersion &&
+        format.slot_size == sizeof(Slot) && format.capacity == capacity) {
+        // 上次写入中途崩溃的槽位没有完整记录，清空后才能再次写入
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].sequence.load(std::memory_order_relaxed) & 1) {
+                slots_[i].sequence.store(0, std::memory_order_relaxed);
+            }
+        }
+    } else {
+        std::memset(static_cast<void*>(header), 0, size);
+        header->format.version = kJournalVersion;
+        header->format.slot_size = sizeof(Slot);
+        header->format.capacity = capacity;
+        header->next.store(0, std::memory_order_relaxed);
+        header->format.magic = kJournalMagic;
+    }
+    
+    // 容量和内容都就绪后才发布，并发的append()和query()不会看到未初始化的日志
+    header_.store(header, std::memory_order_release);
+    return true;
+}
+
+bool ServiceJournal::openReadOnly(const std::string& path) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    
+    struct stat info;
+    JournalFormat format{};
+    bool valid = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= kHeaderSize &&
+                 pread(fd, &format, sizeof(format), 0) == static_cast<ssize_t>(sizeof(format)) &&
+                 format.magic == kJournalMagic && format.version == kJournalVersion &&
+                 format.slot_size == sizeof(Slot) && format.capacity > 0 &&
+                 static_cast<size_t>(info.st_size) == kHeaderSize + format.capacity * sizeof(Slot);
+    Header* header = valid ? map(fd, static_cast<size_t>(info.st_size), false) : nullptr;
+    ::close(fd);
+    if (!header) {
+        return false;
+    }
+    capacity_ = format.capacity;
+    header_.store(header, std::memory_order_release);
+    return true;
+}
+
+void ServiceJournal::close() {
+    Header* header = header_.exchange(nullptr, std::memory_order_acq_rel);
+    if (header) {
+        munmap(header, mapped_size_);
+    }
+    slots_ = nullptr;
+    capacity_ = 0;
+    mapped_size_ = 0;
+    writable_ = false;
+}
+
+#else
+
+ServiceJournal::Header* ServiceJournal::map(int fd, size_t size, bool writable) {
+    (void)fd;
+    (void)size;
+    (void)writable;
+    return nullptr;
+}
+
+bool ServiceJournal::open(const std::string& path, size_t capacity) {
+    (void)path;
+    (void)capacity;
+    return false;
+}
+
+bool ServiceJournal::openReadOnly(const std::string& path) {
+    (void)path;
+    return false;
+}
+
+void ServiceJournal::close() {
+}
+
+#endif
+
+void ServiceJournal::append(const JournalEvent& event) {
+    Header* header = header_.load(std::memory_order_acquire);
+    if (!header || !writable_) {
+        return;
+    }
+    
+    JournalPayload payload{};
+    payload.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    payload.type = static_cast<uint32_t>(event.type);
+    payload.pid = event.pid;
+    payload.old_state = static_cast<int32_t>(event.old_state);
+    payload.new_state = static_cast<int32_t>(event.new_state);
+    payload.exit_code = event.exit_code;
+    payload.signal = event.signal;
+    payload.restart_count = event.restart_count;
+    payload.duration_ns = event.duration.count();
+    
+    size_t length = std::min(event.service.size(), kMaxNameLength);
+    if (length < event.service.size()) {
+        // 避免截断在多字节字符中间
+        while (length > 0 && (static_cast<unsigned char>(event.service[length]) & 0xC0) == 0x80) {
+            --length;
+        }
+    }
+    std::memcpy(payload.name, event.service.data(), length);
+    payload.name_length = static_cast<uint32_t>(length);
+    
+    uint64_t buffer[kPayloadWords];
+    std::memcpy(buffer, &payload, sizeof(payload));
+    
+    uint64_t seq = header->next.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[seq % capacity_];
+    uint64_t committed = committedMark(seq);
+    
+    // 只有环形缓冲区整圈绕回、上一圈的写者仍未完成时才会在同一槽位相遇
+    uint64_t current = slot.sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if (current >= committed) {
+            return; // 槽位已被更新的记录占用，本条视为被覆盖
+        }
+        if (current & 1) {
+            std::this_thread::yield();
+            current = slot.sequence.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.sequence.compare_exchange_weak(current, committed - 1, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    for (size_t i = 0; i < kPayloadWords; ++i) {
+        slot.words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(committed, std::memory_order_release);
+}
+
+std::vector<JournalEvent> ServiceJournal::query(const JournalQuery& query) const {
+    std::vector<JournalEvent> events;
+    Header* header = header_.load(std::memory_order_acquire);
+    if (!header) {
+        return events;
+    }
+    
+    uint64_t end = header->next.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+    for (uint64_t seq = begin; seq < end; ++seq) {
+        const Slot& slot = slots_[seq % capacity_];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != committedMark(seq)) {
+            continue; // 尚未写完或已被覆盖
+        }
+        
+        uint64_t buffer[kPayloadWords];
+        for (size_t i = 0; i < kPayloadWords; ++i) {
+            buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        
+        JournalPayload payload;
+        std::memcpy(&payload, buffer, sizeof(payload));
+        std::string service(payload.name, std::min<size_t>(payload.name_length, kMaxNameLength));
+        if (!query.service.empty() && service != query.service) {
+            continue;
+        }
+        
+        auto timestamp = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(payload.timestamp_ns)));
+        if (timestamp < query.since || timestamp >= query.until) {
+            continue;
+        }
+        
+        JournalEvent event;
+        event.sequence = seq;
+        event.timestamp = timestamp;
+        event.type = static_cast<JournalEventType>(payload.type);
+        event.service = std::move(service);
+        event.pid = payload.pid;
+        event.old_state = static_cast<ServiceState>(payload.old_state);
+        event.new_state = static_cast<ServiceState>(payload.new_state);
+        event.exit_code = payload.exit_code;
+        event.signal = payload.signal;
+        event.restart_count = payload.restart_count;
+        event.duration = std::chrono::nanoseconds(payload.duration_ns);
+        events.push_back(std::move(event));
+    }
+    
+    if (query.limit > 0 && events.size() > query.limit) {
+        events.erase(events.begin(), events.end() - static_cast<std::ptrdiff_t>(query.limit));
+    }
+    return events;
+}
+
+} // namespace System
+} // namespace CloudFlow
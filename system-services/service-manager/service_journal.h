@@ -0,0 +1,98 @@
+/**
+ * @file service_journal.h
+ * @brief 服务生命周期事件日志
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 事件写入映射到文件的定长环形缓冲区，进程崩溃后记录仍留在文件中，离线工具以只读方式打开即可查询。
+ * 写入无锁：写者以原子递增分配序号，按序号取模得到槽位，槽位的序列号兼作序列锁；
+ * 读者不阻塞写者，只返回读取期间未被覆盖的完整记录。
+ *
+ * 文件布局：一页文件头，之后为capacity个128字节的槽位，字节序为本机字节序
+ */
+
+#ifndef CLOUDFLOW_SERVICE_JOURNAL_H
+#define CLOUDFLOW_SERVICE_JOURNAL_H
+
+#include "service_manager.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 映射到文件的服务事件日志
+ *
+ * append()可在任意线程并发调用；open()和close()需与其他调用串行化
+ */
+class ServiceJournal {
+public:
+    ServiceJournal();
+    ~ServiceJournal();
+    
+    ServiceJournal(const ServiceJournal&) = delete;
+    ServiceJournal& operator=(const ServiceJournal&) = delete;
+    
+    /**
+     * @brief 打开或创建日志文件
+     *
+     * 已有文件的容量相同时保留其中的记录并接着写入，否则重新初始化
+     * @param path 文件路径
+     * @param capacity 槽位数
+     * @return 成功返回true
+     */
+    bool open(const std::string& path, size_t capacity);
+    
+    /**
+     * @brief 以只读方式打开已有的日志文件，用于离线查询
+     * @param path 文件路径
+     * @return 文件格式有效返回true
+     */
+    bool openReadOnly(const std::string& path);
+    
+    /**
+     * @brief 关闭日志文件
+     */
+    void close();
+    
+    /**
+     * @brief 检查是否已打开
+     * @return 已打开返回true
+     */
+    bool isOpen() const;
+    
+    /**
+     * @brief 追加事件，序号和时间戳由日志填写；未打开或只读时忽略
+     * @param event 事件，服务名超出槽位容量时截断
+     */
+    void append(const JournalEvent& event);
+    
+    /**
+     * @brief 按服务和时间范围查询仍在环形缓冲区中的事件
+     * @param query 查询条件
+     * @return 事件，按序号升序
+     */
+    std::vector<JournalEvent> query(const JournalQuery& query) const;
+
+private:
+    struct Header;
+    struct Slot;
+    
+    Header* map(int fd, size_t size, bool writable);
+    
+    std::atomic<Header*> header_;
+    Slot* slots_;
+    size_t capacity_;
+    size_t mapped_size_;
+    bool writable_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_JOURNAL_H
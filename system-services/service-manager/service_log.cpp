@@ -0,0 +1,341 @@
+/**
+ * @file service_log.cpp
+ * @brief 服务输出日志实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_log.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+// 单次读取的块大小，同时也是tee中转的上限
+constexpr size_t kReadChunkSize = 16 * 1024;
+
+// 单次事件最多处理的字节数，避免一个服务独占监管线程
+constexpr size_t kMaxBytesPerEvent = 256 * 1024;
+
+ServiceLog::ServiceLog(const ServiceLogConfig& config)
+    : config_(config)
+    , ring_(std::max<size_t>(config.buffer_size, 1))
+    , ring_head_(0)
+    , ring_size_(0)
+    , tokens_(static_cast<double>(config.rate_burst))
+    , last_refill_(std::chrono::steady_clock::now())
+    , dropped_bytes_(0)
+    , pending_dropped_(0)
+    , file_fd_(-1)
+    , file_size_(0)
+    , tee_pipe_{-1, -1} {
+}
+
+ServiceLog::~ServiceLog() {
+    closeFile();
+}
+
+void ServiceLog::configure(const ServiceLogConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (config.buffer_size != config_.buffer_size) {
+        // 保留最近的数据
+        std::vector<char> resized(std::max<size_t>(config.buffer_size, 1));
+        size_t keep = std::min(ring_size_, resized.size());
+        size_t start = (ring_head_ + ring_.size() - keep) % ring_.size();
+        for (size_t i = 0; i < keep; ++i) {
+            resized[i] = ring_[(start + i) % ring_.size()];
+        }
+        ring_.swap(resized);
+        ring_size_ = keep;
+        ring_head_ = keep % ring_.size();
+    }
+    
+    if (config.file_path != config_.file_path) {
+        closeFile(); // 下次写入时按新路径打开
+    }
+    
+    config_ = config;
+    tokens_ = std::min(tokens_, static_cast<double>(config_.rate_burst));
+}
+
+bool ServiceLog::consume(int fd) {
+#ifdef _WIN32
+    (void)fd;
+    return false;
+#else
+    char buffer[kReadChunkSize];
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!config_.file_path.empty() && file_fd_ == -1) {
+        openFile();
+    }
+    
+    size_t processed = 0;
+    while (processed < kMaxBytesPerEvent) {
+        size_t allowed = takeTokens(sizeof(buffer));
+        ssize_t count;
+        
+        if (allowed == 0) {
+            // 超出限速：继续排空管道但丢弃数据
+            count = read(fd, buffer, sizeof(buffer));
+            if (count > 0) {
+                dropped_bytes_ += count;
+                pending_dropped_ += count;
+                processed += count;
+                continue;
+            }
+        } else {
+            if (pending_dropped_ > 0) {
+                appendNotice("[日志限流：已丢弃 " + std::to_string(pending_dropped_) + " 字节]\n");
+                pending_dropped_ = 0;
+            }
+            
+            // 先将管道中的数据tee到中转管道再splice进文件，文件写入不经过用户态
+            size_t spliced = file_fd_ != -1 ? spliceToFile(fd, allowed) : 0;
+            count = read(fd, buffer, spliced > 0 ? spliced : allowed);
+            if (count > 0) {
+                if (spliced == 0 && file_fd_ != -1) {
+                    writeToFile(buffer, count);
+                }
+                appendToRing(buffer, count);
+                tokens_ -= count;
+                processed += count;
+                continue;
+            }
+        }
+        
+        if (count == 0) {
+            return false; // 写端已全部关闭
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    
+    return true;
+#endif
+}
+
+std::vector<std::string> ServiceLog::tail(size_t max_lines) const {
+    std::string content;
+    bool wrapped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        content.reserve(ring_size_);
+        size_t start = (ring_head_ + ring_.size() - ring_size_) % ring_.size();
+        for (size_t i = 0; i < ring_size_; ++i) {
+            content.push_back(ring_[(start + i) % ring_.size()]);
+        }
+        wrapped = ring_size_ == ring_.size();
+    }
+    
+    std::vector<std::string> lines;
+    size_t begin = 0;
+    if (wrapped) {
+        // 缓冲区已回绕，第一行可能不完整
+        size_t first_newline = content.find('\n');
+        begin = first_newline == std::string::npos ? content.size() : first_newline + 1;
+    }
+    
+    while (begin < content.size()) {
+        size_t end = content.find('\n', begin);
+        if (end == std::string::npos) {
+            lines.push_back(content.substr(begin));
+            break;
+        }
+        lines.push_back(content.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    
+    if (lines.size() > max_lines) {
+        lines.erase(lines.begin(), lines.end() - max_lines);
+    }
+    return lines;
+}
+
+uint64_t ServiceLog::droppedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_bytes_;
+}
+
+size_t ServiceLog::takeTokens(size_t wanted) {
+    if (config_.rate_limit == 0) {
+        return wanted;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+    last_refill_ = now;
+    tokens_ = std::min(static_cast<double>(config_.rate_burst),
+                       tokens_ + elapsed * static_cast<double>(config_.rate_limit));
+    
+    // 丢弃期间等令牌攒够一整块再恢复，避免限流提示本身刷屏
+    double threshold = pending_dropped_ > 0
+        ? std::min(static_cast<double>(wanted), static_cast<double>(config_.rate_burst))
+        : 1.0;
+    return tokens_ < threshold ? 0 : std::min(wanted, static_cast<size_t>(tokens_));
+}
+
+void ServiceLog::appendToRing(const char* data, size_t length) {
+    if (length >= ring_.size()) {
+        // 只保留末尾能放下的部分
+        data += length - ring_.size();
+        length = ring_.size();
+    }
+    
+    size_t first = std::min(length, ring_.size() - ring_head_);
+    std::copy(data, data + first, ring_.begin() + ring_head_);
+    std::copy(data + first, data + length, ring_.begin());
+    
+    ring_head_ = (ring_head_ + length) % ring_.size();
+    ring_size_ = std::min(ring_size_ + length, ring_.size());
+}
+
+void ServiceLog::appendNotice(const std::string& notice) {
+    tokens_ -= notice.size();
+    appendToRing(notice.data(), notice.size());
+    if (file_fd_ != -1) {
+        writeToFile(notice.data(), notice.size());
+    }
+}
+
+size_t ServiceLog::spliceToFile(int fd, size_t length) {
+#ifdef __linux__
+    if (tee_pipe_[0] == -1) {
+        return 0;
+    }
+    
+    if (file_size_ > 0 && file_size_ + length > config_.max_file_size) {
+        rotateFile();
+        if (file_fd_ == -1) {
+            return 0;
+        }
+    }
+    
+    ssize_t teed = tee(fd, tee_pipe_[1], length, SPLICE_F_NONBLOCK);
+    if (teed <= 0) {
+        if (teed == -1 && errno == EINVAL) {
+            // 不支持tee的管道，退回普通写入
+            close(tee_pipe_[0]);
+            close(tee_pipe_[1]);
+            tee_pipe_[0] = tee_pipe_[1] = -1;
+        }
+        return 0;
+    }
+    
+    size_t remaining = static_cast<size_t>(teed);
+    while (remaining > 0) {
+        ssize_t moved = splice(tee_pipe_[0], nullptr, file_fd_, nullptr, remaining, SPLICE_F_MOVE);
+        if (moved <= 0) {
+            // 文件写入失败，清空中转管道，数据仍会进入环形缓冲区
+            char discard[kReadChunkSize];
+            while (read(tee_pipe_[0], discard, sizeof(discard)) > 0) {
+            }
+            break;
+        }
+        remaining -= moved;
+        file_size_ += moved;
+    }
+    
+    return static_cast<size_t>(teed);
+#else
+    (void)fd;
+    (void)length;
+    return 0;
+#endif
+}
+
+void ServiceLog::writeToFile(const char* data, size_t length) {
+#ifndef _WIN32
+    if (file_size_ > 0 && file_size_ + length > config_.max_file_size) {
+        rotateFile();
+    }
+    if (file_fd_ == -1) {
+        return;
+    }
+    
+    while (length > 0) {
+        ssize_t written = write(file_fd_, data, length);
+        if (written <= 0) {
+            if (written == -1 && errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        length -= written;
+        file_size_ += written;
+    }
+#else
+    (void)data;
+    (void)length;
+#endif
+}
+
+bool ServiceLog::openFile() {
+#ifndef _WIN32
+    // 不使用O_APPEND：splice不支持追加模式的目标文件
+    file_fd_ = open(config_.file_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0640);
+    if (file_fd_ == -1) {
+        return false;
+    }
+    
+    off_t end = lseek(file_fd_, 0, SEEK_END);
+    file_size_ = end > 0 ? static_cast<size_t>(end) : 0;
+
+#ifdef __linux__
+    if (tee_pipe_[0] == -1 && pipe2(tee_pipe_, O_CLOEXEC | O_NONBLOCK) == -1) {
+        tee_pipe_[0] = tee_pipe_[1] = -1;
+    }
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ServiceLog::closeFile() {
+#ifndef _WIN32
+    if (file_fd_ != -1) {
+        close(file_fd_);
+        file_fd_ = -1;
+    }
+    if (tee_pipe_[0] != -1) {
+        close(tee_pipe_[0]);
+        close(tee_pipe_[1]);
+        tee_pipe_[0] = tee_pipe_[1] = -1;
+    }
+    file_size_ = 0;
+#endif
+}
+
+void ServiceLog::rotateFile() {
+    closeFile();
+    
+    // log.(n-1) -> log.n, ..., log -> log.1
+    for (int i = config_.max_files - 1; i >= 1; --i) {
+        std::string from = config_.file_path + "." + std::to_string(i);
+        std::string to = config_.file_path + "." + std::to_string(i + 1);
+        std::rename(from.c_str(), to.c_str());
+    }
+    if (config_.max_files > 0) {
+        std::rename(config_.file_path.c_str(), (config_.file_path + ".1").c_str());
+    } else {
+        std::remove(config_.file_path.c_str());
+    }
+    
+    openFile();
+}
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,95 @@
+/**
+ * @file service_log.h
+ * @brief 服务输出日志
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 将服务的标准输出和标准错误收集到限速的内存环形缓冲区，
+ * 并可选地零拷贝写入可轮转的日志文件
+ */
+
+#ifndef CLOUDFLOW_SERVICE_LOG_H
+#define CLOUDFLOW_SERVICE_LOG_H
+
+#include "service_manager.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 单个服务的输出日志
+ *
+ * consume()由监管线程调用，tail()可在任意线程调用。
+ * 超出限速的输出仍会从管道中读出并丢弃，服务进程不会因管道写满而阻塞。
+ */
+class ServiceLog {
+public:
+    explicit ServiceLog(const ServiceLogConfig& config);
+    ~ServiceLog();
+    
+    ServiceLog(const ServiceLog&) = delete;
+    ServiceLog& operator=(const ServiceLog&) = delete;
+    
+    /**
+     * @brief 更新日志配置
+     * @param config 新配置
+     */
+    void configure(const ServiceLogConfig& config);
+    
+    /**
+     * @brief 从非阻塞管道读取数据
+     * @param fd 管道读端
+     * @return 管道仍然打开返回true，遇到EOF或错误返回false
+     */
+    bool consume(int fd);
+    
+    /**
+     * @brief 获取最近的输出行
+     * @param max_lines 最多返回的行数
+     * @return 输出行列表
+     */
+    std::vector<std::string> tail(size_t max_lines) const;
+    
+    /**
+     * @brief 获取因限速被丢弃的字节总数
+     * @return 字节数
+     */
+    uint64_t droppedBytes() const;
+
+private:
+    size_t takeTokens(size_t wanted);
+    void appendToRing(const char* data, size_t length);
+    void appendNotice(const std::string& notice);
+    size_t spliceToFile(int fd, size_t length);
+    void writeToFile(const char* data, size_t length);
+    bool openFile();
+    void closeFile();
+    void rotateFile();
+    
+    ServiceLogConfig config_;
+    mutable std::mutex mutex_;
+    
+    std::vector<char> ring_;        ///< 环形缓冲区
+    size_t ring_head_;              ///< 下一个写入位置
+    size_t ring_size_;              ///< 有效数据长度
+    
+    double tokens_;                 ///< 令牌桶剩余字节
+    std::chrono::steady_clock::time_point last_refill_;
+    uint64_t dropped_bytes_;        ///< 累计丢弃字节
+    uint64_t pending_dropped_;      ///< 尚未写入提示的丢弃字节
+    
+    int file_fd_;
+    size_t file_size_;
+    int tee_pipe_[2];               ///< 用于tee/splice的中转管道
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_LOG_H
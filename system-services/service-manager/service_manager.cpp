@@ -7,14 +7,47 @@
  */
 
 #include "service_manager.h"
+#include "service_admission.h"
+#include "service_control_server.h"
+#include "service_fdstore.h"
+#include "service_history.h"
+#include "service_instances.h"
+#include "service_jobs.h"
+#include "service_journal.h"
+#include "service_log.h"
+#include "service_metrics.h"
+#include "service_pressure.h"
+#include "service_process_tree.h"
+#include "service_standby.h"
+#include "service_subscriptions.h"
+#include "service_registry.h"
+#include "service_supervisor.h"
+#include "service_timing.h"
+#include "service_watchdog.h"
+#include "service_zygote.h"
 #include "../../platform_compat.h"
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <chrono>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#endif
 // 简单的配置解析函数
 #include <sstream>
 #include <map>
+#include <set>
 
 // 简单的键值对配置解析
 std::map<std::string, std::string> parseSimpleConfig(const std::string& content) {
@@ -34,41 +67,540 @@ std::map<std::string, std::string> parseSimpleConfig(const std::string& content)
     return config;
 }
 
+// 解析状态文件：每个"[名称]"开始一节，节内为键值对
+std::vector<std::pair<std::string, std::map<std::string, std::string>>> parseStateSections(const std::string& content) {
+    std::vector<std::pair<std::string, std::map<std::string, std::string>>> sections;
+    std::istringstream stream(content);
+    std::string line;
+    
+    while (std::getline(stream, line)) {
+        if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
+            sections.emplace_back(line.substr(1, line.size() - 2), std::map<std::string, std::string>());
+            continue;
+        }
+        
+        size_t pos = line.find('=');
+        if (pos != std::string::npos && !sections.empty()) {
+            sections.back().second[line.substr(0, pos)] = line.substr(pos + 1);
+        }
+    }
+    
+    return sections;
+}
+
+int stateInt(const std::map<std::string, std::string>& values, const std::string& key, int fallback) {
+    auto it = values.find(key);
+    if (it == values.end() || it->second.empty()) {
+        return fallback;
+    }
+    return static_cast<int>(std::strtol(it->second.c_str(), nullptr, 10));
+}
+
 namespace CloudFlow {
 namespace System {
 
+// 发布状态中错误信息的最大字节数
+constexpr size_t kMaxPublishedErrorLength = 192;
+
+// 并行停止的服务数上限；停止只是等待进程退出，不按CPU数限制
+constexpr size_t kMaxConcurrentStops = 64;
+
+/**
+ * @brief 通过序列锁发布的服务状态
+ *
+ * ServiceStatus含有std::string，无法直接用序列锁发布，
+ * 这里将其展开为可平凡拷贝的布局，错误信息按UTF-8字符边界截断
+ */
+struct PublishedStatus {
+    ServiceState state;
+    int pid;
+    int64_t start_time;
+    int64_t last_activity;
+    int restart_count;
+    int memory_usage;
+    double cpu_usage;
+    ServiceIoStats io;
+    uint32_t error_length;
+    char last_error[kMaxPublishedErrorLength];
+    
+    static PublishedStatus fromStatus(const ServiceStatus& status) {
+        // 连同填充字节一起清零，发布的字节内容只取决于状态，可以逐字节比较
+        PublishedStatus published;
+        std::memset(&published, 0, sizeof(published));
+        published.state = status.state;
+        published.pid = status.pid;
+        published.start_time = status.start_time.time_since_epoch().count();
+        published.last_activity = status.last_activity.time_since_epoch().count();
+        published.restart_count = status.restart_count;
+        published.memory_usage = status.memory_usage;
+        published.cpu_usage = status.cpu_usage;
+        published.io = status.io;
+        
+        size_t length = std::min(status.last_error.size(), kMaxPublishedErrorLength);
+        if (length < status.last_error.size()) {
+            // 避免截断在多字节字符中间
+            while (length > 0 && (static_cast<unsigned char>(status.last_error[length]) & 0xC0) == 0x80) {
+                --length;
+            }
+        }
+        std::memcpy(published.last_error, status.last_error.data(), length);
+        published.error_length = static_cast<uint32_t>(length);
+        return published;
+    }
+    
+    // 状态、进程ID、重启次数或错误信息不同；资源统计不参与比较
+    bool differsFrom(const PublishedStatus& other) const {
+        return state != other.state || pid != other.pid || restart_count != other.restart_count ||
+               error_length != other.error_length || std::memcmp(last_error, other.last_error, error_length) != 0;
+    }
+    
+    ServiceStatus toStatus() const {
+        using Clock = std::chrono::system_clock;
+        return ServiceStatus{
+            state, pid,
+            Clock::time_point(Clock::duration(start_time)),
+            Clock::time_point(Clock::duration(last_activity)),
+            restart_count,
+            std::string(last_error, error_length),
+            memory_usage, cpu_usage, io
+        };
+    }
+};
+
+// 待通知的状态变化，时刻在状态改变时记录，回调稍后在不持有op_mutex_时触发
+struct PendingTransition {
+    ServiceState old_state;
+    ServiceState new_state;
+    std::chrono::system_clock::time_point timestamp;
+};
+
+/**
+ * @brief 管理器交接时保存的服务进程状态
+ *
+ * 描述符编号在保存时指向交接存储中的副本，恢复时为新管理器继承或重新打开的描述符
+ */
+struct ProcessHandoff {
+    int pid = -1;
+    unsigned long long start_ticks = 0; ///< 进程启动时刻，与PID一起标识进程
+    std::chrono::system_clock::time_point start_time;
+    int restart_count = 0;
+    bool paused = false;
+    int pidfd = -1;
+    int output_fd = -1;
+    int heartbeat_fd = -1;
+    
+    void closeDescriptors() const {
+        #ifndef _WIN32
+            for (int fd : {pidfd, output_fd, heartbeat_fd}) {
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+        #endif
+    }
+};
+
 // 服务类实现
-class Service {
+//
+// 线程模型：op_mutex_串行化启动、停止和监控线程对进程的操作，
+// 每次修改status_后通过publishStatus()发布到序列锁单元，
+// 读取方（getStatus/getState）不获取op_mutex_，getStatus与发布重叠时重试。回调在释放op_mutex_后触发。
+class Service : public std::enable_shared_from_this<Service> {
 public:
-    Service(const ServiceConfig& config) 
-        : config_(config)
-        , status_{ServiceState::Stopped, -1, {}, {}, 0, "", 0, 0.0}
-        , monitoring_thread_running_(false) {
+    Service(const ServiceConfig& config)
+        : Service(config, std::make_shared<ServiceLog>(config.log)) {
+    }
+    
+    // 待命实例与主实例共用日志
+    Service(const ServiceConfig& config, std::shared_ptr<ServiceLog> log)
+        : config_(std::make_shared<const ServiceConfig>(config))
+        , log_(std::move(log))
+        , supervisor_(nullptr)
+        , watchdog_(nullptr)
+        , process_tree_(nullptr)
+        , journal_(nullptr)
+        , generation_(nullptr)
+        , watchdog_id_(0)
+        , status_{ServiceState::Stopped, -1, {}, {}, 0, "", 0, 0.0, {}}
+        , timing_{}
+        , start_request_pending_(false)
+        , last_usage_{}
+        , published_state_(ServiceState::Stopped)
+        , metrics_(nullptr)
+        , monitoring_thread_running_(false)
+        , monitoring_generation_(0)
+        , watchdog_expired_(false)
+        , paused_(false)
+        , pidfd_(-1)
+        , output_fd_(-1)
+        , start_ticks_(0)
+        , standby_role_(false)
+        , standby_channel_(-1)
+        , listener_(-1)
+        , exit_watch_id_(0)
+        , process_exited_(false)
+        , exit_status_(-1) {
+        published_status_.store(PublishedStatus::fromStatus(status_));
     }
     
     ~Service() {
         stopMonitoring();
+        stopStandby();
+        std::lock_guard<std::mutex> lock(op_mutex_);
         if (status_.state == ServiceState::Running || status_.state == ServiceState::Starting) {
-            stop();
+            stopLocked();
         }
+        releaseProcessHandles();
+        closeListener();
     }
     
     bool start() {
-        if (status_.state == ServiceState::Running || status_.state == ServiceState::Starting) {
-            return true; // 已经在运行或启动中
+        bool started;
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            started = startLocked();
         }
+        flushNotifications();
+        
+        if (started) {
+            startMonitoring();
+        }
+        return started;
+    }
+    
+    bool stop() {
+        // 先停止监控线程，避免其在停止过程中触发自动重启
+        stopMonitoring();
         
-        // 检查依赖服务
-        if (!checkDependencies()) {
-            status_.last_error = "依赖服务未就绪";
-            status_.state = ServiceState::Failed;
+        bool stopped;
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            stopped = stopLocked();
+        }
+        flushNotifications();
+        stopStandby();
+        return stopped;
+    }
+    
+    // 将运行中进程的身份和描述符存入交接存储，描述符编号写入返回值
+    ProcessHandoff exportHandoff(ServiceFdStore& store, const std::string& name) {
+        ProcessHandoff handoff;
+        std::lock_guard<std::mutex> lock(op_mutex_);
+        if (status_.state != ServiceState::Running || status_.pid == -1 || start_ticks_ == 0) {
+            return handoff;
+        }
+        
+        handoff.pid = status_.pid;
+        handoff.start_ticks = start_ticks_;
+        handoff.start_time = status_.start_time;
+        handoff.restart_count = status_.restart_count;
+        handoff.paused = paused_;
+        if (pidfd_ != -1) {
+            handoff.pidfd = store.put(name + "/pidfd", pidfd_);
+        }
+        if (output_fd_ != -1) {
+            handoff.output_fd = store.put(name + "/output", output_fd_);
+        }
+        if (heartbeat_) {
+            handoff.heartbeat_fd = store.put(name + "/heartbeat", heartbeat_->fd());
+        }
+        return handoff;
+    }
+    
+    // 接管已校验身份的进程，handoff中的描述符所有权转移给服务
+    bool adopt(const ProcessHandoff& handoff) {
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            if (status_.state == ServiceState::Running || status_.state == ServiceState::Starting) {
+                handoff.closeDescriptors();
+                return false;
+            }
+            
+            installProcess(handoff, true);
+        }
+        flushNotifications();
+        startMonitoring();
+        return true;
+    }
+    
+    // 由主实例在待命实例上调用：通知待命进程接替，并把进程连同描述符交给调用方
+    bool promote(int listen_fd, ProcessHandoff& handoff) {
+        if (getState() != ServiceState::Running) {
+            return false;
+        }
+        
+        // 先停止监控线程，交出的进程不能再被当作本实例的进程重启
+        stopMonitoring();
+        
+        bool promoted = false;
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            if (status_.state == ServiceState::Running && standby_channel_ != -1 && checkProcessAlive() &&
+                StandbyRuntime::promote(standby_channel_, listen_fd)) {
+                handoff.pid = status_.pid;
+                handoff.start_ticks = start_ticks_;
+                handoff.start_time = status_.start_time;
+                handoff.pidfd = pidfd_;
+                handoff.output_fd = output_fd_;
+                pidfd_ = -1;
+                output_fd_ = -1;
+                #ifndef _WIN32
+                    if (heartbeat_) {
+                        handoff.heartbeat_fd = fcntl(heartbeat_->fd(), F_DUPFD_CLOEXEC, 3);
+                    }
+                #endif
+                disarmWatchdog();
+                
+                status_.pid = -1;
+                status_.state = ServiceState::Stopped;
+                releaseProcessHandles();
+                if (process_tree_) {
+                    process_tree_->release(processTreeUnit());
+                }
+                publishStatus();
+                promoted = true;
+            }
+        }
+        
+        if (!promoted) {
+            startMonitoring();
+        }
+        return promoted;
+    }
+    
+    // 以SIGSTOP暂停运行中的服务进程，用于压力卸载
+    bool pause() {
+        std::lock_guard<std::mutex> lock(op_mutex_);
+        if (status_.state != ServiceState::Running || status_.pid == -1) {
             return false;
         }
+        if (paused_) {
+            return true;
+        }
+        
+        #ifdef _WIN32
+            return false; // 当前平台不支持
+        #else
+            if (signalProcess(status_.pid, pidfd_, SIGSTOP) == -1) {
+                return false;
+            }
+            if (watchdog_id_ != 0) {
+                watchdog_->setSuspended(watchdog_id_, true);
+            }
+            paused_ = true;
+            return true;
+        #endif
+    }
+    
+    bool resume() {
+        std::lock_guard<std::mutex> lock(op_mutex_);
+        if (!paused_) {
+            return true;
+        }
+        
+        #ifndef _WIN32
+            if (status_.pid != -1 && signalProcess(status_.pid, pidfd_, SIGCONT) == -1 && errno != ESRCH) {
+                return false;
+            }
+        #endif
+        if (watchdog_id_ != 0) {
+            watchdog_->setSuspended(watchdog_id_, false);
+        }
+        paused_ = false;
+        return true;
+    }
+    
+    bool isPaused() const {
+        return paused_.load(std::memory_order_acquire);
+    }
+    
+    ServiceState getState() const {
+        return published_state_.load(std::memory_order_acquire);
+    }
+    
+    ServiceStatus getStatus() const {
+        return published_status_.load().toStatus();
+    }
+    
+    ServiceConfig getConfig() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return *config_;
+    }
+    
+    // 与快照共享的不可变配置，修改配置时整体替换
+    std::shared_ptr<const ServiceConfig> getSharedConfig() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return config_;
+    }
+    
+    void setConfig(const ServiceConfig& config) {
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            config_ = std::make_shared<const ServiceConfig>(config);
+            log_->configure(config.log);
+        }
+        bumpGeneration();
+    }
+    
+    std::shared_ptr<ServiceLog> getLog() const {
+        return log_;
+    }
+    
+    void setSupervisor(ServiceSupervisor* supervisor) {
+        supervisor_ = supervisor;
+    }
+    
+    void setWatchdog(ServiceWatchdog* watchdog) {
+        watchdog_ = watchdog;
+    }
+    
+    void setProcessTree(ServiceProcessTree* process_tree) {
+        process_tree_ = process_tree;
+    }
+    
+    void setJournal(ServiceJournal* journal) {
+        journal_ = journal;
+    }
+    
+    // 管理器的快照代数，状态、进程ID、重启次数、错误信息或配置变化时递增
+    void setGeneration(std::atomic<uint64_t>* generation) {
+        generation_ = generation;
+    }
+    
+    // 更新I/O限制，服务运行时立即写入其cgroup
+    bool setIoLimits(const std::vector<ServiceIoLimit>& limits) {
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            auto config = std::make_shared<ServiceConfig>(*config_);
+            config->io_limits = limits;
+            config_ = std::move(config);
+        }
+        bumpGeneration();
+        
+        bool applied = true;
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            if (status_.pid != -1) {
+                applied = applyIoLimits(limits);
+            }
+        }
+        flushNotifications();
+        
+        std::shared_ptr<Service> standby;
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            standby = standby_;
+        }
+        if (standby) {
+            standby->setIoLimits(limits);
+        }
+        return applied;
+    }
+    
+    // 服务进程树中仍在运行的全部进程，主进程在前
+    std::vector<int> getProcesses() {
+        std::lock_guard<std::mutex> lock(op_mutex_);
+        if (status_.pid == -1) {
+            return {};
+        }
+        if (!process_tree_) {
+            return {status_.pid};
+        }
+        return process_tree_->members(processTreeUnit());
+    }
+    
+    // 按名称查找运行中zygote的连接，由管理器在注册服务时设置
+    void setZygoteLookup(std::function<std::shared_ptr<ZygoteClient>(const std::string&)> lookup) {
+        zygote_lookup_ = std::move(lookup);
+    }
+    
+    // 本服务作为zygote运行时的连接，未运行时为空
+    std::shared_ptr<ZygoteClient> getZygoteClient() {
+        std::lock_guard<std::mutex> lock(zygote_mutex_);
+        return zygote_client_;
+    }
+    
+    void setMetricsSlot(ServiceMetricsSlot* slot) {
+        metrics_.store(slot, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(op_mutex_);
+        publishStatus();
+    }
+    
+    ServiceMetricsSlot* detachMetricsSlot() {
+        return metrics_.exchange(nullptr, std::memory_order_acq_rel);
+    }
+    
+    // 由管理器在启动前调用，记录请求时间和依赖就绪时间；未调用时以实际启动时刻为准
+    void markStartRequested(std::chrono::steady_clock::time_point requested,
+                            std::chrono::steady_clock::time_point dependencies_ready) {
+        ServiceState state = getState();
+        if (state == ServiceState::Running || state == ServiceState::Starting) {
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(timing_mutex_);
+        timing_ = ServiceStartupTiming{};
+        timing_.requested = requested;
+        timing_.dependencies_ready = dependencies_ready;
+        start_request_pending_ = true;
+    }
+    
+    ServiceStartupTiming getStartupTiming() const {
+        ServiceStartupTiming timing;
+        {
+            std::lock_guard<std::mutex> lock(timing_mutex_);
+            timing = timing_;
+        }
+        
+        ServiceConfig config = getConfig();
+        timing.name = config.name;
+        timing.dependencies = config.dependencies;
+        return timing;
+    }
+    
+    void setAutoStart(bool auto_start) {
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            auto config = std::make_shared<ServiceConfig>(*config_);
+            config->auto_start = auto_start;
+            config_ = std::move(config);
+        }
+        bumpGeneration();
+    }
+    
+    void updateStatus(const ServiceStatus& status) {
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            status_ = status;
+            publishStatus();
+        }
+        flushNotifications();
+    }
+    
+    void setStatusChangeCallback(std::function<void(ServiceState, ServiceState, std::chrono::system_clock::time_point)> callback) {
+        status_change_callback_ = std::move(callback);
+    }
+    
+    void setErrorCallback(std::function<void(const std::string&)> callback) {
+        error_callback_ = std::move(callback);
+    }
+
+private:
+    // 以下*Locked方法要求调用方持有op_mutex_
+    bool startLocked() {
+        if (status_.state == ServiceState::Running || status_.state == ServiceState::Starting) {
+            return true; // 已经在运行或启动中
+        }
+        
+        // 依赖服务由管理器的作业引擎在启动本服务之前拉起
+        ServiceConfig config = getConfig();
         
         // 设置服务状态为启动中
         status_.state = ServiceState::Starting;
         status_.start_time = std::chrono::system_clock::now();
         status_.last_error.clear();
+        publishStatus();
+        beginStartTiming();
         
         // Windows平台使用CreateProcess启动服务
         #ifdef _WIN32
@@ -80,8 +612,8 @@ public:
             ZeroMemory(&pi, sizeof(pi));
             
             // 构建命令行
-            std::string cmd_line = config_.executable_path;
-            for (const auto& arg : config_.args) {
+            std::string cmd_line = config.executable_path;
+            for (const auto& arg : config.args) {
                 cmd_line += " ";
                 cmd_line += arg;
             }
@@ -92,326 +624,1285 @@ public:
             if (!CreateProcess(NULL, cmd_line_str, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
                 status_.last_error = "创建进程失败";
                 status_.state = ServiceState::Failed;
+                publishStatus();
                 return false;
             }
             
             status_.pid = pi.dwProcessId;
             CloseHandle(pi.hThread);
             CloseHandle(pi.hProcess);
-            
+        
         #else
-            // Linux平台使用fork和exec
-            pid_t pid = fork();
+            // 在fork之前准备参数，子进程中只做exec前的最小操作
+            std::vector<const char*> args;
+            args.push_back(config.executable_path.c_str());
+            for (const auto& arg : config.args) {
+                args.push_back(arg.c_str());
+            }
+            args.push_back(nullptr);
+            
+            // CPU亲和性在fork之前构造，子进程只需一次系统调用
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            bool pin_cpus = false;
+            for (int cpu : config.cpu_affinity) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                    CPU_SET(cpu, &cpu_set);
+                    pin_cpus = true;
+                }
+            }
+            
+            // 每次启动创建新的监听套接字，与同端口的其他实例组成SO_REUSEPORT组；
+            // 配置了待命实例时监听套接字由服务持有，主进程退出期间到达的连接留在队列中由接替的进程接受。
+            // 待命进程在提升时才得到监听套接字
+            int listen_fd = -1;
+            if (config.instances.listen_port > 0 && !standby_role_) {
+                if (!config.warm_standby) {
+                    listen_fd = openReusePortListener(config.instances.listen_address, config.instances.listen_port);
+                } else {
+                    if (listener_ == -1) {
+                        listener_ = openReusePortListener(config.instances.listen_address, config.instances.listen_port);
+                    }
+                    listen_fd = listener_ == -1 ? -1 : fcntl(listener_, F_DUPFD_CLOEXEC, 3);
+                }
+                if (listen_fd == -1) {
+                    status_.last_error = std::string("创建监听套接字失败: ") + std::strerror(errno);
+                    status_.state = ServiceState::Failed;
+                    publishStatus();
+                    return false;
+                }
+            }
+            
+            // 看门狗心跳页同样在fork之前创建
+            std::shared_ptr<HeartbeatRegion> heartbeat;
+            if (config.watchdog_timeout > 0 && watchdog_) {
+                heartbeat = HeartbeatRegion::create(config.name);
+                if (!heartbeat) {
+                    if (listen_fd != -1) {
+                        close(listen_fd);
+                    }
+                    status_.last_error = "创建心跳页失败";
+                    status_.state = ServiceState::Failed;
+                    publishStatus();
+                    return false;
+                }
+            }
+            int heartbeat_fd = heartbeat ? heartbeat->fd() : -1;
+            
+            // 没有交接套接字的待命进程会作为第二个主实例运行，不能启动
+            int standby_fds[2] = {-1, -1};
+            if (standby_role_ && !StandbyRuntime::createChannel(standby_fds[0], standby_fds[1])) {
+                status_.last_error = std::string("创建交接套接字失败: ") + std::strerror(errno);
+                status_.state = ServiceState::Failed;
+                publishStatus();
+                return false;
+            }
+            
+            // 标准输出和标准错误共用一个管道，保持两者的相对顺序
+            int output_pipe[2] = {-1, -1};
+            bool capture_output = config.log.capture_output && supervisor_ && supervisor_->isRunning();
+            if (capture_output && pipe2(output_pipe, O_CLOEXEC) == -1) {
+                capture_output = false;
+            }
+            
+            // zygote的控制套接字，子进程一端在exec前复制到3之后并写入环境变量
+            int zygote_fds[2] = {-1, -1};
+            if (config.zygote && !ZygoteRuntime::createChannel(zygote_fds[0], zygote_fds[1])) {
+                zygote_fds[0] = zygote_fds[1] = -1;
+            }
+            
+            // 子进程在exec之前加入服务的cgroup，之后fork出的进程都留在其中；
+            // 环境变量由后代继承，用于归属过继给管理器的孤儿进程
+            std::string tree_unit = processTreeUnit();
+            int cgroup_fd = process_tree_ ? process_tree_->prepareSpawn(tree_unit) : -1;
+            
+            // I/O限制在exec之前写入cgroup；无法生效时只报告错误，不阻止启动
+            applyIoLimits(config.io_limits);
+            
+            releaseProcessHandles();
+            recordTiming(&ServiceStartupTiming::spawned);
+            
+            // 优先由zygote fork，省去exec和运行时初始化
+            int exec_pipe[2] = {-1, -1};
+            bool track_exec = false;
+            std::shared_lock<std::shared_mutex> spawn_lock(ServiceFdStore::spawnMutex(), std::defer_lock);
+            pid_t pid = spawnFromZygote(config, listen_fd, heartbeat_fd, capture_output ? output_pipe[1] : -1);
             if (pid == -1) {
+                // exec成功时CLOEXEC管道被关闭，父进程据此得到exec完成时刻和失败原因
+                track_exec = pipe2(exec_pipe, O_CLOEXEC) == 0;
+                
+                // Linux平台使用fork和exec
+                spawn_lock.lock();
+                pid = fork();
+                if (pid != 0) {
+                    spawn_lock.unlock();
+                }
+            }
+            if (pid == -1) {
+                for (int fd : {zygote_fds[0], zygote_fds[1], standby_fds[0], standby_fds[1], cgroup_fd}) {
+                    if (fd != -1) {
+                        close(fd);
+                    }
+                }
+                if (capture_output) {
+                    close(output_pipe[0]);
+                    close(output_pipe[1]);
+                }
+                if (track_exec) {
+                    close(exec_pipe[0]);
+                    close(exec_pipe[1]);
+                }
+                if (listen_fd != -1) {
+                    close(listen_fd);
+                }
                 status_.last_error = "创建进程失败";
                 status_.state = ServiceState::Failed;
+                publishStatus();
                 return false;
             }
             
             if (pid == 0) { // 子进程
+                if (cgroup_fd != -1) {
+                    ssize_t written = write(cgroup_fd, "0", 1);
+                    (void)written;
+                }
+                if (process_tree_) {
+                    setenv(kServiceUnitEnv, tree_unit.c_str(), 1);
+                }
+                
+                // 重定向输出到捕获管道
+                if (capture_output) {
+                    dup2(output_pipe[1], STDOUT_FILENO);
+                    dup2(output_pipe[1], STDERR_FILENO);
+                }
+                
+                if (pin_cpus) {
+                    sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+                }
+                
+                // 内存不足时优先回收低优先级服务，保护关键服务；降低分值需要特权，失败时忽略
+                int oom_score_adj = oomScoreAdjustment(config.priority);
+                if (oom_score_adj != 0) {
+                    int oom_fd = open("/proc/self/oom_score_adj", O_WRONLY | O_CLOEXEC);
+                    if (oom_fd != -1) {
+                        std::string value = std::to_string(oom_score_adj);
+                        ssize_t written = write(oom_fd, value.c_str(), value.size());
+                        (void)written;
+                        close(oom_fd);
+                    }
+                }
+                
+                // 心跳页描述符复制到3之后，避免被监听套接字覆盖
+                if (heartbeat_fd != -1) {
+                    int inherited = fcntl(heartbeat_fd, F_DUPFD, 4);
+                    if (inherited != -1) {
+                        setenv(kHeartbeatFdEnv, std::to_string(inherited).c_str(), 1);
+                    }
+                }
+                
+                if (zygote_fds[1] != -1) {
+                    int inherited = fcntl(zygote_fds[1], F_DUPFD, 4);
+                    if (inherited != -1) {
+                        setenv(kZygoteFdEnv, std::to_string(inherited).c_str(), 1);
+                    }
+                }
+                
+                if (standby_fds[1] != -1) {
+                    int inherited = fcntl(standby_fds[1], F_DUPFD, 4);
+                    if (inherited == -1) {
+                        _exit(EXIT_FAILURE);
+                    }
+                    setenv(kStandbyFdEnv, std::to_string(inherited).c_str(), 1);
+                }
+                
+                // 按socket激活约定以fd 3传递监听套接字
+                if (listen_fd != -1) {
+                    if (track_exec && exec_pipe[1] == 3) {
+                        exec_pipe[1] = fcntl(exec_pipe[1], F_DUPFD_CLOEXEC, 4);
+                    }
+                    if (listen_fd == 3) {
+                        fcntl(listen_fd, F_SETFD, 0);
+                    } else {
+                        dup2(listen_fd, 3);
+                    }
+                    setenv("LISTEN_FDS", "1", 1);
+                    setenv("LISTEN_PID", std::to_string(getpid()).c_str(), 1);
+                }
+                
                 // 设置工作目录
-                if (!config_.working_directory.empty()) {
-                    if (chdir(config_.working_directory.c_str()) == -1) {
-                        exit(EXIT_FAILURE);
+                if (!config.working_directory.empty()) {
+                    if (chdir(config.working_directory.c_str()) == -1) {
+                        if (track_exec) {
+                            int error = errno;
+                            ssize_t written = write(exec_pipe[1], &error, sizeof(error));
+                            (void)written;
+                        }
+                        _exit(EXIT_FAILURE);
                     }
                 }
                 
                 // 设置环境变量
-                for (const auto& env : config_.environment) {
+                for (const auto& env : config.environment) {
                     setenv(env.first.c_str(), env.second.c_str(), 1);
                 }
                 
-                // 准备参数
-                std::vector<const char*> args;
-                args.push_back(config_.executable_path.c_str());
-                for (const auto& arg : config_.args) {
-                    args.push_back(arg.c_str());
-                }
-                args.push_back(nullptr);
-                
                 // 执行程序
-                execvp(config_.executable_path.c_str(), const_cast<char* const*>(args.data()));
+                execvp(config.executable_path.c_str(), const_cast<char* const*>(args.data()));
                 
                 // 如果执行失败
-                exit(EXIT_FAILURE);
+                if (track_exec) {
+                    int error = errno;
+                    ssize_t written = write(exec_pipe[1], &error, sizeof(error));
+                    (void)written;
+                }
+                _exit(EXIT_FAILURE);
             } else { // 父进程
                 status_.pid = pid;
+                paused_ = false;
+                if (pidfd_ == -1) {
+                    pidfd_ = openPidfd(pid);
+                }
+                start_ticks_ = readProcessStartTicks(pid);
+                watchProcessExit();
+                
+                if (cgroup_fd != -1) {
+                    close(cgroup_fd);
+                }
+                if (process_tree_) {
+                    process_tree_->track(tree_unit, pid);
+                }
+                
+                if (listen_fd != -1) {
+                    close(listen_fd);
+                }
+                
+                if (zygote_fds[0] != -1) {
+                    close(zygote_fds[1]);
+                    std::lock_guard<std::mutex> lock(zygote_mutex_);
+                    zygote_client_ = std::make_shared<ZygoteClient>(zygote_fds[0]);
+                }
+                
+                if (standby_fds[0] != -1) {
+                    close(standby_fds[1]);
+                    standby_channel_ = standby_fds[0];
+                }
+                
+                if (capture_output) {
+                    close(output_pipe[1]);
+                    attachOutput(output_pipe[0]);
+                }
+                
+                if (track_exec && !waitForExec(exec_pipe)) {
+                    return false;
+                }
             }
         #endif
         
         status_.last_activity = status_.start_time;
         status_.restart_count++;
+        publishStatus();
         
-        // 等待进程启动
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // 配置了看门狗的服务以第一次心跳作为就绪信号；其他服务没有就绪信号，
+        // 启动后等待100毫秒仍在运行即视为就绪，时间线中的就绪时刻因此包含这段固定等待
+        #ifndef _WIN32
+            if (heartbeat && !standby_role_) {
+                if (!waitForFirstHeartbeat(*heartbeat, config.watchdog_timeout) && checkProcessAlive()) {
+                    stopLocked();
+                    status_.last_error = "未在看门狗超时内发出第一次心跳";
+                    status_.state = ServiceState::Failed;
+                    publishStatus();
+                    return false;
+                }
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        #else
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        #endif
         
         // 检查进程是否还在运行
-        #ifdef _WIN32
-            HANDLE process = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, status_.pid);
-            if (process != NULL) {
-                DWORD exit_code;
-                if (GetExitCodeProcess(process, &exit_code) && exit_code == STILL_ACTIVE) {
-                    status_.state = ServiceState::Running;
-                    startMonitoring();
-                    CloseHandle(process);
-                    return true;
+        if (checkProcessAlive()) {
+            status_.state = ServiceState::Running;
+            publishStatus();
+            recordTiming(&ServiceStartupTiming::ready);
+            
+            #ifndef _WIN32
+                // 待命进程在提升之前不发送心跳，提升后由主实例登记看门狗
+                if (heartbeat && standby_role_) {
+                    heartbeat_ = std::move(heartbeat);
+                } else if (heartbeat) {
+                    armWatchdog(std::move(heartbeat), config.watchdog_timeout);
                 }
+            #endif
+            return true;
+        }
+        
+        recordExit();
+        status_.pid = -1;
+        status_.last_error = "进程启动后立即退出";
+        status_.state = ServiceState::Failed;
+        publishStatus();
+        return false;
+    }
+    
+    bool stopLocked() {
+        if (status_.state == ServiceState::Stopped || status_.state == ServiceState::Stopping) {
+            return true; // 已经停止或正在停止
+        }
+        
+        disarmWatchdog();
+        
+        if (status_.pid == -1) {
+            status_.state = ServiceState::Stopped;
+            publishStatus();
+            return true;
+        }
+        
+        int shutdown_timeout = getConfig().shutdown_timeout;
+        
+        status_.state = ServiceState::Stopping;
+        publishStatus();
+        
+        #ifdef _WIN32
+            // Windows平台终止进程
+            HANDLE process = OpenProcess(PROCESS_TERMINATE, FALSE, status_.pid);
+            if (process == NULL) {
+                status_.last_error = "打开进程句柄失败";
+                status_.state = ServiceState::Failed;
+                publishStatus();
+                return false;
+            }
+            
+            if (!TerminateProcess(process, 0)) {
+                status_.last_error = "终止进程失败";
+                status_.state = ServiceState::Failed;
+                publishStatus();
                 CloseHandle(process);
+                return false;
+            }
+            
+            WaitForSingleObject(process, shutdown_timeout);
+            CloseHandle(process);
+        
+        #else
+            // Linux平台发送停止信号，主进程fork出的进程一并停止
+            std::string tree_unit = processTreeUnit();
+            if (signalProcess(status_.pid, pidfd_, SIGTERM) == -1 && errno != ESRCH) {
+                status_.last_error = "发送停止信号失败";
+                status_.state = ServiceState::Failed;
+                publishStatus();
+                return false;
+            }
+            if (process_tree_) {
+                process_tree_->signal(tree_unit, SIGTERM);
+            }
+            
+            // 被暂停的进程要先继续运行才能处理SIGTERM
+            if (paused_) {
+                signalProcess(status_.pid, pidfd_, SIGCONT);
+                if (process_tree_) {
+                    process_tree_->signal(tree_unit, SIGCONT);
+                }
+                paused_ = false;
+            }
+            
+            // 等待进程退出，超过停止超时仍在运行时强制终止
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(shutdown_timeout);
+            if (!waitProcessExit(deadline)) {
+                if (signalProcess(status_.pid, pidfd_, SIGKILL) == -1 && errno != ESRCH) {
+                    status_.last_error = "强制终止进程失败";
+                    status_.state = ServiceState::Failed;
+                    publishStatus();
+                    return false;
+                }
+                
+                waitForExit();
+            }
+            
+            if (process_tree_) {
+                stopProcessTree(tree_unit);
+            }
+        #endif
+        
+        recordExit();
+        status_.state = ServiceState::Stopped;
+        status_.pid = -1;
+        releaseProcessHandles();
+        closeListener();
+        publishStatus();
+        
+        return true;
+    }
+    
+    // 等待子进程exec，失败时回收子进程并记录错误
+    bool waitForExec(int exec_pipe[2]) {
+        #ifndef _WIN32
+            close(exec_pipe[1]);
+            
+            int exec_errno = 0;
+            ssize_t count;
+            do {
+                count = read(exec_pipe[0], &exec_errno, sizeof(exec_errno));
+            } while (count == -1 && errno == EINTR);
+            close(exec_pipe[0]);
+            
+            if (count == static_cast<ssize_t>(sizeof(exec_errno))) {
+                waitpid(status_.pid, nullptr, 0);
+                status_.pid = -1;
+                status_.last_error = std::string("执行程序失败: ") + std::strerror(exec_errno);
+                status_.state = ServiceState::Failed;
+                publishStatus();
+                return false;
+            }
+            
+            recordTiming(&ServiceStartupTiming::executed);
+        #else
+            (void)exec_pipe;
+        #endif
+        return true;
+    }
+    
+    // 开始新一轮启动计时；自动重启等未经管理器请求的启动以当前时刻为请求时间
+    void beginStartTiming() {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(timing_mutex_);
+        if (!start_request_pending_) {
+            timing_ = ServiceStartupTiming{};
+            timing_.requested = now;
+            timing_.dependencies_ready = now;
+        }
+        start_request_pending_ = false;
+    }
+    
+    void recordTiming(std::chrono::steady_clock::time_point ServiceStartupTiming::* phase) {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(timing_mutex_);
+        timing_.*phase = now;
+        if (phase == &ServiceStartupTiming::ready) {
+            timing_.completed = true;
+        }
+    }
+    
+    // 将输出管道读端交给监管事件循环，管道由事件循环持有并在EOF时关闭
+    void attachOutput(int fd) {
+        #ifndef _WIN32
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            
+            // 保留一份读端，管理器交接时传给新的管理器，读端不关闭服务写输出就不会收到SIGPIPE
+            output_fd_ = fcntl(fd, F_DUPFD_CLOEXEC, 3);
+            
+            std::shared_ptr<ServiceLog> log = log_;
+            uint64_t watch_id = supervisor_->addWatch(fd, EPOLLIN, [log, fd](uint32_t) {
+                return log->consume(fd);
+            }, true);
+            
+            if (watch_id == 0) {
+                close(fd);
+            }
+        #else
+            (void)fd;
+        #endif
+    }
+    
+    // 等待服务发出第一次心跳，进程退出或超时仍未发出心跳时返回false
+    bool waitForFirstHeartbeat(const HeartbeatRegion& heartbeat, int timeout) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        while (heartbeat.page()->counter.load(std::memory_order_acquire) == 0) {
+            if (!checkProcessAlive() || std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+    
+    // 等待主进程退出直到deadline，退出后立即返回true；子进程同时被回收
+    bool waitProcessExit(std::chrono::steady_clock::time_point deadline) {
+        while (checkProcessAlive()) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+            
+            #ifndef _WIN32
+                // 有pidfd时阻塞到进程退出或超时，不依赖轮询间隔
+                if (pidfd_ != -1) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+                    pollfd entry{};
+                    entry.fd = pidfd_;
+                    entry.events = POLLIN;
+                    poll(&entry, 1, static_cast<int>(remaining));
+                    continue;
+                }
+            #endif
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+    
+    // 阻塞等待已收到SIGKILL的进程退出
+    void waitForExit() {
+        #ifndef _WIN32
+            int wait_status;
+            pid_t result = waitpid(status_.pid, &wait_status, 0);
+            if (result == status_.pid) {
+                exit_status_ = wait_status;
+            } else if (result == -1 && errno == ECHILD && pidfd_ != -1) {
+                pollfd entry{};
+                entry.fd = pidfd_;
+                entry.events = POLLIN;
+                poll(&entry, 1, 1000);
+            }
+        #endif
+    }
+    
+    // 释放与当前进程关联的pidfd和输出读端
+    void releaseProcessHandles() {
+        #ifndef _WIN32
+            if (exit_watch_id_ != 0) {
+                supervisor_->removeWatch(exit_watch_id_);
+                exit_watch_id_ = 0;
+            }
+            if (pidfd_ != -1) {
+                close(pidfd_);
+                pidfd_ = -1;
+            }
+            if (output_fd_ != -1) {
+                close(output_fd_);
+                output_fd_ = -1;
+            }
+        #endif
+        start_ticks_ = 0;
+        
+        // 关闭连接后zygote的请求循环和尚未提升的待命进程随之结束
+        #ifndef _WIN32
+            if (standby_channel_ != -1) {
+                close(standby_channel_);
+                standby_channel_ = -1;
+            }
+        #endif
+        std::lock_guard<std::mutex> lock(zygote_mutex_);
+        zygote_client_.reset();
+    }
+    
+    // 主进程退出时立即唤醒监控线程，不等下一轮检查
+    void watchProcessExit() {
+        #ifndef _WIN32
+            if (standby_role_ || pidfd_ == -1 || !supervisor_ || !supervisor_->isRunning()) {
+                return;
+            }
+            
+            // 监视项使用自己的pidfd副本，由监管线程关闭，与pidfd_的关闭互不影响
+            int fd = fcntl(pidfd_, F_DUPFD_CLOEXEC, 3);
+            if (fd == -1) {
+                return;
+            }
+            
+            // 监管线程上的处理函数可能晚于服务析构执行，只持有弱引用
+            std::weak_ptr<Service> self = weak_from_this();
+            exit_watch_id_ = supervisor_->addWatch(fd, EPOLLIN, [self](uint32_t) {
+                if (auto service = self.lock()) {
+                    {
+                        std::lock_guard<std::mutex> lock(service->monitor_wait_mutex_);
+                        service->process_exited_ = true;
+                    }
+                    service->monitor_cv_.notify_all();
+                }
+                return false;
+            }, true);
+            if (exit_watch_id_ == 0) {
+                close(fd);
+            }
+        #endif
+    }
+    
+    // 把I/O限制写入服务的cgroup，失败时通知错误回调
+    bool applyIoLimits(const std::vector<ServiceIoLimit>& limits) {
+        std::string error = "进程树跟踪不可用";
+        if (process_tree_ ? process_tree_->setIoLimits(processTreeUnit(), limits, error) : limits.empty()) {
+            return true;
+        }
+        pending_errors_.push_back("I/O限制未生效: " + error);
+        return false;
+    }
+    
+    // 进程树单元名，待命实例与主实例分开跟踪
+    std::string processTreeUnit() const {
+        std::string name = getConfig().name;
+        return standby_role_ ? name + ".standby" : name;
+    }
+    
+    // 主进程退出而进程树中仍有进程时（如fork后父进程退出的守护进程），改为跟踪其中PID最小的进程
+    bool followProcessTree() {
+        #ifndef _WIN32
+            if (!process_tree_) {
+                return false;
+            }
+            
+            std::string unit = processTreeUnit();
+            for (int pid : process_tree_->members(unit)) {
+                unsigned long long start_ticks = readProcessStartTicks(pid);
+                if (pid == status_.pid || start_ticks == 0) {
+                    continue;
+                }
+                
+                if (exit_watch_id_ != 0) {
+                    supervisor_->removeWatch(exit_watch_id_);
+                    exit_watch_id_ = 0;
+                }
+                if (pidfd_ != -1) {
+                    close(pidfd_);
+                }
+                status_.pid = pid;
+                pidfd_ = openPidfd(pid);
+                start_ticks_ = start_ticks;
+                process_tree_->track(unit, pid);
+                watchProcessExit();
+                return true;
+            }
+        #endif
+        return false;
+    }
+    
+    // 主进程退出后强制终止进程树中的剩余进程，最多等待一秒
+    void stopProcessTree(const std::string& unit) {
+        #ifndef _WIN32
+            if (!process_tree_->members(unit).empty()) {
+                process_tree_->signal(unit, SIGKILL);
+                
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                while (!process_tree_->members(unit).empty() && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                }
+            }
+            process_tree_->release(unit);
+        #else
+            (void)unit;
+        #endif
+    }
+    
+    void closeListener() {
+        #ifndef _WIN32
+            if (listener_ != -1) {
+                close(listener_);
+                listener_ = -1;
+            }
+        #endif
+    }
+    
+    // 以handoff中的进程作为当前进程，描述符所有权转移给服务；输出读端已有监视时不再重复添加
+    void installProcess(const ProcessHandoff& handoff, bool attach_output) {
+        releaseProcessHandles();
+        status_.pid = handoff.pid;
+        status_.state = ServiceState::Running;
+        status_.start_time = handoff.start_time;
+        status_.last_activity = std::chrono::system_clock::now();
+        status_.restart_count = handoff.restart_count;
+        status_.last_error.clear();
+        pidfd_ = handoff.pidfd;
+        start_ticks_ = handoff.start_ticks;
+        paused_ = false;
+        watchProcessExit();
+        if (process_tree_) {
+            process_tree_->track(processTreeUnit(), status_.pid);
+        }
+        
+        #ifndef _WIN32
+            // 交接时被压力卸载暂停的服务，新的管理器不知道其卸载记录，直接恢复运行
+            if (handoff.paused) {
+                signalProcess(status_.pid, pidfd_, SIGCONT);
+            }
+            
+            if (handoff.output_fd != -1) {
+                if (attach_output) {
+                    attachOutput(handoff.output_fd);
+                } else {
+                    output_fd_ = handoff.output_fd;
+                }
             }
-        #else
-            if (kill(status_.pid, 0) == 0) {
-                status_.state = ServiceState::Running;
-                startMonitoring();
-                return true;
+            
+            if (handoff.heartbeat_fd != -1) {
+                auto region = HeartbeatRegion::adopt(handoff.heartbeat_fd);
+                int timeout = getConfig().watchdog_timeout;
+                if (!region) {
+                    close(handoff.heartbeat_fd);
+                } else if (timeout > 0) {
+                    armWatchdog(std::move(region), timeout);
+                }
             }
         #endif
+        publishStatus();
+    }
+    
+    // 主实例退出时提升待命实例；待命实例的输出读端已由共用的日志监视
+    bool takeOverFromStandby() {
+        std::shared_ptr<Service> standby;
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            standby = standby_;
+        }
         
-        status_.last_error = "进程启动后立即退出";
-        status_.state = ServiceState::Failed;
-        return false;
+        ProcessHandoff handoff;
+        if (!standby || !standby->promote(listener_, handoff)) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            if (standby_ == standby) {
+                standby_.reset();
+            }
+        }
+        
+        handoff.restart_count = status_.restart_count + 1;
+        installProcess(handoff, false);
+        pending_errors_.push_back("主实例意外退出，已由待命实例接替");
+        return true;
     }
     
-    bool stop() {
-        if (status_.state == ServiceState::Stopped || status_.state == ServiceState::Stopping) {
-            return true; // 已经停止或正在停止
+    // 配置了warm_standby的关键服务运行时保持一个待命实例，在监控线程上调用
+    void maintainStandby() {
+        ServiceConfig config = getConfig();
+        if (standby_role_ || !config.warm_standby || config.priority != ServicePriority::Critical ||
+            getState() != ServiceState::Running) {
+            return;
         }
         
+        std::shared_ptr<Service> standby;
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            if (standby_) {
+                return; // 待命实例自身的监控线程负责其重启
+            }
+            standby = std::make_shared<Service>(config, log_);
+            standby->setSupervisor(supervisor_);
+            standby->setWatchdog(watchdog_);
+            standby->setProcessTree(process_tree_);
+            standby->setJournal(journal_);
+            standby->standby_role_ = true;
+            standby_ = standby;
+        }
+        standby->start();
+    }
+    
+    void stopStandby() {
+        std::shared_ptr<Service> standby;
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            standby.swap(standby_);
+        }
+        if (standby) {
+            standby->stop();
+        }
+    }
+    
+    // 检查进程是否存活；Linux下同时回收已退出的子进程，避免僵尸进程被误判为存活
+    bool checkProcessAlive() {
         if (status_.pid == -1) {
-            status_.state = ServiceState::Stopped;
-            return true;
+            return false;
         }
         
-        status_.state = ServiceState::Stopping;
-        
         #ifdef _WIN32
-            // Windows平台终止进程
-            HANDLE process = OpenProcess(PROCESS_TERMINATE, FALSE, status_.pid);
+            HANDLE process = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, status_.pid);
             if (process == NULL) {
-                status_.last_error = "打开进程句柄失败";
-                status_.state = ServiceState::Failed;
-                return false;
-            }
-            
-            if (!TerminateProcess(process, 0)) {
-                status_.last_error = "终止进程失败";
-                status_.state = ServiceState::Failed;
-                CloseHandle(process);
                 return false;
             }
             
-            WaitForSingleObject(process, config_.shutdown_timeout);
+            DWORD exit_code;
+            bool alive = GetExitCodeProcess(process, &exit_code) && exit_code == STILL_ACTIVE;
             CloseHandle(process);
-            
+            return alive;
         #else
-            // Linux平台发送停止信号
-            if (kill(status_.pid, SIGTERM) == -1) {
-                status_.last_error = "发送停止信号失败";
-                status_.state = ServiceState::Failed;
-                return false;
-            }
-            
-            // 等待进程退出
             int wait_status;
             pid_t result = waitpid(status_.pid, &wait_status, WNOHANG);
-            
-            if (result == -1) {
-                status_.last_error = "等待进程退出失败";
-                status_.state = ServiceState::Failed;
+            if (result == status_.pid) {
+                exit_status_ = wait_status;
                 return false;
             }
             
-            if (result == 0) { // 进程还在运行，强制终止
-                std::this_thread::sleep_for(std::chrono::milliseconds(config_.shutdown_timeout));
-                
-                if (kill(status_.pid, SIGKILL) == -1) {
-                    status_.last_error = "强制终止进程失败";
-                    status_.state = ServiceState::Failed;
-                    return false;
-                }
-                
-                waitpid(status_.pid, &wait_status, 0);
+            // 管理器重启后接管的进程不是子进程，以pidfd判断，避免PID复用后误判为存活
+            if (result == -1 && errno == ECHILD && pidfd_ != -1) {
+                return !pidfdExited(pidfd_);
             }
+            return kill(status_.pid, 0) == 0;
         #endif
-        
-        status_.state = ServiceState::Stopped;
-        status_.pid = -1;
-        status_.uptime = std::chrono::seconds(0);
-        
-        // 停止监控线程
-        stopMonitoring();
-        
-        return true;
     }
     
-    bool restart() {
-        if (!stop()) {
-            return false;
+    void armWatchdog(std::shared_ptr<HeartbeatRegion> heartbeat, int timeout) {
+        disarmWatchdog();
+        heartbeat_ = heartbeat;
+        watchdog_id_ = watchdog_->watch(std::move(heartbeat), std::chrono::milliseconds(timeout), [this]() {
+            // 在监管线程上调用，只设置标志并唤醒监控线程
+            {
+                std::lock_guard<std::mutex> lock(monitor_wait_mutex_);
+                watchdog_expired_ = true;
+            }
+            monitor_cv_.notify_all();
+        });
+    }
+    
+    void disarmWatchdog() {
+        if (watchdog_id_ != 0) {
+            watchdog_->unwatch(watchdog_id_);
+            watchdog_id_ = 0;
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(config_.restart_delay));
-        
-        return start();
+        heartbeat_.reset();
+        watchdog_expired_ = false;
     }
     
-    ServiceState getState() const {
-        return status_.state;
+    static int oomScoreAdjustment(ServicePriority priority) {
+        switch (priority) {
+            case ServicePriority::Critical: return -500;
+            case ServicePriority::Low: return 500;
+            case ServicePriority::Idle: return 1000;
+            default: return 0;
+        }
     }
     
-    ServiceStatus getStatus() const {
-        return status_;
+    // 请求spawn_from指定的zygote fork服务进程，成功时同时得到pidfd；zygote不可用或未返回pidfd时返回-1
+    int spawnFromZygote(const ServiceConfig& config, int listen_fd, int heartbeat_fd, int output_fd) {
+        if (config.spawn_from.empty() || config.zygote || standby_role_ || !zygote_lookup_) {
+            return -1;
+        }
+        auto zygote = zygote_lookup_(config.spawn_from);
+        if (!zygote) {
+            return -1;
+        }
+        
+        ZygoteSpawnRequest request;
+        request.name = config.name;
+        request.args.push_back(config.executable_path);
+        request.args.insert(request.args.end(), config.args.begin(), config.args.end());
+        request.environment.insert(config.environment.begin(), config.environment.end());
+        if (process_tree_) {
+            request.environment[kServiceUnitEnv] = processTreeUnit();
+        }
+        request.working_directory = config.working_directory;
+        request.cpus = config.cpu_affinity;
+        request.oom_score_adj = oomScoreAdjustment(config.priority);
+        request.output_fd = output_fd;
+        request.listen_fd = listen_fd;
+        request.heartbeat_fd = heartbeat_fd;
+        
+        std::string error;
+        int pidfd = -1;
+        int pid = zygote->spawn(request, pidfd, error);
+        if (pid == -1) {
+            // 不算启动失败，只通知错误回调，随后回退到exec
+            pending_errors_.push_back("从zygote " + config.spawn_from + " 启动失败，改为直接执行: " + error);
+            return -1;
+        }
+        
+        // zygote忽略SIGCHLD，服务进程退出即被回收，PID随时可能复用；
+        // 没有pidfd就无法安全地发送信号和等待退出，趁刚创建立即终止并回退到exec
+        if (pidfd == -1) {
+            #ifndef _WIN32
+                kill(pid, SIGKILL);
+            #endif
+            pending_errors_.push_back("zygote " + config.spawn_from + " 未返回pidfd，改为直接执行");
+            return -1;
+        }
+        pidfd_ = pidfd;
+        return pid;
     }
     
-    ServiceConfig getConfig() const {
-        return config_;
+    // 心跳停滞视为进程挂起：先发送SIGABRT以便留下核心转储，超时后强制终止
+    void abortHungProcess() {
+        disarmWatchdog();
+        
+        #ifdef _WIN32
+            HANDLE process = OpenProcess(PROCESS_TERMINATE, FALSE, status_.pid);
+            if (process != NULL) {
+                TerminateProcess(process, 1);
+                CloseHandle(process);
+            }
+        #else
+            signalProcess(status_.pid, pidfd_, SIGABRT);
+            
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(getConfig().shutdown_timeout);
+            if (!waitProcessExit(deadline)) {
+                signalProcess(status_.pid, pidfd_, SIGKILL);
+                waitForExit();
+            }
+            
+            // 挂起进程的工作进程不能留给重启后的实例
+            if (process_tree_) {
+                stopProcessTree(processTreeUnit());
+            }
+        #endif
     }
     
-    void setConfig(const ServiceConfig& config) {
-        config_ = config;
+    // 将status_发布给不加锁的读者，并记录待通知的状态变化
+    void publishStatus() {
+        ServiceState old_state = published_state_.load(std::memory_order_relaxed);
+        PublishedStatus published = PublishedStatus::fromStatus(status_);
+        PublishedStatus previous = published_status_.load();
+        published_status_.store(published);
+        published_state_.store(status_.state, std::memory_order_release);
+        
+        // 监控线程每次采样都会刷新资源统计，只因统计变化而递增会让快照缓存失效
+        if (published.differsFrom(previous)) {
+            bumpGeneration();
+        }
+        
+        if (old_state != status_.state) {
+            pending_transitions_.push_back(PendingTransition{old_state, status_.state, std::chrono::system_clock::now()});
+            
+            JournalEvent event;
+            event.type = JournalEventType::StateChange;
+            event.pid = status_.pid;
+            event.old_state = old_state;
+            event.new_state = status_.state;
+            recordEvent(std::move(event));
+        }
+        if (status_.state == ServiceState::Failed && !status_.last_error.empty()) {
+            pending_errors_.push_back(status_.last_error);
+        }
+        
+        ServiceMetricsSlot* slot = metrics_.load(std::memory_order_acquire);
+        if (slot) {
+            slot->state.store(static_cast<int>(status_.state), std::memory_order_relaxed);
+            // restart_count在每次启动时递增，首次启动不算重启
+            slot->restarts.store(status_.restart_count > 0 ? status_.restart_count - 1 : 0, std::memory_order_relaxed);
+            slot->cpu_usage.store(status_.cpu_usage, std::memory_order_relaxed);
+            slot->memory_bytes.store(static_cast<uint64_t>(status_.memory_usage) * 1024, std::memory_order_relaxed);
+            slot->io_read_bytes.store(status_.io.read_bytes, std::memory_order_relaxed);
+            slot->io_write_bytes.store(status_.io.write_bytes, std::memory_order_relaxed);
+            
+            if (status_.state != ServiceState::Running) {
+                slot->running_since_ns.store(0, std::memory_order_relaxed);
+            } else if (old_state != ServiceState::Running || slot->running_since_ns.load(std::memory_order_relaxed) == 0) {
+                slot->running_since_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+            }
+        }
     }
     
-    void updateStatus(const ServiceStatus& status) {
-        ServiceState old_state = status_.state;
-        status_ = status;
+    void recordProbe(std::chrono::steady_clock::duration duration) {
+        ServiceMetricsSlot* slot = metrics_.load(std::memory_order_acquire);
+        if (!slot) {
+            return;
+        }
         
-        if (old_state != status_.state && status_change_callback_) {
-            status_change_callback_(config_.name, old_state, status_.state);
+        int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        slot->probe_count.fetch_add(1, std::memory_order_relaxed);
+        slot->probe_duration_ns.fetch_add(nanoseconds, std::memory_order_relaxed);
+        slot->last_probe_ns.store(nanoseconds, std::memory_order_relaxed);
+    }
+    
+    void bumpGeneration() {
+        if (generation_) {
+            generation_->fetch_add(1, std::memory_order_release);
         }
     }
     
-    void setStatusChangeCallback(std::function<void(ServiceState, ServiceState)> callback) {
-        status_change_callback_ = std::move(callback);
+    // 写入生命周期事件日志，服务名和启动次数取当前值
+    void recordEvent(JournalEvent event) {
+        if (!journal_ || !journal_->isOpen()) {
+            return;
+        }
+        event.service = processTreeUnit();
+        event.restart_count = status_.restart_count;
+        journal_->append(event);
     }
     
-    void setErrorCallback(std::function<void(const std::string&)> callback) {
-        error_callback_ = std::move(callback);
+    // 记录主进程退出，退出状态来自最近一次回收；不是子进程时退出码未知
+    void recordExit() {
+        JournalEvent event;
+        event.type = JournalEventType::Exit;
+        event.pid = status_.pid;
+        #ifndef _WIN32
+            if (exit_status_ != -1 && WIFEXITED(exit_status_)) {
+                event.exit_code = WEXITSTATUS(exit_status_);
+            } else if (exit_status_ != -1 && WIFSIGNALED(exit_status_)) {
+                event.signal = WTERMSIG(exit_status_);
+            }
+        #endif
+        exit_status_ = -1;
+        recordEvent(std::move(event));
     }
-
-private:
-    bool checkDependencies() {
-        // 这里应该检查依赖服务是否运行
-        // 简化实现：假设所有依赖都满足
-        return true;
+    
+    // 在不持有op_mutex_的情况下触发回调，回调中可以安全地查询服务状态
+    void flushNotifications() {
+        std::vector<PendingTransition> transitions;
+        std::vector<std::string> errors;
+        {
+            std::lock_guard<std::mutex> lock(op_mutex_);
+            transitions.swap(pending_transitions_);
+            errors.swap(pending_errors_);
+        }
+        
+        if (status_change_callback_) {
+            for (const auto& transition : transitions) {
+                status_change_callback_(transition.old_state, transition.new_state, transition.timestamp);
+            }
+        }
+        
+        if (error_callback_) {
+            for (const auto& error : errors) {
+                error_callback_(error);
+            }
+        }
     }
     
     void startMonitoring() {
+        std::lock_guard<std::mutex> lock(monitor_mutex_);
         if (monitoring_thread_running_) {
             return;
         }
         
-        monitoring_thread_running_ = true;
-        monitoring_thread_ = std::thread([this]() {
-            while (monitoring_thread_running_) {
-                // 检查进程状态
-                        if (status_.pid != -1) {
-                            #ifdef _WIN32
-                                HANDLE process = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, status_.pid);
-                                if (process != NULL) {
-                                    DWORD exit_code;
-                                    if (GetExitCodeProcess(process, &exit_code) && exit_code == STILL_ACTIVE) {
-                                        // 进程还在运行
-                                        status_.last_activity = std::chrono::system_clock::now();
-                                        
-                                        // 更新资源使用情况（简化实现）
-                                        updateResourceUsage();
-                                    } else {
-                                        // 进程已退出
-                                        status_.state = ServiceState::Failed;
-                                        status_.last_error = "进程意外退出";
-                                        
-                                        if (error_callback_) {
-                                            error_callback_(status_.last_error);
-                                        }
-                                        
-                                        // 尝试自动重启
-                                        if (status_.restart_count < config_.max_restart_attempts) {
-                                            std::this_thread::sleep_for(std::chrono::milliseconds(config_.restart_delay));
-                                            start();
-                                        }
-                                        
-                                        CloseHandle(process);
-                                        break;
-                                    }
-                                    CloseHandle(process);
-                                } else {
-                                    // 进程已退出
-                                    status_.state = ServiceState::Failed;
-                                    status_.last_error = "进程意外退出";
-                                    
-                                    if (error_callback_) {
-                                        error_callback_(status_.last_error);
-                                    }
-                                    
-                                    // 尝试自动重启
-                                    if (status_.restart_count < config_.max_restart_attempts) {
-                                        std::this_thread::sleep_for(std::chrono::milliseconds(config_.restart_delay));
-                                        start();
-                                    }
-                                    
-                                    break;
-                                }
-                            #else
-                                if (kill(status_.pid, 0) == 0) {
-                                    // 进程还在运行
-                                    status_.last_activity = std::chrono::system_clock::now();
-                                    
-                                    // 更新资源使用情况（简化实现）
-                                    updateResourceUsage();
-                                } else {
-                                    // 进程已退出
-                                    status_.state = ServiceState::Failed;
-                                    status_.last_error = "进程意外退出";
-                                    
-                                    if (error_callback_) {
-                                        error_callback_(status_.last_error);
-                                    }
-                                    
-                                    // 尝试自动重启
-                                    if (status_.restart_count < config_.max_restart_attempts) {
-                                        std::this_thread::sleep_for(std::chrono::milliseconds(config_.restart_delay));
-                                        start();
-                                    }
-                                    
-                                    break;
-                                }
-                            #endif
+        // 回收上一次已结束的监控线程
+        if (monitoring_thread_.joinable() && monitoring_thread_.get_id() != std::this_thread::get_id()) {
+            monitoring_thread_.join();
+        }
+        
+        // 上一个监控线程可能仍在stopMonitoring()中等待结束，每个线程只认自己的代数，
+        // 不会因为运行标志被重新置位而继续运行
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> wait_lock(monitor_wait_mutex_);
+            generation = ++monitoring_generation_;
+            monitoring_thread_running_ = true;
+        }
+        monitoring_thread_ = std::thread([this, generation]() {
+            while (isMonitoring(generation)) {
+                bool should_restart = false;
+                {
+                    std::lock_guard<std::mutex> lock(op_mutex_);
+                    // 检查进程状态
+                    if (status_.pid != -1 && status_.state == ServiceState::Running && watchdog_expired_) {
+                        abortHungProcess();
+                        recordExit();
+                        if (!takeOverFromStandby()) {
+                            status_.pid = -1;
+                            status_.state = ServiceState::Failed;
+                            status_.last_error = "看门狗超时，服务无响应";
+                            should_restart = status_.restart_count < getConfig().max_restart_attempts;
+                        }
+                        publishStatus();
+                    } else if (status_.pid != -1 && status_.state == ServiceState::Running) {
+                        auto probe_start = std::chrono::steady_clock::now();
+                        bool alive = checkProcessAlive();
+                        auto probe_duration = std::chrono::steady_clock::now() - probe_start;
+                        recordProbe(probe_duration);
+                        
+                        if (!alive) {
+                            JournalEvent event;
+                            event.type = JournalEventType::ProbeFailed;
+                            event.pid = status_.pid;
+                            event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(probe_duration);
+                            recordEvent(std::move(event));
+                            recordExit();
+                        }
+                        
+                        if (alive) {
+                            // 进程还在运行
+                            status_.last_activity = std::chrono::system_clock::now();
+                            
+                            // 更新资源使用情况
+                            updateResourceUsage();
+                        } else if (followProcessTree()) {
+                            // 主进程以守护进程方式退出，服务仍在运行
+                            status_.last_activity = std::chrono::system_clock::now();
+                        } else {
+                            // 进程已退出，有待命实例时由其立即接替
+                            disarmWatchdog();
+                            if (!takeOverFromStandby()) {
+                                status_.pid = -1;
+                                status_.state = ServiceState::Failed;
+                                status_.last_error = "进程意外退出";
+                                
+                                // 尝试自动重启
+                                should_restart = status_.restart_count < getConfig().max_restart_attempts;
+                            }
+                        }
+                        publishStatus();
+                    }
+                }
+                flushNotifications();
+                
+                if (should_restart) {
+                    if (!waitMonitoring(generation, std::chrono::milliseconds(getConfig().restart_delay))) {
+                        break;
+                    }
+                    
+                    {
+                        std::lock_guard<std::mutex> lock(op_mutex_);
+                        if (status_.state == ServiceState::Failed) {
+                            JournalEvent event;
+                            event.type = JournalEventType::Restart;
+                            recordEvent(std::move(event));
+                            startLocked();
                         }
+                    }
+                    flushNotifications();
+                }
                 
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                maintainStandby();
+                
+                if (!waitMonitoring(generation, std::chrono::milliseconds(1000))) {
+                    break;
+                }
             }
         });
     }
     
     void stopMonitoring() {
-        monitoring_thread_running_ = false;
-        if (monitoring_thread_.joinable()) {
-            monitoring_thread_.join();
+        std::thread thread;
+        {
+            std::lock_guard<std::mutex> lock(monitor_mutex_);
+            {
+                std::lock_guard<std::mutex> wait_lock(monitor_wait_mutex_);
+                monitoring_thread_running_ = false;
+            }
+            
+            // 在监控线程自身的回调中调用时不能join自己，线程会在本轮结束后退出
+            if (monitoring_thread_.joinable() && monitoring_thread_.get_id() != std::this_thread::get_id()) {
+                thread = std::move(monitoring_thread_);
+            }
+        }
+        monitor_cv_.notify_all();
+        
+        // 不持有monitor_mutex_等待，回调中重新启动服务不会死锁
+        if (thread.joinable()) {
+            thread.join();
         }
     }
     
+    // 代数为generation的监控线程是否应继续运行
+    bool isMonitoring(uint64_t generation) const {
+        return monitoring_thread_running_ && monitoring_generation_ == generation;
+    }
+    
+    // 可被stopMonitoring()、看门狗超时或主进程退出打断的等待，监控仍在运行时返回true
+    bool waitMonitoring(uint64_t generation, std::chrono::milliseconds duration) {
+        std::unique_lock<std::mutex> lock(monitor_wait_mutex_);
+        monitor_cv_.wait_for(lock, duration, [this, generation]() {
+            return !isMonitoring(generation) || watchdog_expired_ || process_exited_;
+        });
+        process_exited_ = false;
+        return isMonitoring(generation);
+    }
+    
     void updateResourceUsage() {
-        // 简化实现：模拟资源使用数据
-        // 实际实现应该读取/proc文件系统或使用系统调用
-        status_.memory_usage = 1024 + (rand() % 4096); // 1-5MB
-        status_.cpu_usage = (rand() % 100) / 100.0;   // 0-100%
+        #ifdef _WIN32
+            // 简化实现：模拟资源使用数据
+            status_.memory_usage = 1024 + (rand() % 4096); // 1-5MB
+            status_.cpu_usage = (rand() % 100) / 100.0;   // 0-100%
+        #else
+            // 有进程树时统计服务的全部进程，否则只统计主进程
+            ProcessTreeUsage usage{};
+            if (!process_tree_ || !process_tree_->usage(processTreeUnit(), usage)) {
+                usage = ProcessTreeUsage{};
+                if (!addProcessUsage(status_.pid, usage)) {
+                    return;
+                }
+            }
+            status_.memory_usage = static_cast<int>(usage.memory_bytes / 1024);
+            status_.io.read_bytes = usage.read_bytes;
+            status_.io.write_bytes = usage.write_bytes;
+            
+            // 累计值变小说明换了进程或cgroup，本次只重新建立基线
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - last_usage_sample_).count();
+            if (last_usage_sample_ != std::chrono::steady_clock::time_point() && elapsed > 0) {
+                auto rate = [elapsed](uint64_t current, uint64_t previous) {
+                    return current >= previous ? (current - previous) / elapsed : 0.0;
+                };
+                if (usage.cpu_usec >= last_usage_.cpu_usec) {
+                    status_.cpu_usage = rate(usage.cpu_usec, last_usage_.cpu_usec) / 1e6;
+                }
+                if (usage.read_bytes >= last_usage_.read_bytes && usage.write_bytes >= last_usage_.write_bytes) {
+                    status_.io.read_bytes_per_sec = rate(usage.read_bytes, last_usage_.read_bytes);
+                    status_.io.write_bytes_per_sec = rate(usage.write_bytes, last_usage_.write_bytes);
+                    status_.io.read_iops = rate(usage.read_ops, last_usage_.read_ops);
+                    status_.io.write_iops = rate(usage.write_ops, last_usage_.write_ops);
+                }
+            }
+            last_usage_ = usage;
+            last_usage_sample_ = now;
+        #endif
     }
     
-    ServiceConfig config_;
-    ServiceStatus status_;
-    std::function<void(ServiceState, ServiceState)> status_change_callback_;
+    std::shared_ptr<const ServiceConfig> config_;   ///< 受config_mutex_保护，指向的配置不可变
+    mutable std::mutex config_mutex_;
+    std::shared_ptr<ServiceLog> log_;
+    ServiceSupervisor* supervisor_;
+    ServiceWatchdog* watchdog_;
+    ServiceProcessTree* process_tree_;
+    ServiceJournal* journal_;
+    std::atomic<uint64_t>* generation_;
+    std::function<std::shared_ptr<ZygoteClient>(const std::string&)> zygote_lookup_;
+    std::shared_ptr<ZygoteClient> zygote_client_;
+    std::mutex zygote_mutex_;
+    uint64_t watchdog_id_;                          ///< 看门狗登记ID，受op_mutex_保护
+    
+    ServiceStatus status_;                          ///< 工作副本，受op_mutex_保护
+    ServiceStartupTiming timing_;                   ///< 最近一次启动的时间线
+    bool start_request_pending_;
+    mutable std::mutex timing_mutex_;
+    ProcessTreeUsage last_usage_;                   ///< 上次采样的累计资源使用
+    std::chrono::steady_clock::time_point last_usage_sample_;
+    std::mutex op_mutex_;
+    SeqLockCell<PublishedStatus> published_status_; ///< 不加锁读取的状态快照，与发布重叠时重试
+    std::atomic<ServiceState> published_state_;     ///< 当前状态，单次原子读取
+    std::atomic<ServiceMetricsSlot*> metrics_;      ///< 指标槽位，归管理器的指标注册表所有
+    std::vector<PendingTransition> pending_transitions_;
+    std::vector<std::string> pending_errors_;
+    
+    std::function<void(ServiceState, ServiceState, std::chrono::system_clock::time_point)> status_change_callback_;
     std::function<void(const std::string&)> error_callback_;
+    
+    std::mutex monitor_mutex_;
+    std::mutex monitor_wait_mutex_;
+    std::condition_variable monitor_cv_;
     std::thread monitoring_thread_;
-    bool monitoring_thread_running_;
+    std::atomic<bool> monitoring_thread_running_;
+    std::atomic<uint64_t> monitoring_generation_;   ///< 最近启动的监控线程的代数，修改受monitor_wait_mutex_保护
+    std::atomic<bool> watchdog_expired_;            ///< 由看门狗设置，监控线程处理
+    std::atomic<bool> paused_;                      ///< 是否被SIGSTOP暂停，修改受op_mutex_保护
+    int pidfd_;                                     ///< 以下四者描述当前进程，受op_mutex_保护
+    int output_fd_;
+    unsigned long long start_ticks_;
+    std::shared_ptr<HeartbeatRegion> heartbeat_;
+    bool standby_role_;                             ///< 本实例是另一实例的待命实例
+    int standby_channel_;                           ///< 待命进程交接套接字的管理器一端，受op_mutex_保护
+    int listener_;                                  ///< 配置了待命实例时持有的监听套接字，受op_mutex_保护
+    std::shared_ptr<Service> standby_;              ///< 主实例的待命实例
+    std::mutex standby_mutex_;
+    uint64_t exit_watch_id_;                        ///< 主进程pidfd的监视项，受op_mutex_保护
+    bool process_exited_;                           ///< 受monitor_wait_mutex_保护
+    int exit_status_;                               ///< 最近一次回收主进程得到的等待状态，-1表示未知；受op_mutex_保护
 };
 
 // 服务管理器实现类
 class ServiceManager::Impl {
 public:
-    Impl() : monitoring_interval_(1000), monitoring_running_(false) {
+    Impl()
+        : watchdog_(supervisor_)
+        , metrics_server_(supervisor_, metrics_)
+        , control_server_(supervisor_, [this](const ControlCommand& command) { return executeControlCommand(command); })
+        , pressure_(supervisor_)
+        , process_tree_(supervisor_)
+        , jobs_([this](const std::string& name, ServiceJobEngine::UnitInfo& info) { return describeUnit(name, info); },
+                [this](const std::vector<StartJob>& jobs, const StartAdmissionController::Starter& action, bool stopping) {
+                    return scheduleJobs(jobs, action, stopping);
+                })
+        , generation_(0)
+        , config_file_("/etc/cloudflow/services.conf")
+        , status_change_subscription_(0) {
+        supervisor_.start();
+        watchdog_.start();
+        process_tree_.start();
     }
     
     ~Impl() {
-        stopMonitoring();
+        control_server_.stop();
+        pressure_.stop();
         stopAllServices();
+        process_tree_.stop();
+        metrics_server_.stop();
+        watchdog_.stop();
+        supervisor_.stop();
     }
     
     bool initialize() {
@@ -419,178 +1910,361 @@ public:
         return loadConfig();
     }
     
+    void setConfigFile(const std::string& path) {
+        std::lock_guard<std::mutex> lock(config_file_mutex_);
+        config_file_ = path;
+    }
+    
     bool registerService(const ServiceConfig& config) {
-        if (services_.find(config.name) != services_.end()) {
-            return false; // 服务已存在
+        if (config.instances.mode != InstanceMode::Single) {
+            return registerTemplate(config);
         }
         
-        auto service = std::make_unique<Service>(config);
-        service->setStatusChangeCallback([this, name = config.name](ServiceState old_state, ServiceState new_state) {
-            if (status_change_callback_) {
-                status_change_callback_(name, old_state, new_state);
-            }
-        });
-        
-        service->setErrorCallback([this, name = config.name](const std::string& error) {
-            if (error_callback_) {
-                error_callback_(name, error);
-            }
-        });
-        
-        services_[config.name] = std::move(service);
+        if (!addService(config)) {
+            return false; // 服务已存在
+        }
         
         // 保存配置
         return saveConfig();
     }
     
     bool unregisterService(const std::string& service_name) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
-            return false;
+        if (isTemplate(service_name)) {
+            {
+                std::lock_guard<std::mutex> lock(scale_mutex_);
+                scaleLocked(service_name, 0);
+                std::lock_guard<std::mutex> templates_lock(templates_mutex_);
+                templates_.erase(service_name);
+            }
+            return saveConfig();
         }
         
-        // 停止服务
-        it->second->stop();
-        
-        services_.erase(it);
+        if (!removeService(service_name)) {
+            return false;
+        }
         
         // 保存配置
         return saveConfig();
     }
     
+    // 服务连同尚未运行的依赖作为一个事务启动，全部实例同属一个事务
     bool startService(const std::string& service_name) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
-            return false;
+        auto requested = std::chrono::steady_clock::now();
+        std::vector<std::string> names = getServiceInstances(service_name);
+        if (names.empty()) {
+            names.push_back(service_name);
         }
         
-        return it->second->start();
+        std::string error;
+        bool started = jobs_.start(names, [this, requested](const std::string& name) {
+            return startServiceAt(name, requested);
+        }, error);
+        if (!started) {
+            reportError(service_name, error);
+        }
+        return started;
     }
     
     bool stopService(const std::string& service_name) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
-            return false;
+        std::vector<std::string> names = getServiceInstances(service_name);
+        if (names.empty()) {
+            names.push_back(service_name);
         }
         
-        return it->second->stop();
+        std::string error;
+        bool stopped = jobs_.stop(names, [this](const std::string& name) { return stopUnit(name); }, error);
+        if (!stopped) {
+            reportError(service_name, error);
+        }
+        return stopped;
     }
     
     bool restartService(const std::string& service_name) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
+        std::vector<std::string> instances = getServiceInstances(service_name);
+        if (!instances.empty()) {
+            bool all_restarted = true;
+            for (const auto& instance : instances) {
+                if (!restartService(instance)) {
+                    all_restarted = false;
+                }
+            }
+            return all_restarted;
+        }
+        
+        auto service = services_.find(service_name);
+        if (!service) {
+            return false;
+        }
+        
+        // 停止和启动都作为作业执行，与并发的启停请求合并或相互取消
+        if (!stopService(service_name)) {
             return false;
         }
         
-        return it->second->restart();
+        std::this_thread::sleep_for(std::chrono::milliseconds(service->getConfig().restart_delay));
+        
+        return startService(service_name);
     }
     
     ServiceStatus getServiceStatus(const std::string& service_name) const {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
-            return ServiceStatus{ServiceState::Unknown, -1, {}, {}, 0, "服务不存在", 0, 0.0};
+        auto service = services_.find(service_name);
+        if (!service) {
+            return ServiceStatus{ServiceState::Unknown, -1, {}, {}, 0, "服务不存在", 0, 0.0, {}};
         }
         
-        return it->second->getStatus();
+        return service->getStatus();
     }
     
     bool isServiceRunning(const std::string& service_name) const {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
+        auto service = services_.find(service_name);
+        if (!service) {
             return false;
         }
         
-        ServiceState state = it->second->getState();
+        ServiceState state = service->getState();
         return state == ServiceState::Running || state == ServiceState::Starting;
     }
     
     std::vector<std::string> getServiceNames() const {
-        std::vector<std::string> names;
-        names.reserve(services_.size());
+        return services_.keys();
+    }
+    
+    std::vector<int> getServiceProcesses(const std::string& service_name) const {
+        auto service = services_.find(service_name);
+        if (!service) {
+            return {};
+        }
         
-        for (const auto& pair : services_) {
-            names.push_back(pair.first);
+        return service->getProcesses();
+    }
+    
+    std::shared_ptr<const ServiceSnapshot> getSnapshot() const {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        uint64_t generation = generation_.load(std::memory_order_acquire);
+        if (snapshot_ && snapshot_->generation == generation) {
+            return snapshot_;
         }
         
-        return names;
+        // 构建期间代数变化说明有服务发布了新状态，重试几次以得到同一代的状态；
+        // 持续变化时接受最后一次，标注构建前的代数，调用方下次会看到代数已变化
+        auto snapshot = std::make_shared<ServiceSnapshot>();
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            snapshot->generation = generation;
+            snapshot->services.clear();
+            for (const auto& pair : services_.entries()) {
+                snapshot->services.push_back(ServiceSnapshot::Entry{
+                    pair.first, pair.second->getSharedConfig(), pair.second->getStatus()});
+            }
+            
+            uint64_t current = generation_.load(std::memory_order_acquire);
+            if (current == generation) {
+                break;
+            }
+            generation = current;
+        }
+        
+        std::sort(snapshot->services.begin(), snapshot->services.end(),
+                  [](const ServiceSnapshot::Entry& a, const ServiceSnapshot::Entry& b) { return a.name < b.name; });
+        snapshot_ = std::move(snapshot);
+        return snapshot_;
+    }
+    
+    uint64_t getGeneration() const {
+        return generation_.load(std::memory_order_acquire);
     }
     
     ServiceConfig getServiceConfig(const std::string& service_name) const {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
+        auto service = services_.find(service_name);
+        if (!service) {
             return ServiceConfig{};
         }
         
-        return it->second->getConfig();
+        return service->getConfig();
+    }
+    
+    std::vector<std::string> tailServiceLog(const std::string& service_name, size_t max_lines) const {
+        auto service = services_.find(service_name);
+        if (!service) {
+            return {};
+        }
+        
+        return service->getLog()->tail(max_lines);
     }
     
     bool setServiceConfig(const std::string& service_name, const ServiceConfig& config) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
+        auto service = services_.find(service_name);
+        if (!service) {
             return false;
         }
         
-        it->second->setConfig(config);
+        service->setConfig(config);
         return saveConfig();
     }
     
+    bool setServiceIoLimits(const std::string& service_name, const std::vector<ServiceIoLimit>& limits) {
+        auto service = services_.find(service_name);
+        if (!service) {
+            return false;
+        }
+        
+        bool applied = service->setIoLimits(limits);
+        bool saved = saveConfig();
+        return applied && saved;
+    }
+    
     bool enableService(const std::string& service_name) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
+        auto service = services_.find(service_name);
+        if (!service) {
             return false;
         }
         
-        ServiceConfig config = it->second->getConfig();
-        config.auto_start = true;
-        it->second->setConfig(config);
+        service->setAutoStart(true);
         
         return saveConfig();
     }
     
     bool disableService(const std::string& service_name) {
-        auto it = services_.find(service_name);
-        if (it == services_.end()) {
+        auto service = services_.find(service_name);
+        if (!service) {
             return false;
         }
         
-        ServiceConfig config = it->second->getConfig();
-        config.auto_start = false;
-        it->second->setConfig(config);
+        service->setAutoStart(false);
         
         return saveConfig();
     }
     
+    bool scaleService(const std::string& service_name, int instance_count) {
+        if (instance_count < 0) {
+            return false;
+        }
+        
+        bool success;
+        {
+            std::lock_guard<std::mutex> lock(scale_mutex_);
+            success = scaleLocked(service_name, instance_count);
+        }
+        return saveConfig() && success;
+    }
+    
+    std::vector<std::string> getServiceInstances(const std::string& service_name) const {
+        std::vector<std::string> instances;
+        std::lock_guard<std::mutex> lock(templates_mutex_);
+        auto it = templates_.find(service_name);
+        if (it == templates_.end()) {
+            return instances;
+        }
+        
+        for (int index = 0; index < it->second.instance_count; ++index) {
+            instances.push_back(makeInstanceName(service_name, index));
+        }
+        return instances;
+    }
+    
     bool startAllServices() {
-        // 按优先级排序服务
-        std::vector<std::string> service_names = getServiceNames();
-        std::sort(service_names.begin(), service_names.end(), [this](const std::string& a, const std::string& b) {
-            ServiceConfig config_a = getServiceConfig(a);
-            ServiceConfig config_b = getServiceConfig(b);
-            return static_cast<int>(config_a.priority) < static_cast<int>(config_b.priority);
+        std::vector<StartJob> jobs;
+        std::vector<StartJob> pessimistic_jobs;
+        std::vector<bool> learned;
+        for (const auto& pair : services_.entries()) {
+            ServiceConfig config = pair.second->getConfig();
+            if (!config.auto_start) {
+                continue;
+            }
+            
+            StartDurationStats stats;
+            bool known = history_.lookup(pair.first, stats);
+            auto expected = known ? std::chrono::milliseconds(static_cast<int64_t>(stats.ewma_ms))
+                                  : lastStartDuration(*pair.second);
+            auto pessimistic = known ? std::chrono::milliseconds(static_cast<int64_t>(stats.p95_ms)) : expected;
+            
+            // zygote就绪后才能从它fork，按依赖排序
+            std::vector<std::string> dependencies = config.dependencies;
+            if (!config.spawn_from.empty() &&
+                std::find(dependencies.begin(), dependencies.end(), config.spawn_from) == dependencies.end()) {
+                dependencies.push_back(config.spawn_from);
+            }
+            jobs.push_back(StartJob{pair.first, dependencies, config.priority, expected});
+            pessimistic_jobs.push_back(StartJob{pair.first, dependencies, config.priority, pessimistic});
+            learned.push_back(known);
+        }
+        
+        StartAdmissionPolicy policy;
+        std::string history_path;
+        {
+            std::lock_guard<std::mutex> lock(admission_mutex_);
+            policy = admission_policy_;
+            history_path = history_path_;
+            admission_log_.clear();
+        }
+        
+        StartAdmissionController controller(policy, [this](const std::string& decision) {
+            recordAdmissionDecision(decision);
         });
         
-        bool all_started = true;
-        for (const auto& name : service_names) {
-            ServiceConfig config = getServiceConfig(name);
-            if (config.auto_start) {
-                if (!startService(name)) {
-                    all_started = false;
-                }
+        BootPrediction prediction;
+        prediction.valid = true;
+        std::vector<std::chrono::milliseconds> predicted = controller.predictReadyTimes(jobs);
+        for (auto ready : predicted) {
+            prediction.predicted = std::max(prediction.predicted, ready);
+        }
+        for (auto ready : controller.predictReadyTimes(pessimistic_jobs)) {
+            prediction.predicted_p95 = std::max(prediction.predicted_p95, ready);
+        }
+        
+        // 所有自动启动服务在同一时刻被请求，之后的排队和等待都计入启动时间线
+        auto requested = std::chrono::steady_clock::now();
+        bool all_started = controller.run(jobs, [this, requested](const std::string& name) {
+            return startServiceAt(name, requested);
+        });
+        
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            auto service = services_.find(jobs[i].name);
+            ServiceStartupTiming timing = service ? service->getStartupTiming() : ServiceStartupTiming{};
+            auto actual = std::chrono::milliseconds(-1);
+            if (timing.completed && timing.requested == requested) {
+                actual = std::chrono::duration_cast<std::chrono::milliseconds>(timing.ready - requested);
+                prediction.actual = std::max(prediction.actual, actual);
             }
+            prediction.entries.push_back(BootPrediction::Entry{jobs[i].name, predicted[i], actual, learned[i]});
         }
         
+        {
+            std::lock_guard<std::mutex> lock(admission_mutex_);
+            last_boot_ = std::move(prediction);
+        }
+        if (!history_path.empty()) {
+            history_.save(history_path);
+        }
         return all_started;
     }
     
+    bool setStartHistoryFile(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(admission_mutex_);
+            history_path_ = path;
+        }
+        return history_.load(path);
+    }
+    
+    void setStartAdmissionPolicy(const StartAdmissionPolicy& policy) {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        admission_policy_ = policy;
+    }
+    
+    std::vector<std::string> getAdmissionLog() const {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        return std::vector<std::string>(admission_log_.begin(), admission_log_.end());
+    }
+    
     bool stopAllServices() {
-        bool all_stopped = true;
-        for (const auto& pair : services_) {
-            if (!pair.second->stop()) {
-                all_stopped = false;
-            }
+        std::vector<std::string> names;
+        for (const auto& pair : services_.entries()) {
+            names.push_back(pair.first);
         }
         
-        return all_stopped;
+        // 作为一个停止事务提交，依赖其他服务的先停止；各服务的失败原因见其状态
+        std::string error;
+        return jobs_.stop(names, [this](const std::string& name) { return stopUnit(name); }, error);
     }
     
     bool reloadConfig() {
@@ -598,53 +2272,161 @@ public:
     }
     
     void setStatusChangeCallback(std::function<void(const std::string&, ServiceState, ServiceState)> callback) {
-        status_change_callback_ = std::move(callback);
+        // 取消订阅会等待正在执行的回调，不能持有回调可能获取的callback_mutex_
+        std::lock_guard<std::mutex> lock(status_subscription_mutex_);
+        if (status_change_subscription_ != 0) {
+            subscriptions_.unsubscribe(status_change_subscription_);
+            status_change_subscription_ = 0;
+        }
+        if (callback) {
+            status_change_subscription_ = subscriptions_.subscribe(
+                [callback = std::move(callback)](const StatusChangeEvent& event) {
+                    callback(event.service, event.old_state, event.new_state);
+                }, StatusSubscriptionFilter());
+        }
+    }
+    
+    StatusSubscriptionId subscribeStatusChanges(std::function<void(const StatusChangeEvent&)> callback,
+                                                const StatusSubscriptionFilter& filter) {
+        return subscriptions_.subscribe(std::move(callback), filter);
+    }
+    
+    bool unsubscribeStatusChanges(StatusSubscriptionId id) {
+        return subscriptions_.unsubscribe(id);
     }
     
     void setErrorCallback(std::function<void(const std::string&, const std::string&)> callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
         error_callback_ = std::move(callback);
     }
     
+    // 服务由各自的监控线程和监管线程监督，管理器不再另开轮询线程
     void startMonitoring(int interval = 1000) {
-        monitoring_interval_ = interval;
-        
-        if (monitoring_running_) {
-            return;
+        (void)interval;
+    }
+    
+    void stopMonitoring() {
+    }
+    
+    bool startMetricsServer(const std::string& unix_socket_path, int http_port) {
+        return metrics_server_.start(unix_socket_path, http_port);
+    }
+    
+    void stopMetricsServer() {
+        metrics_server_.stop();
+    }
+    
+    bool startControlServer(const std::string& socket_path, const std::vector<uint32_t>& admin_uids,
+                            bool allow_unprivileged_status) {
+        ControlAccessPolicy policy;
+        policy.admin_uids = admin_uids;
+        policy.allow_unprivileged_status = allow_unprivileged_status;
+        return control_server_.start(socket_path, policy);
+    }
+    
+    void stopControlServer() {
+        control_server_.stop();
+    }
+    
+    bool startPressureMonitoring(const PressurePolicy& policy) {
+        return pressure_.start(policy, [this](PressureResource resource, bool under_pressure) {
+            if (under_pressure) {
+                shedServices(resource);
+            } else if (!pressure_.isUnderPressure(PressureResource::Memory) &&
+                       !pressure_.isUnderPressure(PressureResource::Cpu) &&
+                       !pressure_.isUnderPressure(PressureResource::Io)) {
+                restoreShedServices();
+            }
+        });
+    }
+    
+    void stopPressureMonitoring() {
+        pressure_.stop();
+        restoreShedServices();
+    }
+    
+    std::vector<std::string> getShedServices() const {
+        std::lock_guard<std::mutex> lock(shed_mutex_);
+        std::vector<std::string> names;
+        for (const auto& entry : shed_) {
+            names.push_back(entry.first);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+    
+    std::string getMetrics() const {
+        return metrics_.render(&supervisor_);
+    }
+    
+    std::vector<ServiceStartupTiming> getStartupTimings() const {
+        std::vector<ServiceStartupTiming> timings;
+        for (const auto& pair : services_.entries()) {
+            timings.push_back(pair.second->getStartupTiming());
         }
         
-        monitoring_running_ = true;
-        monitoring_thread_ = std::thread([this]() {
-            while (monitoring_running_) {
-                // 监控所有服务状态
-                for (const auto& pair : services_) {
-                    // 这里可以添加更详细的状态检查
-                    // 当前实现中服务已经自行监控
-                }
-                
-                std::this_thread::sleep_for(std::chrono::milliseconds(monitoring_interval_));
-            }
+        std::sort(timings.begin(), timings.end(), [](const ServiceStartupTiming& a, const ServiceStartupTiming& b) {
+            return a.requested < b.requested || (a.requested == b.requested && a.name < b.name);
         });
+        return timings;
     }
     
-    void stopMonitoring() {
-        monitoring_running_ = false;
-        if (monitoring_thread_.joinable()) {
-            monitoring_thread_.join();
+    std::string generateCriticalChainReport() const {
+        std::string report = formatCriticalChainReport(getStartupTimings());
+        
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        if (last_boot_.valid) {
+            report += "\n" + formatBootPrediction(last_boot_);
+        }
+        return report;
+    }
+    
+    bool setJournalFile(const std::string& path, size_t capacity) {
+        // 服务可能正在并发写入，已打开的日志不能重新映射
+        std::lock_guard<std::mutex> lock(journal_mutex_);
+        if (journal_.isOpen()) {
+            return false;
+        }
+        return journal_.open(path, capacity);
+    }
+    
+    std::vector<JournalEvent> queryJournal(const JournalQuery& query) const {
+        return journal_.query(query);
+    }
+    
+    bool exportStartupTrace(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            return false;
         }
+        
+        file << formatStartupTrace(getStartupTimings());
+        return file.good();
     }
     
     bool saveServiceState(const std::string& filename) const {
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
         try {
             std::ofstream file(filename);
             if (!file.is_open()) {
                 return false;
             }
             
+            // 交接存储只保留最近一次保存的描述符，与状态文件中的编号对应
+            fd_store_.clear();
+            
+            #ifndef _WIN32
+                file << "[manager]" << std::endl;
+                file << "pid=" << getpid() << std::endl;
+                file << std::endl;
+            #endif
+            
             // 简单的文本格式保存
-            for (const auto& pair : services_) {
+            for (const auto& pair : services_.entries()) {
                 const auto& service = pair.second;
                 ServiceConfig config = service->getConfig();
                 ServiceStatus status = service->getStatus();
+                ProcessHandoff handoff = service->exportHandoff(fd_store_, pair.first);
                 
                 file << "[service_state]" << std::endl;
                 file << "name=" << config.name << std::endl;
@@ -652,16 +2434,27 @@ public:
                 file << "pid=" << status.pid << std::endl;
                 file << "restart_count=" << status.restart_count << std::endl;
                 file << "auto_start=" << (config.auto_start ? "true" : "false") << std::endl;
+                if (handoff.pid != -1) {
+                    file << "start_ticks=" << handoff.start_ticks << std::endl;
+                    file << "start_time=" << std::chrono::duration_cast<std::chrono::milliseconds>(
+                        handoff.start_time.time_since_epoch()).count() << std::endl;
+                    file << "paused=" << (handoff.paused ? "true" : "false") << std::endl;
+                    file << "pidfd=" << handoff.pidfd << std::endl;
+                    file << "output_fd=" << handoff.output_fd << std::endl;
+                    file << "heartbeat_fd=" << handoff.heartbeat_fd << std::endl;
+                }
                 file << std::endl;
             }
             
-            return true;
+            file.flush();
+            return file.good();
         } catch (const std::exception& e) {
             return false;
         }
     }
     
     bool restoreServiceState(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
         try {
             std::ifstream file(filename);
             if (!file.is_open()) {
@@ -671,15 +2464,51 @@ public:
             // 读取文件内容
             std::string content((std::istreambuf_iterator<char>(file)), 
                                std::istreambuf_iterator<char>());
+            auto sections = parseStateSections(content);
             
-            // 简单的配置解析
-            auto config_map = parseSimpleConfig(content);
+            // 状态文件由同一进程在exec前写入时，其中的描述符编号才是继承下来的描述符
+            bool inherited = false;
+            #ifndef _WIN32
+                for (const auto& section : sections) {
+                    if (section.first == "manager") {
+                        inherited = stateInt(section.second, "pid", -1) == static_cast<int>(getpid());
+                    }
+                }
+            #endif
             
-            // 简化实现：启动所有自动启动的服务
-            for (const auto& pair : services_) {
-                ServiceConfig config = pair.second->getConfig();
-                if (config.auto_start) {
-                    pair.second->start();
+            std::set<std::string> restored;
+            auto requested = std::chrono::steady_clock::now();
+            for (const auto& section : sections) {
+                if (section.first != "service_state") {
+                    continue;
+                }
+                
+                const auto& values = section.second;
+                auto name = values.find("name");
+                if (name == values.end() || !services_.find(name->second)) {
+                    continue;
+                }
+                restored.insert(name->second);
+                
+                ServiceState state = static_cast<ServiceState>(stateInt(values, "state", 0));
+                if (state == ServiceState::Running && adoptProcess(name->second, values, inherited)) {
+                    continue;
+                }
+                
+                // 进程已不存在：原先在运行的服务和自动启动的服务重新启动
+                auto service = services_.find(name->second);
+                if (service && (state == ServiceState::Running || service->getConfig().auto_start)) {
+                    startServiceAt(name->second, requested);
+                }
+            }
+            
+            // 未被接管的继承描述符属于已不存在的服务或进程
+            fd_store_.clear();
+            
+            // 状态文件中没有记录的服务按自动启动配置启动
+            for (const auto& pair : services_.entries()) {
+                if (restored.count(pair.first) == 0 && pair.second->getConfig().auto_start) {
+                    startServiceAt(pair.first, requested);
                 }
             }
             
@@ -688,11 +2517,43 @@ public:
             return false;
         }
     }
+    
+    bool reexec(const std::string& state_file, const std::vector<std::string>& args) {
+        #ifdef _WIN32
+            (void)state_file;
+            (void)args;
+            return false; // 当前平台不支持
+        #else
+            if (!saveServiceState(state_file)) {
+                return false;
+            }
+            
+            std::vector<char*> argv;
+            for (const auto& arg : args) {
+                argv.push_back(const_cast<char*>(arg.c_str()));
+            }
+            argv.push_back(nullptr);
+            
+            // 清除CLOEXEC到exec之间不能有服务fork，否则子进程会继承交接存储中的描述符
+            std::unique_lock<std::shared_mutex> spawn_lock(ServiceFdStore::spawnMutex());
+            if (fd_store_.preserveForExec()) {
+                execv("/proc/self/exe", argv.data());
+            }
+            fd_store_.restoreCloseOnExec();
+            return false;
+        #endif
+    }
 
 private:
     bool loadConfig() {
-        // 简化实现：从固定文件加载配置
-        const std::string config_file = "/etc/cloudflow/services.conf";
+        std::string config_file;
+        {
+            std::lock_guard<std::mutex> lock(config_file_mutex_);
+            config_file = config_file_;
+        }
+        if (config_file.empty()) {
+            return true;
+        }
         
         try {
             std::ifstream file(config_file);
@@ -716,20 +2577,35 @@ private:
     }
     
     bool saveConfig() {
-        // 简化实现：保存到固定文件
-        const std::string config_file = "/etc/cloudflow/services.conf";
+        // 并发注册时串行化配置文件写入
+        std::lock_guard<std::mutex> lock(config_file_mutex_);
+        if (config_file_.empty()) {
+            return true;
+        }
         
         try {
-            std::ofstream file(config_file);
+            std::ofstream file(config_file_);
             if (!file.is_open()) {
                 return false;
             }
             
+            // 实例由模板生成，只保存模板
+            std::vector<ServiceConfig> configs;
+            {
+                std::lock_guard<std::mutex> templates_lock(templates_mutex_);
+                for (const auto& pair : templates_) {
+                    configs.push_back(pair.second.config);
+                }
+            }
+            for (const auto& pair : services_.entries()) {
+                ServiceConfig config = pair.second->getConfig();
+                if (config.instance_index < 0) {
+                    configs.push_back(std::move(config));
+                }
+            }
+            
             // 简单的文本格式保存
-            for (const auto& pair : services_) {
-                const auto& service = pair.second;
-                ServiceConfig config = service->getConfig();
-                
+            for (const auto& config : configs) {
                 file << "[service]" << std::endl;
                 file << "name=" << config.name << std::endl;
                 file << "description=" << config.description << std::endl;
@@ -738,6 +2614,24 @@ private:
                 file << "restart_delay=" << config.restart_delay << std::endl;
                 file << "max_restart_attempts=" << config.max_restart_attempts << std::endl;
                 file << "working_directory=" << config.working_directory << std::endl;
+                if (config.zygote) {
+                    file << "zygote=true" << std::endl;
+                }
+                if (!config.spawn_from.empty()) {
+                    file << "spawn_from=" << config.spawn_from << std::endl;
+                }
+                if (config.warm_standby) {
+                    file << "warm_standby=true" << std::endl;
+                }
+                for (const auto& limit : config.io_limits) {
+                    file << "io_limit=" << limit.device << " rbps=" << limit.read_bps << " wbps=" << limit.write_bps
+                         << " riops=" << limit.read_iops << " wiops=" << limit.write_iops << std::endl;
+                }
+                if (config.instances.mode != InstanceMode::Single) {
+                    file << "instance_mode=" << static_cast<int>(config.instances.mode) << std::endl;
+                    file << "instance_count=" << config.instances.count << std::endl;
+                    file << "listen_port=" << config.instances.listen_port << std::endl;
+                }
                 file << std::endl;
             }
             
@@ -773,12 +2667,455 @@ private:
         return true;
     }
     
-    std::unordered_map<std::string, std::unique_ptr<Service>> services_;
-    std::function<void(const std::string&, ServiceState, ServiceState)> status_change_callback_;
+    enum class ShedAction {
+        Paused,
+        Stopped
+    };
+    
+    /**
+     * @brief 多实例服务模板
+     */
+    struct ServiceTemplate {
+        ServiceConfig config;
+        int instance_count;         ///< 当前实例数，实例序号为[0, instance_count)
+    };
+    
+    bool addService(const ServiceConfig& config) {
+        auto service = std::make_shared<Service>(config);
+        service->setSupervisor(&supervisor_);
+        service->setWatchdog(&watchdog_);
+        service->setProcessTree(&process_tree_);
+        service->setJournal(&journal_);
+        service->setGeneration(&generation_);
+        service->setZygoteLookup([this](const std::string& name) -> std::shared_ptr<ZygoteClient> {
+            auto zygote = services_.find(name);
+            if (!zygote || zygote->getState() != ServiceState::Running) {
+                return nullptr;
+            }
+            return zygote->getZygoteClient();
+        });
+        // 回调保存在服务自身中，捕获裸指针不会悬空
+        Service* raw = service.get();
+        service->setStatusChangeCallback([this, raw, name = config.name](ServiceState old_state, ServiceState new_state,
+                                                                         std::chrono::system_clock::time_point timestamp) {
+            control_server_.publish(ControlEvent{name, old_state, new_state});
+            subscriptions_.publish(StatusChangeEvent{name, raw->getSharedConfig()->type, old_state, new_state, timestamp, 0});
+        });
+        
+        service->setErrorCallback([this, name = config.name](const std::string& error) {
+            auto callback = getErrorCallback();
+            if (callback) {
+                callback(name, error);
+            }
+        });
+        
+        if (!services_.insert(config.name, service)) {
+            return false;
+        }
+        service->setMetricsSlot(metrics_.acquire(config.name));
+        generation_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+    
+    bool removeService(const std::string& service_name) {
+        // 先从注册表移除，其他线程持有的引用在停止后自然释放
+        auto service = services_.erase(service_name);
+        if (!service) {
+            return false;
+        }
+        
+        generation_.fetch_add(1, std::memory_order_release);
+        service->stop();
+        metrics_.release(service->detachMetricsSlot());
+        return true;
+    }
+    
+    bool isTemplate(const std::string& service_name) const {
+        std::lock_guard<std::mutex> lock(templates_mutex_);
+        return templates_.count(service_name) != 0;
+    }
+    
+    bool registerTemplate(const ServiceConfig& config) {
+        // '@'用于分隔模板名称和实例序号
+        if (config.name.empty() || config.name.find('@') != std::string::npos) {
+            return false;
+        }
+        
+        std::vector<std::vector<int>> placements = computeInstancePlacements(config.instances.mode);
+        int instance_count = defaultInstanceCount(config, placements);
+        
+        bool success;
+        {
+            std::lock_guard<std::mutex> lock(scale_mutex_);
+            {
+                std::lock_guard<std::mutex> templates_lock(templates_mutex_);
+                if (templates_.count(config.name) != 0 || services_.find(config.name)) {
+                    return false; // 服务已存在
+                }
+                templates_[config.name] = ServiceTemplate{config, 0};
+            }
+            success = scaleLocked(config.name, instance_count);
+        }
+        return saveConfig() && success;
+    }
+    
+    // 调用方需持有scale_mutex_；templates_mutex_只在读写模板时短暂持有，不阻塞启停查询
+    bool scaleLocked(const std::string& service_name, int instance_count) {
+        ServiceTemplate current;
+        {
+            std::lock_guard<std::mutex> lock(templates_mutex_);
+            auto it = templates_.find(service_name);
+            if (it == templates_.end()) {
+                return false;
+            }
+            current = it->second;
+        }
+        
+        auto setCount = [this, &service_name](int count) {
+            std::lock_guard<std::mutex> lock(templates_mutex_);
+            auto it = templates_.find(service_name);
+            if (it != templates_.end()) {
+                it->second.instance_count = count;
+                it->second.config.instances.count = count;
+            }
+        };
+        
+        // 缩容：先从实例列表中移除，再停止序号最大的实例
+        for (int index = current.instance_count - 1; index >= instance_count; --index) {
+            setCount(index);
+            removeService(makeInstanceName(service_name, index));
+        }
+        
+        // 扩容：已有实例在运行时新实例随即启动
+        bool running = false;
+        for (int index = 0; index < std::min(current.instance_count, instance_count) && !running; ++index) {
+            running = isServiceRunning(makeInstanceName(service_name, index));
+        }
+        
+        std::vector<std::vector<int>> placements = computeInstancePlacements(current.config.instances.mode);
+        auto requested = std::chrono::steady_clock::now();
+        bool success = true;
+        for (int index = current.instance_count; index < instance_count; ++index) {
+            if (!addService(makeInstanceConfig(current.config, index, placements))) {
+                return false; // 与已注册的普通服务重名
+            }
+            setCount(index + 1);
+            
+            if (running && !startServiceAt(makeInstanceName(service_name, index), requested)) {
+                success = false;
+            }
+        }
+        
+        return success;
+    }
+    
+    void recordAdmissionDecision(const std::string& decision) {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        if (admission_log_.size() >= kMaxAdmissionLogEntries) {
+            admission_log_.pop_front();
+        }
+        admission_log_.push_back(decision);
+    }
+    
+    void reportError(const std::string& service_name, const std::string& error) {
+        auto callback = getErrorCallback();
+        if (callback && !error.empty()) {
+            callback(service_name, error);
+        }
+    }
+    
+    // 停止作业执行的单个服务停止
+    bool stopUnit(const std::string& name) {
+        auto service = services_.find(name);
+        if (!service) {
+            return false;
+        }
+        
+        // 显式停止的服务在压力解除后不再自动恢复
+        {
+            std::lock_guard<std::mutex> lock(shed_mutex_);
+            shed_.erase(name);
+        }
+        return service->stop();
+    }
+    
+    // 作业引擎查询服务信息，依赖与批量启动相同，包含spawn_from指定的zygote
+    bool describeUnit(const std::string& name, ServiceJobEngine::UnitInfo& info) const {
+        auto service = services_.find(name);
+        if (!service) {
+            return false;
+        }
+        
+        std::shared_ptr<const ServiceConfig> config = service->getSharedConfig();
+        info.dependencies = config->dependencies;
+        if (!config->spawn_from.empty() &&
+            std::find(info.dependencies.begin(), info.dependencies.end(), config->spawn_from) == info.dependencies.end()) {
+            info.dependencies.push_back(config->spawn_from);
+        }
+        info.priority = config->priority;
+        
+        StartDurationStats stats;
+        info.expected = history_.lookup(name, stats) ? std::chrono::milliseconds(static_cast<int64_t>(stats.ewma_ms))
+                                                     : lastStartDuration(*service);
+        
+        ServiceState state = service->getState();
+        info.active = state == ServiceState::Running || state == ServiceState::Starting;
+        return true;
+    }
+    
+    // 作业引擎的启动事务与批量启动共用准入控制，不清空准入日志。
+    // 停止作业能缓解压力，不因压力暂缓，也不写入准入日志
+    bool scheduleJobs(const std::vector<StartJob>& jobs, const StartAdmissionController::Starter& action, bool stopping) {
+        StartAdmissionPolicy policy;
+        {
+            std::lock_guard<std::mutex> lock(admission_mutex_);
+            policy = admission_policy_;
+        }
+        
+        if (stopping) {
+            policy.max_concurrent_starts = static_cast<int>(std::min(jobs.size(), kMaxConcurrentStops));
+            policy.cpu_pressure_limit = 0.0;
+            policy.io_pressure_limit = 0.0;
+            return StartAdmissionController(policy, nullptr).run(jobs, action);
+        }
+        
+        StartAdmissionController controller(policy, [this](const std::string& decision) {
+            recordAdmissionDecision(decision);
+        });
+        return controller.run(jobs, action);
+    }
+    
+    // 记录启动请求时间和依赖就绪时间后启动服务
+    bool startServiceAt(const std::string& service_name, std::chrono::steady_clock::time_point requested) {
+        auto service = services_.find(service_name);
+        if (!service) {
+            return false;
+        }
+        
+        auto dependencies_ready = requested;
+        for (const auto& dependency : service->getConfig().dependencies) {
+            auto dependency_service = services_.find(dependency);
+            if (!dependency_service) {
+                continue;
+            }
+            
+            ServiceStartupTiming timing = dependency_service->getStartupTiming();
+            if (timing.completed) {
+                dependencies_ready = std::max(dependencies_ready, timing.ready);
+            }
+        }
+        
+        service->markStartRequested(requested, dependencies_ready);
+        if (!service->start()) {
+            return false;
+        }
+        
+        ServiceStartupTiming timing = service->getStartupTiming();
+        if (timing.completed) {
+            history_.record(service_name, std::chrono::duration_cast<std::chrono::milliseconds>(timing.ready - timing.spawned));
+        }
+        return true;
+    }
+    
+    // 压力回调在压力监控的工作线程上串行执行
+    void shedServices(PressureResource resource) {
+        // 内存压力下暂停进程不会释放内存，需要停止；CPU和IO压力下暂停即可，恢复时保留进程状态
+        bool stop = resource == PressureResource::Memory;
+        
+        for (const auto& pair : services_.entries()) {
+            const auto& service = pair.second;
+            ServicePriority priority = service->getConfig().priority;
+            if (priority != ServicePriority::Low && priority != ServicePriority::Idle) {
+                continue;
+            }
+            if (service->getState() != ServiceState::Running) {
+                continue;
+            }
+            
+            bool shed = stop ? service->stop() : service->pause();
+            if (shed) {
+                std::lock_guard<std::mutex> lock(shed_mutex_);
+                shed_[pair.first] = stop ? ShedAction::Stopped : ShedAction::Paused;
+            }
+        }
+    }
+    
+    void restoreShedServices() {
+        std::unordered_map<std::string, ShedAction> shed;
+        {
+            std::lock_guard<std::mutex> lock(shed_mutex_);
+            shed.swap(shed_);
+        }
+        
+        // 先恢复高优先级的Low服务，再恢复Idle服务
+        std::vector<std::pair<ServicePriority, std::string>> order;
+        for (const auto& entry : shed) {
+            auto service = services_.find(entry.first);
+            if (service) {
+                order.emplace_back(service->getConfig().priority, entry.first);
+            }
+        }
+        std::sort(order.begin(), order.end());
+        
+        auto requested = std::chrono::steady_clock::now();
+        for (const auto& entry : order) {
+            auto service = services_.find(entry.second);
+            if (!service) {
+                continue;
+            }
+            if (shed[entry.second] == ShedAction::Paused) {
+                service->resume();
+            } else if (service->getState() == ServiceState::Stopped) {
+                startServiceAt(entry.second, requested);
+            }
+        }
+    }
+    
+    // 按状态文件接管仍在运行的服务进程，PID和启动时刻都一致时才接管
+    bool adoptProcess(const std::string& name, const std::map<std::string, std::string>& values, bool inherited) {
+        ProcessHandoff handoff;
+        handoff.pid = stateInt(values, "pid", -1);
+        handoff.restart_count = stateInt(values, "restart_count", 0);
+        auto ticks = values.find("start_ticks");
+        if (handoff.pid <= 0 || ticks == values.end()) {
+            return false;
+        }
+        handoff.start_ticks = std::strtoull(ticks->second.c_str(), nullptr, 10);
+        auto start_time = values.find("start_time");
+        if (start_time != values.end()) {
+            handoff.start_time = std::chrono::system_clock::time_point(
+                std::chrono::milliseconds(std::strtoll(start_time->second.c_str(), nullptr, 10)));
+        }
+        auto paused = values.find("paused");
+        handoff.paused = paused != values.end() && paused->second == "true";
+        
+        if (inherited) {
+            const std::pair<const char*, const char*> kinds[] = {
+                {"pidfd", "/pidfd"}, {"output_fd", "/output"}, {"heartbeat_fd", "/heartbeat"}
+            };
+            for (const auto& kind : kinds) {
+                fd_store_.adopt(name + kind.second, stateInt(values, kind.first, -1));
+            }
+            handoff.pidfd = fd_store_.take(name + "/pidfd");
+            handoff.output_fd = fd_store_.take(name + "/output");
+            handoff.heartbeat_fd = fd_store_.take(name + "/heartbeat");
+        }
+        
+        // 继承的pidfd始终指向原进程，只需确认其未退出；否则重新打开并核对启动时刻
+        bool alive;
+        if (handoff.pidfd != -1) {
+            alive = !pidfdExited(handoff.pidfd) && readProcessStartTicks(handoff.pid) == handoff.start_ticks;
+        } else {
+            alive = verifyProcess(handoff.pid, handoff.start_ticks, handoff.pidfd);
+        }
+        
+        auto service = services_.find(name);
+        if (!alive || !service) {
+            handoff.closeDescriptors();
+            return false;
+        }
+        return service->adopt(handoff);
+    }
+    
+    // 没有历史记录时以本进程内上一次启动的耗时作为估计，尚未启动过时为0
+    static std::chrono::milliseconds lastStartDuration(const Service& service) {
+        ServiceStartupTiming timing = service.getStartupTiming();
+        if (!timing.completed) {
+            return std::chrono::milliseconds(0);
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(timing.ready - timing.spawned);
+    }
+    
+    ControlResult executeControlCommand(const ControlCommand& command) {
+        ControlResult result{ControlError::None, ServiceState::Unknown, 0, 0};
+        if (!isTemplate(command.service_name) && !services_.find(command.service_name)) {
+            result.error = ControlError::NotFound;
+            return result;
+        }
+        
+        bool success = true;
+        switch (command.operation) {
+            case ControlOperation::Start:
+                success = startService(command.service_name);
+                break;
+            case ControlOperation::Stop:
+                success = stopService(command.service_name);
+                break;
+            case ControlOperation::Restart:
+                success = restartService(command.service_name);
+                break;
+            case ControlOperation::Status:
+                break;
+        }
+        
+        // 模板报告第一个未运行的实例，全部运行时报告第一个实例；没有实例时为已停止
+        ServiceStatus status{ServiceState::Stopped, -1, {}, {}, 0, "", 0, 0.0, {}};
+        std::vector<std::string> names = getServiceInstances(command.service_name);
+        if (names.empty()) {
+            names.push_back(command.service_name);
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            auto service = services_.find(names[i]);
+            if (!service) {
+                continue;
+            }
+            ServiceStatus current = service->getStatus();
+            if (i == 0 || current.state != ServiceState::Running) {
+                status = current;
+            }
+            if (current.state != ServiceState::Running) {
+                break;
+            }
+        }
+        
+        result.error = success ? ControlError::None : ControlError::Failed;
+        result.state = status.state;
+        result.pid = status.pid;
+        result.restart_count = static_cast<uint32_t>(status.restart_count);
+        return result;
+    }
+    
+    std::function<void(const std::string&, const std::string&)> getErrorCallback() const {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        return error_callback_;
+    }
+    
+    ServiceMetricsRegistry metrics_;    ///< 以下六者需先于服务构造、后于服务析构
+    ServiceSupervisor supervisor_;
+    ServiceWatchdog watchdog_;
+    MetricsServer metrics_server_;
+    ServiceControlServer control_server_;
+    StatusSubscriptionHub subscriptions_;           ///< 先于服务声明，服务的监控线程结束后才销毁
+    PressureMonitor pressure_;
+    ServiceProcessTree process_tree_;
+    ServiceJournal journal_;
+    mutable std::mutex journal_mutex_;
+    ShardedRegistry<Service> services_;
+    ServiceJobEngine jobs_;                         ///< 单个服务的启动和停止请求
+    std::atomic<uint64_t> generation_;              ///< 服务注册、状态或配置变化时递增
+    mutable std::mutex snapshot_mutex_;
+    mutable std::shared_ptr<const ServiceSnapshot> snapshot_;   ///< 最近一次生成的快照，受snapshot_mutex_保护
+    std::mutex config_file_mutex_;
+    std::string config_file_;           ///< 服务配置文件，为空时不读取也不保存；受config_file_mutex_保护
+    std::mutex scale_mutex_;            ///< 串行化模板的注册、扩缩容和注销
+    mutable std::mutex templates_mutex_;
+    std::unordered_map<std::string, ServiceTemplate> templates_;
+    static constexpr size_t kMaxAdmissionLogEntries = 1024;
+    
+    mutable std::mutex admission_mutex_;
+    StartAdmissionPolicy admission_policy_;
+    std::deque<std::string> admission_log_; ///< 最近一次批量启动的准入决策
+    std::string history_path_;
+    BootPrediction last_boot_;
+    StartDurationHistory history_;
+    mutable std::mutex handoff_mutex_;
+    mutable ServiceFdStore fd_store_;   ///< 管理器交接时传递给新映像的描述符
+    mutable std::mutex shed_mutex_;
+    std::unordered_map<std::string, ShedAction> shed_; ///< 因压力被卸载的服务
+    mutable std::mutex callback_mutex_;
+    std::mutex status_subscription_mutex_;
+    StatusSubscriptionId status_change_subscription_;   ///< setStatusChangeCallback()对应的订阅，受status_subscription_mutex_保护
     std::function<void(const std::string&, const std::string&)> error_callback_;
-    std::thread monitoring_thread_;
-    int monitoring_interval_;
-    bool monitoring_running_;
 };
 
 // ServiceManager 公共接口实现
@@ -787,6 +3124,7 @@ ServiceManager::ServiceManager() : impl_(new Impl()) {}
 ServiceManager::~ServiceManager() = default;
 
 bool ServiceManager::initialize() { return impl_->initialize(); }
+void ServiceManager::setConfigFile(const std::string& path) { impl_->setConfigFile(path); }
 bool ServiceManager::registerService(const ServiceConfig& config) { return impl_->registerService(config); }
 bool ServiceManager::unregisterService(const std::string& service_name) { return impl_->unregisterService(service_name); }
 bool ServiceManager::startService(const std::string& service_name) { return impl_->startService(service_name); }
@@ -795,19 +3133,45 @@ bool ServiceManager::restartService(const std::string& service_name) { return im
 ServiceStatus ServiceManager::getServiceStatus(const std::string& service_name) const { return impl_->getServiceStatus(service_name); }
 bool ServiceManager::isServiceRunning(const std::string& service_name) const { return impl_->isServiceRunning(service_name); }
 std::vector<std::string> ServiceManager::getServiceNames() const { return impl_->getServiceNames(); }
+std::vector<int> ServiceManager::getServiceProcesses(const std::string& service_name) const { return impl_->getServiceProcesses(service_name); }
 ServiceConfig ServiceManager::getServiceConfig(const std::string& service_name) const { return impl_->getServiceConfig(service_name); }
+std::shared_ptr<const ServiceSnapshot> ServiceManager::getSnapshot() const { return impl_->getSnapshot(); }
+uint64_t ServiceManager::getGeneration() const { return impl_->getGeneration(); }
+std::vector<std::string> ServiceManager::tailServiceLog(const std::string& service_name, size_t max_lines) const { return impl_->tailServiceLog(service_name, max_lines); }
 bool ServiceManager::setServiceConfig(const std::string& service_name, const ServiceConfig& config) { return impl_->setServiceConfig(service_name, config); }
+bool ServiceManager::setServiceIoLimits(const std::string& service_name, const std::vector<ServiceIoLimit>& limits) { return impl_->setServiceIoLimits(service_name, limits); }
 bool ServiceManager::enableService(const std::string& service_name) { return impl_->enableService(service_name); }
 bool ServiceManager::disableService(const std::string& service_name) { return impl_->disableService(service_name); }
+bool ServiceManager::scaleService(const std::string& service_name, int instance_count) { return impl_->scaleService(service_name, instance_count); }
+std::vector<std::string> ServiceManager::getServiceInstances(const std::string& service_name) const { return impl_->getServiceInstances(service_name); }
+void ServiceManager::setStartAdmissionPolicy(const StartAdmissionPolicy& policy) { impl_->setStartAdmissionPolicy(policy); }
+std::vector<std::string> ServiceManager::getAdmissionLog() const { return impl_->getAdmissionLog(); }
+bool ServiceManager::setStartHistoryFile(const std::string& path) { return impl_->setStartHistoryFile(path); }
 bool ServiceManager::startAllServices() { return impl_->startAllServices(); }
 bool ServiceManager::stopAllServices() { return impl_->stopAllServices(); }
 bool ServiceManager::reloadConfig() { return impl_->reloadConfig(); }
 void ServiceManager::setStatusChangeCallback(std::function<void(const std::string&, ServiceState, ServiceState)> callback) { impl_->setStatusChangeCallback(std::move(callback)); }
+StatusSubscriptionId ServiceManager::subscribeStatusChanges(std::function<void(const StatusChangeEvent&)> callback, const StatusSubscriptionFilter& filter) { return impl_->subscribeStatusChanges(std::move(callback), filter); }
+bool ServiceManager::unsubscribeStatusChanges(StatusSubscriptionId id) { return impl_->unsubscribeStatusChanges(id); }
 void ServiceManager::setErrorCallback(std::function<void(const std::string&, const std::string&)> callback) { impl_->setErrorCallback(std::move(callback)); }
 void ServiceManager::startMonitoring(int interval) { impl_->startMonitoring(interval); }
 void ServiceManager::stopMonitoring() { impl_->stopMonitoring(); }
+bool ServiceManager::startMetricsServer(const std::string& unix_socket_path, int http_port) { return impl_->startMetricsServer(unix_socket_path, http_port); }
+void ServiceManager::stopMetricsServer() { impl_->stopMetricsServer(); }
+bool ServiceManager::startControlServer(const std::string& socket_path, const std::vector<uint32_t>& admin_uids, bool allow_unprivileged_status) { return impl_->startControlServer(socket_path, admin_uids, allow_unprivileged_status); }
+void ServiceManager::stopControlServer() { impl_->stopControlServer(); }
+bool ServiceManager::startPressureMonitoring(const PressurePolicy& policy) { return impl_->startPressureMonitoring(policy); }
+void ServiceManager::stopPressureMonitoring() { impl_->stopPressureMonitoring(); }
+std::vector<std::string> ServiceManager::getShedServices() const { return impl_->getShedServices(); }
+std::string ServiceManager::getMetrics() const { return impl_->getMetrics(); }
+std::vector<ServiceStartupTiming> ServiceManager::getStartupTimings() const { return impl_->getStartupTimings(); }
+std::string ServiceManager::generateCriticalChainReport() const { return impl_->generateCriticalChainReport(); }
+bool ServiceManager::exportStartupTrace(const std::string& filename) const { return impl_->exportStartupTrace(filename); }
+bool ServiceManager::setJournalFile(const std::string& path, size_t capacity) { return impl_->setJournalFile(path, capacity); }
+std::vector<JournalEvent> ServiceManager::queryJournal(const JournalQuery& query) const { return impl_->queryJournal(query); }
 bool ServiceManager::saveServiceState(const std::string& filename) const { return impl_->saveServiceState(filename); }
 bool ServiceManager::restoreServiceState(const std::string& filename) { return impl_->restoreServiceState(filename); }
+bool ServiceManager::reexec(const std::string& state_file, const std::vector<std::string>& args) { return impl_->reexec(state_file, args); }
 
 } // namespace System
 } // namespace CloudFlow
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include <functional>
 #include <chrono>
+#include <cstdint>
 
 namespace CloudFlow {
 namespace System {
@@ -58,6 +59,95 @@ enum class ServicePriority {
     Idle = 4        ///< 空闲优先级（最后启动）
 };
 
+/**
+ * @brief 服务输出日志配置
+ */
+struct ServiceLogConfig {
+    bool capture_output = true;         ///< 是否捕获标准输出和标准错误
+    size_t buffer_size = 64 * 1024;     ///< 内存环形缓冲区大小（字节）
+    size_t rate_limit = 256 * 1024;     ///< 限速（字节/秒），0表示不限速
+    size_t rate_burst = 1024 * 1024;    ///< 限速突发容量（字节）
+    std::string file_path;              ///< 日志文件路径，为空时只保留在内存中
+    size_t max_file_size = 8 * 1024 * 1024; ///< 单个日志文件最大大小（字节）
+    int max_files = 3;                  ///< 轮转保留的历史文件数
+};
+
+/**
+ * @brief 多实例模式
+ */
+enum class InstanceMode {
+    Single,         ///< 单实例
+    Fixed,          ///< 固定实例数
+    PerCpu,         ///< 每个CPU一个实例，并绑定到该CPU
+    PerNumaNode     ///< 每个NUMA节点一个实例，并绑定到该节点的CPU
+};
+
+/**
+ * @brief 多实例配置
+ *
+ * 多实例服务注册为模板，实例以"名称@序号"注册。实例配置中的以下占位符会被替换：
+ * %n 模板名称，%N 实例名称，%i 实例序号，%c 绑定的CPU列表，%% 百分号。
+ * 替换作用于参数、环境变量值、工作目录和日志文件路径
+ */
+struct ServiceInstanceConfig {
+    InstanceMode mode = InstanceMode::Single; ///< 实例模式
+    int count = 0;                      ///< 实例数，0表示按模式推导（Fixed时为1）
+    int listen_port = 0;                ///< 以SO_REUSEPORT为每个实例创建的TCP监听端口，0表示不创建
+    std::string listen_address = "0.0.0.0"; ///< 监听地址
+};
+
+/**
+ * @brief 压力资源类型
+ */
+enum class PressureResource {
+    Memory = 0,     ///< 内存
+    Cpu = 1,        ///< CPU
+    Io = 2          ///< IO
+};
+
+/**
+ * @brief 压力卸载策略
+ *
+ * 阈值对应PSI触发器的"some"停顿时间：窗口内有任务因该资源停顿累计超过阈值即视为压力出现，
+ * 阈值为0表示不监控该资源。压力出现时低优先级（Low和Idle）服务被卸载：
+ * 内存压力下停止以释放内存，CPU和IO压力下以SIGSTOP暂停，
+ * 全部资源的10秒平均停顿比例回落到恢复阈值以下并保持一段时间后恢复
+ */
+struct PressurePolicy {
+    int memory_stall_us = 100000;       ///< 内存停顿阈值（微秒/窗口）
+    int cpu_stall_us = 500000;          ///< CPU停顿阈值（微秒/窗口）
+    int io_stall_us = 500000;           ///< IO停顿阈值（微秒/窗口）
+    int window_us = 1000000;            ///< 触发窗口（微秒），内核要求在0.5秒到10秒之间
+    double recovery_avg10 = 5.0;        ///< 恢复阈值，10秒平均停顿百分比
+    int recovery_hold_ms = 10000;       ///< 最近一次触发后至少保持的时间（毫秒）
+};
+
+/**
+ * @brief 启动准入策略
+ *
+ * 批量启动时依赖就绪的服务按优先级和剩余关键路径长度排序，在并发预算内启动；
+ * 压力门限对应PSI中"some"的10秒平均停顿百分比，超过时暂缓放行非关键服务
+ */
+struct StartAdmissionPolicy {
+    int max_concurrent_starts = 0;      ///< 同时进行的启动数上限，0表示等于CPU数
+    double cpu_pressure_limit = 0.0;    ///< CPU压力门限（百分比），0表示不检查
+    double io_pressure_limit = 0.0;     ///< IO压力门限（百分比），0表示不检查
+    int pressure_retry_ms = 100;        ///< 因压力暂缓后重新检查的间隔（毫秒）
+};
+
+/**
+ * @brief 块设备I/O限制
+ *
+ * 写入服务cgroup的io.max，需要cgroup v2的io控制器；分区按其所在的整盘限制，各项为0表示不限制
+ */
+struct ServiceIoLimit {
+    std::string device;                 ///< 块设备路径（如/dev/sda）或"主:次"设备号
+    uint64_t read_bps = 0;              ///< 读带宽（字节/秒）
+    uint64_t write_bps = 0;             ///< 写带宽（字节/秒）
+    uint64_t read_iops = 0;             ///< 每秒读操作数
+    uint64_t write_iops = 0;            ///< 每秒写操作数
+};
+
 /**
  * @brief 服务配置信息
  */
@@ -74,6 +164,31 @@ struct ServiceConfig {
     int max_restart_attempts;       ///< 最大重启尝试次数
     std::string working_directory;  ///< 工作目录
     std::unordered_map<std::string, std::string> environment; ///< 环境变量
+    int shutdown_timeout = 5000;    ///< 停止超时（毫秒），超时后强制终止
+    int watchdog_timeout = 0;       ///< 看门狗超时（毫秒），0表示不启用；第一次心跳表示就绪，客户端见service_heartbeat.h
+    ServiceLogConfig log{};         ///< 输出日志配置
+    ServiceInstanceConfig instances{}; ///< 多实例配置
+    std::vector<int> cpu_affinity{}; ///< 绑定的CPU，为空表示不绑定
+    bool zygote = false;            ///< 作为zygote运行，见service_zygote.h
+    std::string spawn_from{};       ///< 从该zygote服务fork启动，zygote未运行时回退到exec
+    bool warm_standby = false;      ///< 关键服务预先启动待命实例，主实例退出时立即接替；见service_standby.h
+    std::vector<ServiceIoLimit> io_limits{}; ///< I/O限制
+    int instance_index = -1;        ///< 实例序号，非实例服务为-1
+};
+
+/**
+ * @brief 服务I/O统计
+ *
+ * 有io控制器时来自服务cgroup的io.stat，否则累加各进程/proc/<pid>/io的存储读写字节数，
+ * 操作数以读写系统调用次数近似。速率为相邻两次监控采样之间的平均值
+ */
+struct ServiceIoStats {
+    uint64_t read_bytes;            ///< 累计读取字节数
+    uint64_t write_bytes;           ///< 累计写入字节数
+    double read_bytes_per_sec;      ///< 读取速率（字节/秒）
+    double write_bytes_per_sec;     ///< 写入速率（字节/秒）
+    double read_iops;               ///< 每秒读操作数
+    double write_iops;              ///< 每秒写操作数
 };
 
 /**
@@ -88,6 +203,103 @@ struct ServiceStatus {
     std::string last_error;         ///< 最后错误信息
     int memory_usage;               ///< 内存使用量（KB）
     double cpu_usage;               ///< CPU使用率
+    ServiceIoStats io;              ///< I/O统计
+};
+
+/**
+ * @brief 服务状态变化事件
+ *
+ * 订阅者来不及处理时，同一服务的多次变化合并为一条
+ */
+struct StatusChangeEvent {
+    std::string service;                                ///< 服务名称
+    ServiceType type;                                   ///< 服务类型
+    ServiceState old_state;                             ///< 原状态，合并时为第一次变化前的状态
+    ServiceState new_state;                             ///< 新状态，合并时为最新状态
+    std::chrono::system_clock::time_point timestamp;    ///< 最近一次变化的时刻
+    uint32_t coalesced = 0;                             ///< 被合并掉的变化次数
+};
+
+/**
+ * @brief 状态变化订阅的过滤条件，各项为空表示不限
+ */
+struct StatusSubscriptionFilter {
+    std::vector<std::string> services;  ///< 服务名称
+    std::vector<ServiceType> types;     ///< 服务类型
+    std::vector<ServiceState> states;   ///< 新状态
+};
+
+using StatusSubscriptionId = uint64_t;
+
+/**
+ * @brief 全部服务的只读快照
+ *
+ * 配置以shared_ptr<const>与服务共享，不复制参数和环境变量；快照不可变，可在线程间共享
+ */
+struct ServiceSnapshot {
+    struct Entry {
+        std::string name;                               ///< 服务名称
+        std::shared_ptr<const ServiceConfig> config;    ///< 服务配置
+        ServiceStatus status;                           ///< 服务状态
+    };
+    
+    uint64_t generation = 0;        ///< 生成快照时的代数，见ServiceManager::getGeneration()
+    std::vector<Entry> services;    ///< 按名称排序
+};
+
+/**
+ * @brief 服务启动时间线
+ *
+ * 所有时间点均来自单调时钟，未发生的阶段保持默认值。
+ * 配置了看门狗的服务以第一次心跳为就绪；其他服务没有就绪信号，
+ * 就绪时刻是启动后固定等待100毫秒、确认进程仍在运行的时刻，初始化耗时因此至少为100毫秒
+ */
+struct ServiceStartupTiming {
+    std::string name;                                           ///< 服务名称
+    std::vector<std::string> dependencies;                      ///< 依赖服务
+    std::chrono::steady_clock::time_point requested;            ///< 请求启动
+    std::chrono::steady_clock::time_point dependencies_ready;   ///< 依赖就绪
+    std::chrono::steady_clock::time_point spawned;              ///< 创建进程
+    std::chrono::steady_clock::time_point executed;             ///< 完成exec
+    std::chrono::steady_clock::time_point ready;                ///< 就绪
+    bool completed;                                             ///< 是否已到达运行状态
+};
+
+/**
+ * @brief 服务生命周期事件类型
+ */
+enum class JournalEventType {
+    StateChange = 0,    ///< 状态变化
+    Exit = 1,           ///< 主进程退出
+    Restart = 2,        ///< 自动重启
+    ProbeFailed = 3     ///< 存活探测发现主进程已退出
+};
+
+/**
+ * @brief 服务生命周期事件，见service_journal.h
+ */
+struct JournalEvent {
+    uint64_t sequence = 0;                                      ///< 日志序号
+    std::chrono::system_clock::time_point timestamp;            ///< 记录时间
+    JournalEventType type = JournalEventType::StateChange;      ///< 事件类型
+    std::string service;                                        ///< 服务名称，待命实例带.standby后缀
+    int pid = -1;                                               ///< 相关进程ID
+    ServiceState old_state = ServiceState::Unknown;             ///< 变化前状态
+    ServiceState new_state = ServiceState::Unknown;             ///< 变化后状态
+    int exit_code = -1;                                         ///< 退出码，未知或被信号终止时为-1
+    int signal = 0;                                             ///< 终止进程的信号，0表示没有或未知
+    int restart_count = 0;                                      ///< 启动次数
+    std::chrono::nanoseconds duration{0};                       ///< 存活探测耗时
+};
+
+/**
+ * @brief 事件日志查询条件
+ */
+struct JournalQuery {
+    std::string service;                                        ///< 服务名称，为空表示全部
+    std::chrono::system_clock::time_point since;                ///< 起始时间（含）
+    std::chrono::system_clock::time_point until = std::chrono::system_clock::time_point::max(); ///< 截止时间（不含）
+    size_t limit = 0;                                           ///< 最多返回的事件数，超出时保留最新的，0表示不限
 };
 
 /**
@@ -117,8 +329,20 @@ public:
      */
     bool initialize();
     
+    /**
+     * @brief 设置服务配置文件，须在initialize()之前调用
+     * 
+     * 默认为/etc/cloudflow/services.conf；为空时不加载也不保存配置，
+     * 用于测试和基准测试等不应改动系统配置的场合
+     * @param path 配置文件路径
+     */
+    void setConfigFile(const std::string& path);
+    
     /**
      * @brief 注册服务
+     * 
+     * 多实例服务按实例配置注册为模板并创建各实例；
+     * 对模板名称调用启动、停止、重启和注销会作用于全部实例
      * @param config 服务配置
      * @return 成功返回true
      */
@@ -154,6 +378,9 @@ public:
     
     /**
      * @brief 获取服务状态
+     *
+     * 不等待服务的启动、停止等操作；按名称查找服务时短暂持有注册表分片的读锁，
+     * 读取状态与状态发布重叠时重试，因此不是无等待的
      * @param service_name 服务名称
      * @return 服务状态信息
      */
@@ -161,6 +388,8 @@ public:
     
     /**
      * @brief 检查服务是否运行
+     *
+     * 同getServiceStatus()按名称查找服务，状态本身是一次原子读取
      * @param service_name 服务名称
      * @return 运行中返回true
      */
@@ -172,6 +401,15 @@ public:
      */
     std::vector<std::string> getServiceNames() const;
     
+    /**
+     * @brief 获取服务的全部进程
+     * 
+     * 包括主进程fork出的工作进程和脱离父进程的守护进程，见service_process_tree.h
+     * @param service_name 服务名称
+     * @return 进程ID，主进程在前；服务未运行时为空
+     */
+    std::vector<int> getServiceProcesses(const std::string& service_name) const;
+    
     /**
      * @brief 获取服务配置
      * @param service_name 服务名称
@@ -179,6 +417,32 @@ public:
      */
     ServiceConfig getServiceConfig(const std::string& service_name) const;
     
+    /**
+     * @brief 获取全部服务的配置和状态快照
+     * 
+     * 一次调用代替逐个服务查询；代数未变化时返回同一个快照对象，不重新生成，
+     * 其中的CPU、内存和I/O统计可能落后于getServiceStatus()
+     * @return 快照
+     */
+    std::shared_ptr<const ServiceSnapshot> getSnapshot() const;
+    
+    /**
+     * @brief 获取快照代数
+     * 
+     * 服务注册或注销，服务的状态、进程ID、重启次数、错误信息或配置变化时递增；
+     * 资源统计的变化不递增。调用方可据此廉价地判断快照是否过期
+     * @return 代数
+     */
+    uint64_t getGeneration() const;
+    
+    /**
+     * @brief 获取服务最近的输出
+     * @param service_name 服务名称
+     * @param max_lines 最多返回的行数
+     * @return 输出行列表（按时间顺序）
+     */
+    std::vector<std::string> tailServiceLog(const std::string& service_name, size_t max_lines = 100) const;
+    
     /**
      * @brief 设置服务配置
      * @param service_name 服务名称
@@ -187,6 +451,16 @@ public:
      */
     bool setServiceConfig(const std::string& service_name, const ServiceConfig& config);
     
+    /**
+     * @brief 设置服务的I/O限制
+     * 
+     * 保存到服务配置，服务运行时立即生效，不需要重启
+     * @param service_name 服务名称
+     * @param limits I/O限制，为空表示解除全部限制
+     * @return 服务存在、限制已生效（或服务未运行）且配置已保存返回true
+     */
+    bool setServiceIoLimits(const std::string& service_name, const std::vector<ServiceIoLimit>& limits);
+    
     /**
      * @brief 启用服务自动启动
      * @param service_name 服务名称
@@ -201,8 +475,49 @@ public:
      */
     bool disableService(const std::string& service_name);
     
+    /**
+     * @brief 调整多实例服务的实例数
+     * 
+     * 扩容时，若已有实例在运行则立即启动新实例；缩容时停止并注销序号最大的实例
+     * @param service_name 模板名称
+     * @param instance_count 目标实例数
+     * @return 成功返回true
+     */
+    bool scaleService(const std::string& service_name, int instance_count);
+    
+    /**
+     * @brief 获取多实例服务的实例名称
+     * @param service_name 模板名称
+     * @return 按序号排列的实例名称，非模板返回空列表
+     */
+    std::vector<std::string> getServiceInstances(const std::string& service_name) const;
+    
+    /**
+     * @brief 设置批量启动的准入策略
+     * @param policy 准入策略
+     */
+    void setStartAdmissionPolicy(const StartAdmissionPolicy& policy);
+    
+    /**
+     * @brief 设置启动耗时历史文件并加载
+     * 
+     * 每次启动成功后记录从创建进程到就绪的耗时，批量启动结束后写回文件。
+     * 批量启动以历史平均耗时估计关键路径，优先放行剩余关键路径最长的服务
+     * @param path 历史文件路径
+     * @return 加载成功返回true；文件不存在时返回false，历史从空开始
+     */
+    bool setStartHistoryFile(const std::string& path);
+    
+    /**
+     * @brief 获取最近一次批量启动的准入决策记录
+     * @return 决策记录，按时间顺序
+     */
+    std::vector<std::string> getAdmissionLog() const;
+    
     /**
      * @brief 启动所有自动启动的服务
+     * 
+     * 依赖就绪的服务按准入策略并发启动，依赖启动失败的服务不再启动
      * @return 成功返回true
      */
     bool startAllServices();
@@ -221,10 +536,34 @@ public:
     
     /**
      * @brief 设置服务状态变化回调
+     * 
+     * 等同于不带过滤条件的订阅，再次设置时替换上一个回调，传入空函数即取消；
+     * 回调在投递线程上执行，见subscribeStatusChanges()
      * @param callback 回调函数
      */
     void setStatusChangeCallback(std::function<void(const std::string&, ServiceState, ServiceState)> callback);
     
+    /**
+     * @brief 订阅服务状态变化
+     * 
+     * 回调在管理器的投递线程上执行，同一订阅的回调按顺序串行调用，不阻塞服务监控；
+     * 回调处理不及时的订阅，同一服务尚未投递的变化合并为一条，只保留最新状态
+     * @param callback 回调函数
+     * @param filter 过滤条件
+     * @return 订阅ID，失败返回0
+     */
+    StatusSubscriptionId subscribeStatusChanges(std::function<void(const StatusChangeEvent&)> callback,
+                                                const StatusSubscriptionFilter& filter = StatusSubscriptionFilter());
+    
+    /**
+     * @brief 取消订阅
+     * 
+     * 返回后不会再开始该订阅的回调；可以在该订阅自己的回调中调用
+     * @param id 订阅ID
+     * @return 订阅存在返回true
+     */
+    bool unsubscribeStatusChanges(StatusSubscriptionId id);
+    
     /**
      * @brief 设置服务错误回调
      * @param callback 回调函数
@@ -233,17 +572,122 @@ public:
     
     /**
      * @brief 监控服务状态
-     * @param interval 监控间隔（毫秒）
+     *
+     * 服务注册后即由各自的监控线程和监管线程监督，本调用不再启动额外的线程，保留以兼容旧接口
+     * @param interval 监控间隔（毫秒），不再使用
      */
     void startMonitoring(int interval = 1000);
     
     /**
-     * @brief 停止监控
+     * @brief 停止监控，见startMonitoring()
      */
     void stopMonitoring();
     
+    /**
+     * @brief 启动指标导出服务
+     * 
+     * 指标以Prometheus文本格式提供，抓取只读取原子计数器，不获取注册表锁
+     * @param unix_socket_path unix socket路径，连接后直接返回指标；为空时不监听
+     * @param http_port 回环地址HTTP端口，0表示不监听
+     * @return 至少一个监听成功返回true
+     */
+    bool startMetricsServer(const std::string& unix_socket_path, int http_port = 0);
+    
+    /**
+     * @brief 停止指标导出服务
+     */
+    void stopMetricsServer();
+    
+    /**
+     * @brief 启动控制接口
+     * 
+     * 在unix socket上提供二进制控制协议，支持批量启停、状态查询和状态变化订阅，
+     * 客户端见service_control.h。调用者身份由SO_PEERCRED确定，
+     * root和管理器自身的有效用户可以启停服务
+     * @param socket_path 套接字路径
+     * @param admin_uids 额外允许启停服务的用户ID
+     * @param allow_unprivileged_status 其他用户是否可以查询状态和订阅
+     * @return 成功返回true
+     */
+    bool startControlServer(const std::string& socket_path, const std::vector<uint32_t>& admin_uids = {},
+                            bool allow_unprivileged_status = true);
+    
+    /**
+     * @brief 停止控制接口
+     */
+    void stopControlServer();
+    
+    /**
+     * @brief 启动压力监控
+     * 
+     * 通过/proc/pressure触发器监听系统压力，压力出现时卸载低优先级服务，解除后恢复
+     * @param policy 卸载策略
+     * @return 至少监控一种资源返回true，内核未启用PSI时返回false
+     */
+    bool startPressureMonitoring(const PressurePolicy& policy = PressurePolicy());
+    
+    /**
+     * @brief 停止压力监控，并恢复已卸载的服务
+     */
+    void stopPressureMonitoring();
+    
+    /**
+     * @brief 获取因压力被卸载的服务
+     * @return 服务名称列表
+     */
+    std::vector<std::string> getShedServices() const;
+    
+    /**
+     * @brief 获取Prometheus文本格式的指标
+     * @return 指标文本
+     */
+    std::string getMetrics() const;
+    
+    /**
+     * @brief 获取各服务最近一次启动的时间线
+     * @return 时间线列表
+     */
+    std::vector<ServiceStartupTiming> getStartupTimings() const;
+    
+    /**
+     * @brief 生成启动关键路径报告
+     * 
+     * 对每个终端服务（不被其他服务依赖的服务），沿最晚就绪的依赖回溯，
+     * 给出决定其就绪时间的依赖链；批量启动过时附带预计与实际启动耗时的对比
+     * @return 报告文本
+     */
+    std::string generateCriticalChainReport() const;
+    
+    /**
+     * @brief 导出启动过程的Chrome trace JSON
+     * @param filename 输出文件名
+     * @return 成功返回true
+     */
+    bool exportStartupTrace(const std::string& filename) const;
+    
+    /**
+     * @brief 设置生命周期事件日志文件
+     * 
+     * 状态变化、进程退出、自动重启和存活探测失败写入映射到该文件的环形缓冲区，
+     * 管理器崩溃后记录仍在文件中；容量相同的已有文件接着写入。只能设置一次，应在启动服务之前调用
+     * @param path 日志文件路径
+     * @param capacity 保留的事件数
+     * @return 成功返回true
+     */
+    bool setJournalFile(const std::string& path, size_t capacity = 65536);
+    
+    /**
+     * @brief 查询生命周期事件
+     * @param query 查询条件
+     * @return 事件，按发生顺序；未设置日志文件时为空
+     */
+    std::vector<JournalEvent> queryJournal(const JournalQuery& query) const;
+    
     /**
      * @brief 保存服务状态
+     * 
+     * 除状态外还记录运行中进程的PID和启动时刻，并把其pidfd、输出管道读端和心跳页
+     * 描述符的副本放入交接存储，供reexec()后的新管理器接管
      * @param filename 保存文件名
      * @return 成功返回true
      */
@@ -251,10 +695,25 @@ public:
     
     /**
      * @brief 恢复服务状态
+     * 
+     * 状态文件中PID与启动时刻仍然一致的进程被直接接管，不重启服务；
+     * 由exec前的同一进程写入时还会接管继承下来的描述符，否则重新打开pidfd，
+     * 服务输出不再捕获。进程已不存在的服务按原状态和自动启动配置重新启动。
+     * 调用前服务应已注册
      * @param filename 状态文件名
      * @return 成功返回true
      */
     bool restoreServiceState(const std::string& filename);
+    
+    /**
+     * @brief 保存状态后以新映像重新执行管理器，服务进程不受影响
+     * 
+     * 新映像启动后注册服务并以同一状态文件调用restoreServiceState()即可接管全部服务
+     * @param state_file 状态文件名
+     * @param args 新映像的命令行参数（含argv[0]）
+     * @return 成功时不返回；失败返回false，管理器继续正常运行
+     */
+    bool reexec(const std::string& state_file, const std::vector<std::string>& args);
 
 private:
     class Impl;
@@ -0,0 +1,452 @@
+/**
+ * @file service_metrics.cpp
+ * @brief 服务指标实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_metrics.h"
+#include "service_supervisor.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+// HTTP请求头的最大长度
+constexpr size_t kMaxRequestSize = 8 * 1024;
+
+const char* stateLabel(int state) {
+    switch (static_cast<ServiceState>(state)) {
+        case ServiceState::Stopped: return "stopped";
+        case ServiceState::Starting: return "starting";
+        case ServiceState::Running: return "running";
+        case ServiceState::Stopping: return "stopping";
+        case ServiceState::Failed: return "failed";
+        default: return "unknown";
+    }
+}
+
+std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '"': escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+ServiceMetricsSlot::ServiceMetricsSlot(const std::string& service_name)
+    : name(service_name)
+    , active(true)
+    , state(static_cast<int>(ServiceState::Stopped))
+    , restarts(0)
+    , running_since_ns(0)
+    , cpu_usage(0.0)
+    , memory_bytes(0)
+    , io_read_bytes(0)
+    , io_write_bytes(0)
+    , probe_count(0)
+    , probe_duration_ns(0)
+    , last_probe_ns(0)
+    , next(nullptr) {
+}
+
+ServiceMetricsRegistry::ServiceMetricsRegistry() : head_(nullptr) {
+}
+
+ServiceMetricsRegistry::~ServiceMetricsRegistry() {
+    ServiceMetricsSlot* slot = head_.load();
+    while (slot) {
+        ServiceMetricsSlot* next = slot->next;
+        delete slot;
+        slot = next;
+    }
+}
+
+ServiceMetricsSlot* ServiceMetricsRegistry::acquire(const std::string& service_name) {
+    std::lock_guard<std::mutex> lock(acquire_mutex_);
+    
+    // 复用同名槽位，内存占用只与出现过的服务名数量有关
+    for (ServiceMetricsSlot* slot = head_.load(std::memory_order_acquire); slot; slot = slot->next) {
+        if (slot->name == service_name) {
+            slot->state.store(static_cast<int>(ServiceState::Stopped), std::memory_order_relaxed);
+            slot->restarts.store(0, std::memory_order_relaxed);
+            slot->running_since_ns.store(0, std::memory_order_relaxed);
+            slot->cpu_usage.store(0.0, std::memory_order_relaxed);
+            slot->memory_bytes.store(0, std::memory_order_relaxed);
+            slot->io_read_bytes.store(0, std::memory_order_relaxed);
+            slot->io_write_bytes.store(0, std::memory_order_relaxed);
+            slot->probe_count.store(0, std::memory_order_relaxed);
+            slot->probe_duration_ns.store(0, std::memory_order_relaxed);
+            slot->last_probe_ns.store(0, std::memory_order_relaxed);
+            slot->active.store(true, std::memory_order_release);
+            return slot;
+        }
+    }
+    
+    auto* slot = new ServiceMetricsSlot(service_name);
+    slot->next = head_.load(std::memory_order_relaxed);
+    head_.store(slot, std::memory_order_release);
+    return slot;
+}
+
+void ServiceMetricsRegistry::release(ServiceMetricsSlot* slot) {
+    if (!slot) {
+        return;
+    }
+    slot->running_since_ns.store(0, std::memory_order_relaxed);
+    slot->active.store(false, std::memory_order_release);
+}
+
+std::string ServiceMetricsRegistry::render(const ServiceSupervisor* supervisor) const {
+    std::ostringstream out;
+    ServiceMetricsSlot* head = head_.load(std::memory_order_acquire);
+    int64_t now = steadyNanoseconds();
+    
+    auto forEachActive = [head](const std::function<void(const ServiceMetricsSlot&)>& visit) {
+        for (ServiceMetricsSlot* slot = head; slot; slot = slot->next) {
+            if (slot->active.load(std::memory_order_acquire)) {
+                visit(*slot);
+            }
+        }
+    };
+    
+    size_t registered = 0;
+    forEachActive([&registered](const ServiceMetricsSlot&) { ++registered; });
+    out << "# HELP cloudflow_services_registered 已注册的服务数量\n"
+        << "# TYPE cloudflow_services_registered gauge\n"
+        << "cloudflow_services_registered " << registered << "\n";
+    
+    out << "# HELP cloudflow_service_state 服务状态，当前状态对应的序列值为1\n"
+        << "# TYPE cloudflow_service_state gauge\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        int current = slot.state.load(std::memory_order_relaxed);
+        for (int state = static_cast<int>(ServiceState::Stopped); state <= static_cast<int>(ServiceState::Unknown); ++state) {
+            out << "cloudflow_service_state{service=\"" << escapeLabel(slot.name)
+                << "\",state=\"" << stateLabel(state) << "\"} " << (state == current ? 1 : 0) << "\n";
+        }
+    });
+    
+    out << "# HELP cloudflow_service_restarts_total 服务重启次数，首次启动不计\n"
+        << "# TYPE cloudflow_service_restarts_total counter\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        out << "cloudflow_service_restarts_total{service=\"" << escapeLabel(slot.name) << "\"} "
+            << slot.restarts.load(std::memory_order_relaxed) << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_uptime_seconds 服务本次运行时长\n"
+        << "# TYPE cloudflow_service_uptime_seconds gauge\n";
+    forEachActive([&out, now](const ServiceMetricsSlot& slot) {
+        int64_t since = slot.running_since_ns.load(std::memory_order_relaxed);
+        double uptime = since > 0 && now > since ? (now - since) / 1e9 : 0.0;
+        out << "cloudflow_service_uptime_seconds{service=\"" << escapeLabel(slot.name) << "\"} " << uptime << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_cpu_usage_ratio 服务CPU使用率（单核为1）\n"
+        << "# TYPE cloudflow_service_cpu_usage_ratio gauge\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        out << "cloudflow_service_cpu_usage_ratio{service=\"" << escapeLabel(slot.name) << "\"} "
+            << slot.cpu_usage.load(std::memory_order_relaxed) << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_memory_bytes 服务常驻内存\n"
+        << "# TYPE cloudflow_service_memory_bytes gauge\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        out << "cloudflow_service_memory_bytes{service=\"" << escapeLabel(slot.name) << "\"} "
+            << slot.memory_bytes.load(std::memory_order_relaxed) << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_io_read_bytes_total 服务累计读取字节数\n"
+        << "# TYPE cloudflow_service_io_read_bytes_total counter\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        out << "cloudflow_service_io_read_bytes_total{service=\"" << escapeLabel(slot.name) << "\"} "
+            << slot.io_read_bytes.load(std::memory_order_relaxed) << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_io_write_bytes_total 服务累计写入字节数\n"
+        << "# TYPE cloudflow_service_io_write_bytes_total counter\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        out << "cloudflow_service_io_write_bytes_total{service=\"" << escapeLabel(slot.name) << "\"} "
+            << slot.io_write_bytes.load(std::memory_order_relaxed) << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_probe_duration_seconds 服务存活探测耗时\n"
+        << "# TYPE cloudflow_service_probe_duration_seconds summary\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        std::string label = escapeLabel(slot.name);
+        out << "cloudflow_service_probe_duration_seconds_sum{service=\"" << label << "\"} "
+            << slot.probe_duration_ns.load(std::memory_order_relaxed) / 1e9 << "\n"
+            << "cloudflow_service_probe_duration_seconds_count{service=\"" << label << "\"} "
+            << slot.probe_count.load(std::memory_order_relaxed) << "\n";
+    });
+    
+    out << "# HELP cloudflow_service_probe_last_duration_seconds 最近一次存活探测耗时\n"
+        << "# TYPE cloudflow_service_probe_last_duration_seconds gauge\n";
+    forEachActive([&out](const ServiceMetricsSlot& slot) {
+        out << "cloudflow_service_probe_last_duration_seconds{service=\"" << escapeLabel(slot.name) << "\"} "
+            << slot.last_probe_ns.load(std::memory_order_relaxed) / 1e9 << "\n";
+    });
+    
+    if (supervisor) {
+        out << "# HELP cloudflow_supervisor_loop_lag_seconds 监管事件循环最近一次节拍延迟\n"
+            << "# TYPE cloudflow_supervisor_loop_lag_seconds gauge\n"
+            << "cloudflow_supervisor_loop_lag_seconds " << supervisor->loopLagNanoseconds() / 1e9 << "\n"
+            << "# HELP cloudflow_supervisor_loop_lag_max_seconds 监管事件循环最大节拍延迟\n"
+            << "# TYPE cloudflow_supervisor_loop_lag_max_seconds gauge\n"
+            << "cloudflow_supervisor_loop_lag_max_seconds " << supervisor->maxLoopLagNanoseconds() / 1e9 << "\n";
+    }
+    
+    return out.str();
+}
+
+struct MetricsServer::Connection {
+    int fd;
+    bool http;
+    uint64_t watch_id;
+    std::string request;
+    std::string response;
+    size_t written;
+};
+
+MetricsServer::MetricsServer(ServiceSupervisor& supervisor, const ServiceMetricsRegistry& registry)
+    : supervisor_(supervisor)
+    , registry_(registry)
+    , unix_watch_(0)
+    , http_watch_(0) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+#ifdef __linux__
+
+bool MetricsServer::start(const std::string& unix_socket_path, int http_port) {
+    stop();
+    
+    if (!unix_socket_path.empty()) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        
+        if (fd != -1 && unix_socket_path.size() < sizeof(address.sun_path)) {
+            std::strncpy(address.sun_path, unix_socket_path.c_str(), sizeof(address.sun_path) - 1);
+            unlink(unix_socket_path.c_str());
+            
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 && listen(fd, 16) == 0) {
+                chmod(unix_socket_path.c_str(), 0660);
+                unix_watch_ = supervisor_.addWatch(fd, EPOLLIN, [this, fd](uint32_t) {
+                    acceptClients(fd, false);
+                    return true;
+                }, true);
+                if (unix_watch_ != 0) {
+                    unix_socket_path_ = unix_socket_path;
+                    fd = -1;
+                }
+            }
+        }
+        
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+    
+    if (http_port > 0) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd != -1) {
+            int reuse = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            
+            // 只监听回环地址，指标不对外暴露
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(http_port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 && listen(fd, 16) == 0) {
+                http_watch_ = supervisor_.addWatch(fd, EPOLLIN, [this, fd](uint32_t) {
+                    acceptClients(fd, true);
+                    return true;
+                }, true);
+                if (http_watch_ != 0) {
+                    fd = -1;
+                }
+            }
+            
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+    }
+    
+    return unix_watch_ != 0 || http_watch_ != 0;
+}
+
+void MetricsServer::stop() {
+    if (unix_watch_ != 0) {
+        supervisor_.removeWatch(unix_watch_);
+        unlink(unix_socket_path_.c_str());
+        unix_socket_path_.clear();
+        unix_watch_ = 0;
+    }
+    if (http_watch_ != 0) {
+        supervisor_.removeWatch(http_watch_);
+        http_watch_ = 0;
+    }
+    
+    std::unordered_map<uint64_t, std::shared_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections.swap(connections_);
+    }
+    for (const auto& pair : connections) {
+        supervisor_.removeWatch(pair.first);
+    }
+}
+
+void MetricsServer::acceptClients(int listen_fd, bool http) {
+    for (;;) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            return; // EAGAIN或出错，等待下一次事件
+        }
+        
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+        connection->http = http;
+        connection->written = 0;
+        
+        // unix socket无需请求，连接后直接输出指标
+        if (!http) {
+            connection->response = registry_.render(&supervisor_);
+        }
+        
+        uint64_t watch_id = supervisor_.addWatch(fd, http ? EPOLLIN : EPOLLOUT, [this, connection](uint32_t events) {
+            return handleClient(connection, events);
+        }, true);
+        
+        if (watch_id == 0) {
+            close(fd);
+            continue;
+        }
+        
+        connection->watch_id = watch_id;
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_[watch_id] = connection;
+    }
+}
+
+bool MetricsServer::handleClient(const std::shared_ptr<Connection>& connection, uint32_t events) {
+    auto finish = [this, &connection]() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.erase(connection->watch_id);
+        return false;
+    };
+    
+    if (events & EPOLLERR) {
+        return finish();
+    }
+    
+    if (connection->http && connection->response.empty()) {
+        char buffer[1024];
+        ssize_t count = read(connection->fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            connection->request.append(buffer, count);
+        } else if (count == -1 && (errno == EAGAIN || errno == EINTR)) {
+            return true;
+        }
+        
+        bool complete = connection->request.find("\r\n\r\n") != std::string::npos;
+        if (!complete && count > 0 && connection->request.size() < kMaxRequestSize) {
+            return true;
+        }
+        
+        std::string body;
+        std::string status;
+        if (connection->request.compare(0, 4, "GET ") == 0) {
+            status = "200 OK";
+            body = registry_.render(&supervisor_);
+        } else {
+            status = "405 Method Not Allowed";
+        }
+        
+        connection->response = "HTTP/1.0 " + status + "\r\n"
+            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+        
+        if (!supervisor_.modifyWatch(connection->watch_id, EPOLLOUT)) {
+            return finish();
+        }
+        return true;
+    }
+    
+    while (connection->written < connection->response.size()) {
+        ssize_t count = send(connection->fd, connection->response.data() + connection->written,
+                             connection->response.size() - connection->written, MSG_NOSIGNAL);
+        if (count > 0) {
+            connection->written += count;
+            continue;
+        }
+        if (count == -1 && errno == EINTR) {
+            continue;
+        }
+        if (count == -1 && errno == EAGAIN) {
+            return true; // 等待套接字可写
+        }
+        break;
+    }
+    
+    return finish();
+}
+
+#else
+
+bool MetricsServer::start(const std::string&, int) {
+    return false; // 当前平台不支持
+}
+
+void MetricsServer::stop() {
+}
+
+void MetricsServer::acceptClients(int, bool) {
+}
+
+bool MetricsServer::handleClient(const std::shared_ptr<Connection>&, uint32_t) {
+    return false;
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
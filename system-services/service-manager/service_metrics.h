@@ -0,0 +1,137 @@
+/**
+ * @file service_metrics.h
+ * @brief 服务指标
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 基于原子计数器的服务指标，以Prometheus文本格式导出，
+ * 可通过unix socket或仅监听回环地址的HTTP端口抓取
+ */
+
+#ifndef CLOUDFLOW_SERVICE_METRICS_H
+#define CLOUDFLOW_SERVICE_METRICS_H
+
+#include "service_manager.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace CloudFlow {
+namespace System {
+
+class ServiceSupervisor;
+
+/**
+ * @brief 单个服务的指标槽位
+ *
+ * 所有字段均为原子变量，由服务线程写入、抓取方无锁读取。
+ * 名称在槽位发布后不再修改。
+ */
+struct ServiceMetricsSlot {
+    explicit ServiceMetricsSlot(const std::string& service_name);
+    
+    const std::string name;                      ///< 服务名称
+    std::atomic<bool> active;                    ///< 服务是否仍在注册表中
+    std::atomic<int> state;                      ///< ServiceState的整数值
+    std::atomic<uint64_t> restarts;              ///< 重启次数，首次启动不计
+    std::atomic<int64_t> running_since_ns;       ///< 进入运行状态的单调时钟时间，0表示未运行
+    std::atomic<double> cpu_usage;               ///< CPU使用率（0-1，按单核计）
+    std::atomic<uint64_t> memory_bytes;          ///< 常驻内存
+    std::atomic<uint64_t> io_read_bytes;         ///< 累计读取字节数
+    std::atomic<uint64_t> io_write_bytes;        ///< 累计写入字节数
+    std::atomic<uint64_t> probe_count;           ///< 存活探测次数
+    std::atomic<uint64_t> probe_duration_ns;     ///< 存活探测累计耗时
+    std::atomic<int64_t> last_probe_ns;          ///< 最近一次探测耗时
+    
+    ServiceMetricsSlot* next;                    ///< 链表后继，发布后不再修改
+};
+
+/**
+ * @brief 服务指标注册表
+ *
+ * 槽位组成只增不减的无锁链表：注册时追加或复用同名槽位，注销时仅标记为非活动，
+ * 因此抓取只需遍历链表读取原子变量，不会获取服务注册表的任何锁。
+ */
+class ServiceMetricsRegistry {
+public:
+    ServiceMetricsRegistry();
+    ~ServiceMetricsRegistry();
+    
+    ServiceMetricsRegistry(const ServiceMetricsRegistry&) = delete;
+    ServiceMetricsRegistry& operator=(const ServiceMetricsRegistry&) = delete;
+    
+    /**
+     * @brief 获取服务的指标槽位
+     * @param service_name 服务名称
+     * @return 槽位指针，生命周期与注册表相同
+     */
+    ServiceMetricsSlot* acquire(const std::string& service_name);
+    
+    /**
+     * @brief 释放服务的指标槽位
+     * @param slot 槽位指针
+     */
+    void release(ServiceMetricsSlot* slot);
+    
+    /**
+     * @brief 以Prometheus文本格式输出全部指标
+     * @param supervisor 监管事件循环，可为空
+     * @return 指标文本
+     */
+    std::string render(const ServiceSupervisor* supervisor) const;
+
+private:
+    std::atomic<ServiceMetricsSlot*> head_;
+    std::mutex acquire_mutex_;                   ///< 只串行化注册，抓取不使用
+};
+
+/**
+ * @brief 指标导出服务
+ *
+ * 监听套接字和客户端连接都挂在监管事件循环上，不额外创建线程
+ */
+class MetricsServer {
+public:
+    MetricsServer(ServiceSupervisor& supervisor, const ServiceMetricsRegistry& registry);
+    ~MetricsServer();
+    
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    
+    /**
+     * @brief 开始监听
+     * @param unix_socket_path unix socket路径，为空时不监听
+     * @param http_port 回环地址HTTP端口，0表示不监听
+     * @return 至少一个监听成功返回true
+     */
+    bool start(const std::string& unix_socket_path, int http_port);
+    
+    /**
+     * @brief 停止监听并断开所有连接
+     */
+    void stop();
+
+private:
+    struct Connection;
+    
+    void acceptClients(int listen_fd, bool http);
+    bool handleClient(const std::shared_ptr<Connection>& connection, uint32_t events);
+    
+    ServiceSupervisor& supervisor_;
+    const ServiceMetricsRegistry& registry_;
+    std::string unix_socket_path_;
+    
+    std::mutex mutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<Connection>> connections_;
+    uint64_t unix_watch_;
+    uint64_t http_watch_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_METRICS_H
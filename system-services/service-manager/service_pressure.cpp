@@ -0,0 +1,258 @@
+/**
+ * @file service_pressure.cpp
+ * @brief 系统压力监控实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_pressure.h"
+#include "service_supervisor.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+// 压力状态下检查是否解除的间隔
+constexpr std::chrono::seconds kRecoveryCheckInterval(1);
+
+const char* pressurePath(int index) {
+    static const char* const paths[] = {
+        "/proc/pressure/memory",
+        "/proc/pressure/cpu",
+        "/proc/pressure/io"
+    };
+    return paths[index];
+}
+
+int stallThreshold(const PressurePolicy& policy, int index) {
+    switch (static_cast<PressureResource>(index)) {
+        case PressureResource::Memory: return policy.memory_stall_us;
+        case PressureResource::Cpu: return policy.cpu_stall_us;
+        case PressureResource::Io: return policy.io_stall_us;
+    }
+    return 0;
+}
+
+// 读取"some avg10=..."，失败返回负数
+double readSomeAvg10(int index) {
+    std::ifstream file(pressurePath(index));
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 5, "some ") != 0) {
+            continue;
+        }
+        size_t pos = line.find("avg10=");
+        if (pos != std::string::npos) {
+            return std::strtod(line.c_str() + pos + 6, nullptr);
+        }
+    }
+    return -1.0;
+}
+
+} // namespace
+
+double readPressureAverage(PressureResource resource) {
+    return readSomeAvg10(static_cast<int>(resource));
+}
+
+PressureMonitor::PressureMonitor(ServiceSupervisor& supervisor)
+    : supervisor_(supervisor)
+    , tick_handler_(0)
+    , worker_running_(false) {
+    for (auto& resource : resources_) {
+        resource.watch_id = 0;
+        resource.polled = false;
+        resource.poll_threshold = 0.0;
+        resource.active = false;
+    }
+}
+
+PressureMonitor::~PressureMonitor() {
+    stop();
+}
+
+bool PressureMonitor::isUnderPressure(PressureResource resource) const {
+    return resources_[static_cast<int>(resource)].active.load(std::memory_order_acquire);
+}
+
+void PressureMonitor::onTrigger(int index, std::chrono::steady_clock::time_point now) {
+    Resource& resource = resources_[index];
+    resource.last_event = now;
+    if (!resource.active.exchange(true)) {
+        post(static_cast<PressureResource>(index), true);
+    }
+}
+
+void PressureMonitor::onTick(std::chrono::steady_clock::time_point now) {
+    if (now < next_check_) {
+        return;
+    }
+    next_check_ = now + kRecoveryCheckInterval;
+    
+    // 触发器只报告压力出现，解除需要结合最近一次触发时间和10秒平均值判断
+    auto hold = std::chrono::milliseconds(policy_.recovery_hold_ms);
+    for (int index = 0; index < kResourceCount; ++index) {
+        Resource& resource = resources_[index];
+        double average = -1.0;
+        if (resource.polled) {
+            average = readSomeAvg10(index);
+            if (average >= resource.poll_threshold) {
+                onTrigger(index, now);
+                continue;
+            }
+        }
+        
+        if (!resource.active || now - resource.last_event < hold) {
+            continue;
+        }
+        
+        if (average < 0.0) {
+            average = readSomeAvg10(index);
+        }
+        if (average >= 0.0 && average < policy_.recovery_avg10) {
+            resource.active = false;
+            post(static_cast<PressureResource>(index), false);
+        }
+    }
+}
+
+void PressureMonitor::post(PressureResource resource, bool under_pressure) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.emplace_back(resource, under_pressure);
+    }
+    queue_cv_.notify_one();
+}
+
+void PressureMonitor::workerLoop() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    for (;;) {
+        queue_cv_.wait(lock, [this]() { return !worker_running_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;
+        }
+        
+        auto event = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+        callback_(event.first, event.second);
+        lock.lock();
+    }
+}
+
+#ifdef __linux__
+
+bool PressureMonitor::start(const PressurePolicy& policy, Callback callback) {
+    stop();
+    if (!callback) {
+        return false;
+    }
+    
+    policy_ = policy;
+    callback_ = std::move(callback);
+    next_check_ = std::chrono::steady_clock::time_point();
+    
+    bool any = false;
+    for (int index = 0; index < kResourceCount; ++index) {
+        int threshold = stallThreshold(policy, index);
+        if (threshold <= 0) {
+            continue;
+        }
+        
+        int fd = open(pressurePath(index), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd == -1) {
+            continue; // 内核未启用PSI
+        }
+        
+        // 触发器：窗口内任一任务停顿累计超过阈值时产生EPOLLPRI，每个窗口最多一次
+        char trigger[64];
+        int length = std::snprintf(trigger, sizeof(trigger), "some %d %d", threshold, policy.window_us);
+        if (write(fd, trigger, length + 1) == -1) {
+            close(fd);
+            if (policy.window_us > 0) {
+                resources_[index].polled = true;
+                resources_[index].poll_threshold = 100.0 * threshold / policy.window_us;
+                any = true;
+            }
+            continue;
+        }
+        
+        resources_[index].watch_id = supervisor_.addWatch(fd, EPOLLPRI, [this, index](uint32_t events) {
+            if (events & EPOLLERR) {
+                return false;
+            }
+            onTrigger(index, std::chrono::steady_clock::now());
+            return true;
+        }, true);
+        
+        if (resources_[index].watch_id == 0) {
+            close(fd);
+            continue;
+        }
+        any = true;
+    }
+    
+    if (!any) {
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.clear(); // 丢弃上次停止后迟到的触发事件
+        worker_running_ = true;
+    }
+    worker_ = std::thread([this]() { workerLoop(); });
+    tick_handler_ = supervisor_.addTickHandler([this](std::chrono::steady_clock::time_point now) {
+        onTick(now);
+    });
+    return true;
+}
+
+#else
+
+bool PressureMonitor::start(const PressurePolicy&, Callback) {
+    return false; // 当前平台不支持PSI
+}
+
+#endif
+
+void PressureMonitor::stop() {
+    if (tick_handler_ != 0) {
+        supervisor_.removeTickHandler(tick_handler_);
+        tick_handler_ = 0;
+    }
+    
+    for (auto& resource : resources_) {
+        if (resource.watch_id != 0) {
+            supervisor_.removeWatch(resource.watch_id);
+            resource.watch_id = 0;
+        }
+        resource.polled = false;
+        resource.active = false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        worker_running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+} // namespace System
+} // namespace CloudFlow
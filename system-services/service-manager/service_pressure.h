@@ -0,0 +1,113 @@
+/**
+ * @file service_pressure.h
+ * @brief 系统压力监控
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 通过PSI（/proc/pressure）触发器在监管事件循环上监听内存、CPU和IO压力，
+ * 压力出现和解除时通知服务管理器
+ */
+
+#ifndef CLOUDFLOW_SERVICE_PRESSURE_H
+#define CLOUDFLOW_SERVICE_PRESSURE_H
+
+#include "service_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace CloudFlow {
+namespace System {
+
+class ServiceSupervisor;
+
+/**
+ * @brief 读取资源最近10秒内有任务停顿的时间比例
+ * @param resource 资源类型
+ * @return 百分比，内核未启用PSI时返回负数
+ */
+double readPressureAverage(PressureResource resource);
+
+/**
+ * @brief 压力监控
+ *
+ * 触发器事件和解除判定都在监管线程上完成，回调则在监控自己的工作线程上按顺序执行，
+ * 因此回调中可以启停服务而不阻塞事件循环。容器等环境中可以读取PSI但不能创建触发器，
+ * 此时退化为每秒轮询10秒平均值，阈值按停顿时间占窗口的比例换算
+ */
+class PressureMonitor {
+public:
+    /**
+     * @brief 压力变化回调
+     * @param resource 资源类型
+     * @param under_pressure true表示压力出现，false表示压力解除
+     */
+    using Callback = std::function<void(PressureResource resource, bool under_pressure)>;
+    
+    explicit PressureMonitor(ServiceSupervisor& supervisor);
+    ~PressureMonitor();
+    
+    PressureMonitor(const PressureMonitor&) = delete;
+    PressureMonitor& operator=(const PressureMonitor&) = delete;
+    
+    /**
+     * @brief 开始监控
+     * @param policy 阈值配置
+     * @param callback 压力变化回调
+     * @return 至少一个触发器创建成功返回true
+     */
+    bool start(const PressurePolicy& policy, Callback callback);
+    
+    /**
+     * @brief 停止监控，已排队的回调仍会执行完
+     */
+    void stop();
+    
+    /**
+     * @brief 检查资源当前是否处于压力状态
+     * @param resource 资源类型
+     * @return 处于压力状态返回true
+     */
+    bool isUnderPressure(PressureResource resource) const;
+
+private:
+    static constexpr int kResourceCount = 3;
+    
+    struct Resource {
+        uint64_t watch_id;
+        bool polled;                    ///< 内核不接受触发器时改为按节拍轮询10秒平均值
+        double poll_threshold;          ///< 轮询时视为压力的平均停顿百分比
+        std::atomic<bool> active;
+        std::chrono::steady_clock::time_point last_event;
+    };
+    
+    void onTrigger(int index, std::chrono::steady_clock::time_point now);
+    void onTick(std::chrono::steady_clock::time_point now);
+    void post(PressureResource resource, bool under_pressure);
+    void workerLoop();
+    
+    ServiceSupervisor& supervisor_;
+    PressurePolicy policy_;
+    Callback callback_;
+    Resource resources_[kResourceCount];
+    uint64_t tick_handler_;
+    std::chrono::steady_clock::time_point next_check_;
+    
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<std::pair<PressureResource, bool>> queue_;
+    bool worker_running_;
+    std::thread worker_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_PRESSURE_H
@@ -0,0 +1,721 @@
+/**
+ * @file service_process_tree.cpp
+ * @brief 服务进程树跟踪实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_process_tree.h"
+#include "service_fdstore.h"
+#include "service_supervisor.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+constexpr const char* kServicesCgroup = "cloudflow-services";
+constexpr const char* kManagerCgroup = "cloudflow-manager";
+constexpr std::chrono::milliseconds kUsageScanInterval(500);
+constexpr std::chrono::milliseconds kReapInterval(1000);
+
+// 单元名中的'/'会被当作cgroup路径分隔符
+std::string cgroupName(const std::string& unit) {
+    std::string name = unit;
+    std::replace(name.begin(), name.end(), '/', '_');
+    return name;
+}
+
+#ifdef __linux__
+
+bool writeFile(const std::string& path, const std::string& value) {
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    bool written = write(fd, value.c_str(), value.size()) == static_cast<ssize_t>(value.size());
+    close(fd);
+    return written;
+}
+
+// cgroup v2的挂载点：mountinfo中" - "之后的文件系统类型为cgroup2
+std::string findCgroup2Mount() {
+    std::ifstream mountinfo("/proc/self/mountinfo");
+    std::string line;
+    while (std::getline(mountinfo, line)) {
+        size_t separator = line.find(" - ");
+        if (separator == std::string::npos || line.compare(separator + 3, 8, "cgroup2 ") != 0) {
+            continue;
+        }
+        
+        std::istringstream fields(line.substr(0, separator));
+        std::string field;
+        for (int index = 0; index < 5 && fields >> field; ++index) {
+        }
+        return field;
+    }
+    return std::string();
+}
+
+// 统一层级下管理器所在的cgroup：/proc/self/cgroup中以"0::"开头的行
+std::string findOwnCgroup() {
+    std::ifstream cgroup("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(cgroup, line)) {
+        if (line.compare(0, 3, "0::") == 0) {
+            return line.substr(3);
+        }
+    }
+    return std::string();
+}
+
+// 块设备路径或"主:次"设备号转换为io.max使用的整盘设备号，分区换成其所在的整盘
+std::string resolveBlockDevice(const std::string& device) {
+    std::string number;
+    unsigned int major_number;
+    unsigned int minor_number;
+    char tail;
+    if (std::sscanf(device.c_str(), "%u:%u%c", &major_number, &minor_number, &tail) == 2) {
+        number = device;
+    } else {
+        struct stat info;
+        if (stat(device.c_str(), &info) == -1 || !S_ISBLK(info.st_mode)) {
+            return std::string();
+        }
+        number = std::to_string(major(info.st_rdev)) + ":" + std::to_string(minor(info.st_rdev));
+    }
+    
+    std::string sysfs = "/sys/dev/block/" + number;
+    if (access((sysfs + "/partition").c_str(), F_OK) == 0) {
+        std::ifstream disk(sysfs + "/../dev");
+        std::getline(disk, number);
+    }
+    return number;
+}
+
+std::string ioLimitValue(uint64_t value) {
+    return value == 0 ? "max" : std::to_string(value);
+}
+
+// 读取进程继承的CLOUDFLOW_SERVICE环境变量
+std::string readServiceUnit(int pid) {
+    std::ifstream file("/proc/" + std::to_string(pid) + "/environ", std::ios::binary);
+    std::string prefix = std::string(kServiceUnitEnv) + "=";
+    std::string entry;
+    while (std::getline(file, entry, '\0')) {
+        if (entry.compare(0, prefix.size(), prefix) == 0) {
+            return entry.substr(prefix.size());
+        }
+    }
+    return std::string();
+}
+
+#endif
+
+} // namespace
+
+#ifdef __linux__
+
+bool addProcessUsage(int pid, ProcessTreeUsage& usage) {
+    std::string proc_dir = "/proc/" + std::to_string(pid);
+    
+    // stat中进程名之后的第12、13个字段为utime和stime
+    std::ifstream stat(proc_dir + "/stat");
+    std::string content((std::istreambuf_iterator<char>(stat)), std::istreambuf_iterator<char>());
+    size_t name_end = content.rfind(')');
+    if (name_end == std::string::npos || name_end + 2 >= content.size()) {
+        return false;
+    }
+    
+    std::istringstream fields(content.substr(name_end + 2));
+    std::string field;
+    unsigned long long ticks = 0;
+    for (int index = 0; fields >> field && index <= 12; ++index) {
+        if (index == 11 || index == 12) {
+            ticks += std::strtoull(field.c_str(), nullptr, 10);
+        }
+    }
+    usage.cpu_usec += ticks * 1000000ULL / static_cast<unsigned long long>(sysconf(_SC_CLK_TCK));
+    ++usage.processes;
+    
+    // statm第二列为常驻内存页数
+    std::ifstream statm(proc_dir + "/statm");
+    long total_pages = 0;
+    long resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        usage.memory_bytes += static_cast<uint64_t>(resident_pages) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    
+    // read_bytes和write_bytes为实际到达存储层的字节数，syscr和syscw为读写系统调用次数
+    std::ifstream io(proc_dir + "/io");
+    std::string key;
+    uint64_t value;
+    while (io >> key >> value) {
+        if (key == "read_bytes:") {
+            usage.read_bytes += value;
+        } else if (key == "write_bytes:") {
+            usage.write_bytes += value;
+        } else if (key == "syscr:") {
+            usage.read_ops += value;
+        } else if (key == "syscw:") {
+            usage.write_ops += value;
+        }
+    }
+    return true;
+}
+
+#else
+
+bool addProcessUsage(int pid, ProcessTreeUsage& usage) {
+    (void)pid;
+    (void)usage;
+    return false;
+}
+
+#endif
+
+ServiceProcessTree::ServiceProcessTree(ServiceSupervisor& supervisor)
+    : supervisor_(supervisor)
+    , mode_(ProcessTreeMode::None)
+    , tick_id_(0) {
+}
+
+ServiceProcessTree::~ServiceProcessTree() {
+    stop();
+}
+
+ProcessTreeMode ServiceProcessTree::mode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mode_;
+}
+
+std::string ServiceProcessTree::cgroupPath(const std::string& unit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ != ProcessTreeMode::Cgroup) {
+        return std::string();
+    }
+    return cgroup_root_ + "/" + cgroupName(unit);
+}
+
+#ifdef __linux__
+
+ProcessTreeMode ServiceProcessTree::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (mode_ != ProcessTreeMode::None) {
+            return mode_;
+        }
+        
+        if (setupCgroup()) {
+            mode_ = ProcessTreeMode::Cgroup;
+            return mode_;
+        }
+        if (prctl(PR_SET_CHILD_SUBREAPER, 1) == -1) {
+            return mode_;
+        }
+        mode_ = ProcessTreeMode::Subreaper;
+    }
+    
+    // 监管线程在持有其处理函数锁时调用reapOrphans()，登记时不能持有mutex_
+    uint64_t tick_id = supervisor_.addTickHandler([this](std::chrono::steady_clock::time_point) {
+        reapOrphans();
+    });
+    std::lock_guard<std::mutex> lock(mutex_);
+    tick_id_ = tick_id;
+    return mode_;
+}
+
+void ServiceProcessTree::stop() {
+    uint64_t tick_id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tick_id = tick_id_;
+        tick_id_ = 0;
+    }
+    if (tick_id != 0) {
+        supervisor_.removeTickHandler(tick_id);
+    }
+}
+
+bool ServiceProcessTree::setupCgroup() {
+    std::string mount = findCgroup2Mount();
+    std::string own = findOwnCgroup();
+    if (mount.empty() || own.empty()) {
+        return false;
+    }
+    
+    std::string base = own == "/" ? mount : mount + own;
+    std::string root = base + "/" + kServicesCgroup;
+    if (mkdir(root.c_str(), 0755) == -1 && errno != EEXIST) {
+        return false;
+    }
+    if (access((root + "/cgroup.procs").c_str(), W_OK) != 0) {
+        return false;
+    }
+    
+    // 尽量向服务下放资源控制器。非根cgroup中有进程时不能下放，先把管理器移到自己的叶子cgroup
+    std::ifstream available_file(base + "/cgroup.controllers");
+    std::string controller;
+    bool moved = false;
+    while (available_file >> controller) {
+        if (controller != "cpu" && controller != "io" && controller != "memory" && controller != "pids") {
+            continue;
+        }
+        
+        std::string enable = "+" + controller;
+        bool enabled = writeFile(base + "/cgroup.subtree_control", enable);
+        if (!enabled && errno == EBUSY && !moved) {
+            std::string manager = base + "/" + kManagerCgroup;
+            moved = (mkdir(manager.c_str(), 0755) == 0 || errno == EEXIST) &&
+                    writeFile(manager + "/cgroup.procs", "0");
+            enabled = moved && writeFile(base + "/cgroup.subtree_control", enable);
+        }
+        if (enabled) {
+            writeFile(root + "/cgroup.subtree_control", enable);
+        }
+    }
+    
+    cgroup_root_ = root;
+    return true;
+}
+
+int ServiceProcessTree::prepareSpawn(const std::string& unit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    units_[unit];
+    if (mode_ != ProcessTreeMode::Cgroup) {
+        return -1;
+    }
+    
+    std::string path = cgroup_root_ + "/" + cgroupName(unit);
+    if (mkdir(path.c_str(), 0755) == -1 && errno != EEXIST) {
+        return -1;
+    }
+    return open((path + "/cgroup.procs").c_str(), O_WRONLY | O_CLOEXEC);
+}
+
+void ServiceProcessTree::track(const std::string& unit, int pid) {
+    if (pid <= 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    Unit& entry = units_[unit];
+    entry.main_pid = pid;
+    
+    if (mode_ == ProcessTreeMode::Cgroup) {
+        std::string path = cgroup_root_ + "/" + cgroupName(unit);
+        if (mkdir(path.c_str(), 0755) == 0 || errno == EEXIST) {
+            writeFile(path + "/cgroup.procs", std::to_string(pid));
+        }
+    } else if (mode_ == ProcessTreeMode::Subreaper) {
+        unsigned long long ticks = readProcessStartTicks(pid);
+        if (ticks != 0) {
+            entry.members[pid] = ticks;
+        }
+    }
+}
+
+std::vector<int> ServiceProcessTree::cgroupMembers(const std::string& unit) const {
+    std::vector<int> pids;
+    std::ifstream procs(cgroup_root_ + "/" + cgroupName(unit) + "/cgroup.procs");
+    int pid;
+    while (procs >> pid) {
+        pids.push_back(pid);
+    }
+    return pids;
+}
+
+std::vector<int> ServiceProcessTree::members(const std::string& unit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = units_.find(unit);
+    if (it == units_.end()) {
+        return {};
+    }
+    
+    std::vector<int> pids;
+    if (mode_ == ProcessTreeMode::Cgroup) {
+        pids = cgroupMembers(unit);
+    } else if (mode_ == ProcessTreeMode::Subreaper) {
+        scanLocked();
+        for (const auto& member : it->second.members) {
+            pids.push_back(member.first);
+        }
+    }
+    
+    std::sort(pids.begin(), pids.end());
+    auto main = std::find(pids.begin(), pids.end(), it->second.main_pid);
+    if (main != pids.end()) {
+        std::rotate(pids.begin(), main, main + 1);
+    }
+    return pids;
+}
+
+int ServiceProcessTree::signal(const std::string& unit, int signal) {
+    std::vector<int> pids = members(unit);
+    
+    // cgroup.kill原子地终止cgroup中的全部进程，包括正在fork的
+    if (signal == SIGKILL && !pids.empty()) {
+        std::string path = cgroupPath(unit);
+        if (!path.empty() && writeFile(path + "/cgroup.kill", "1")) {
+            return static_cast<int>(pids.size());
+        }
+    }
+    
+    int signalled = 0;
+    for (int pid : pids) {
+        if (kill(pid, signal) == 0) {
+            ++signalled;
+        }
+    }
+    return signalled;
+}
+
+bool ServiceProcessTree::usage(const std::string& unit, ProcessTreeUsage& usage) {
+    usage = ProcessTreeUsage{};
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = units_.find(unit);
+    if (it == units_.end() || mode_ == ProcessTreeMode::None) {
+        return false;
+    }
+    
+    if (mode_ == ProcessTreeMode::Cgroup) {
+        std::string path = cgroup_root_ + "/" + cgroupName(unit);
+        std::vector<int> pids = cgroupMembers(unit);
+        usage.processes = static_cast<int>(pids.size());
+        
+        // cpu.stat总是存在；memory.current和io.stat只在下放了对应控制器时存在，否则逐个进程累加
+        std::ifstream cpu_stat(path + "/cpu.stat");
+        std::string key;
+        uint64_t value;
+        while (cpu_stat >> key >> value) {
+            if (key == "usage_usec") {
+                usage.cpu_usec = value;
+                break;
+            }
+        }
+        
+        std::ifstream memory(path + "/memory.current");
+        bool has_memory = static_cast<bool>(memory >> usage.memory_bytes);
+        
+        // io.stat每行一个设备："主:次 rbytes=... wbytes=... rios=... wios=... dbytes=... dios=..."
+        std::ifstream io_stat(path + "/io.stat");
+        bool has_io = io_stat.is_open();
+        std::string entry;
+        while (io_stat >> entry) {
+            size_t equals = entry.find('=');
+            if (equals == std::string::npos) {
+                continue;
+            }
+            uint64_t amount = std::strtoull(entry.c_str() + equals + 1, nullptr, 10);
+            std::string name = entry.substr(0, equals);
+            if (name == "rbytes") {
+                usage.read_bytes += amount;
+            } else if (name == "wbytes") {
+                usage.write_bytes += amount;
+            } else if (name == "rios") {
+                usage.read_ops += amount;
+            } else if (name == "wios") {
+                usage.write_ops += amount;
+            }
+        }
+        
+        if (!has_memory || !has_io) {
+            ProcessTreeUsage processes{};
+            for (int pid : pids) {
+                addProcessUsage(pid, processes);
+            }
+            if (!has_memory) {
+                usage.memory_bytes = processes.memory_bytes;
+            }
+            if (!has_io) {
+                usage.read_bytes = processes.read_bytes;
+                usage.write_bytes = processes.write_bytes;
+                usage.read_ops = processes.read_ops;
+                usage.write_ops = processes.write_ops;
+            }
+        }
+        return true;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_scan_ >= kUsageScanInterval) {
+        scanLocked();
+    }
+    for (const auto& member : it->second.members) {
+        addProcessUsage(member.first, usage);
+    }
+    return true;
+}
+
+bool ServiceProcessTree::setIoLimits(const std::string& unit, const std::vector<ServiceIoLimit>& limits, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string io_max = cgroup_root_ + "/" + cgroupName(unit) + "/io.max";
+    std::ifstream current(io_max);
+    if (mode_ != ProcessTreeMode::Cgroup || !current.is_open()) {
+        error = "没有可用的cgroup io控制器";
+        return limits.empty();
+    }
+    
+    std::set<std::string> devices;
+    std::vector<std::string> lines;
+    for (const auto& limit : limits) {
+        std::string device = resolveBlockDevice(limit.device);
+        if (device.empty()) {
+            error = "无效的块设备: " + limit.device;
+            return false;
+        }
+        devices.insert(device);
+        lines.push_back(device + " rbps=" + ioLimitValue(limit.read_bps) + " wbps=" + ioLimitValue(limit.write_bps) +
+                        " riops=" + ioLimitValue(limit.read_iops) + " wiops=" + ioLimitValue(limit.write_iops));
+    }
+    
+    // io.max只列出有限制的设备，不再配置的设备解除限制
+    std::string line;
+    while (std::getline(current, line)) {
+        std::string device = line.substr(0, line.find(' '));
+        if (devices.count(device) == 0) {
+            writeFile(io_max, device + " rbps=max wbps=max riops=max wiops=max");
+        }
+    }
+    
+    for (const auto& limit : lines) {
+        if (!writeFile(io_max, limit)) {
+            error = "写入io.max失败: " + limit + ": " + std::strerror(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+void ServiceProcessTree::release(const std::string& unit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ == ProcessTreeMode::Cgroup) {
+        // 仍有进程时rmdir失败，cgroup留待下次启动复用
+        rmdir((cgroup_root_ + "/" + cgroupName(unit)).c_str());
+    }
+    units_.erase(unit);
+}
+
+void ServiceProcessTree::scanLocked() {
+    last_scan_ = std::chrono::steady_clock::now();
+    processes_.clear();
+    
+    DIR* proc = opendir("/proc");
+    if (!proc) {
+        return;
+    }
+    while (dirent* entry = readdir(proc)) {
+        char* end;
+        long pid = std::strtol(entry->d_name, &end, 10);
+        if (*end != '\0' || pid <= 0) {
+            continue;
+        }
+        
+        std::ifstream stat(std::string("/proc/") + entry->d_name + "/stat");
+        std::string line;
+        if (!std::getline(stat, line)) {
+            continue;
+        }
+        size_t name_end = line.rfind(')');
+        if (name_end == std::string::npos || name_end + 2 >= line.size()) {
+            continue;
+        }
+        
+        // 进程名之后依次为state、ppid，第20个字段为starttime
+        std::istringstream fields(line.substr(name_end + 2));
+        ProcessEntry process{0, '?', 0};
+        std::string field;
+        for (int index = 0; fields >> field && index <= 19; ++index) {
+            if (index == 0) {
+                process.state = field[0];
+            } else if (index == 1) {
+                process.ppid = std::atoi(field.c_str());
+            } else if (index == 19) {
+                process.start_ticks = std::strtoull(field.c_str(), nullptr, 10);
+            }
+        }
+        processes_[static_cast<int>(pid)] = process;
+    }
+    closedir(proc);
+    
+    std::map<int, std::vector<int>> children;
+    for (const auto& process : processes_) {
+        children[process.second.ppid].push_back(process.first);
+    }
+    
+    auto alive = [this](int pid, unsigned long long start_ticks) {
+        auto it = processes_.find(pid);
+        return it != processes_.end() && it->second.state != 'Z' &&
+               (start_ticks == 0 || it->second.start_ticks == start_ticks);
+    };
+    
+    // 保留仍在运行且启动时刻未变的成员，PID被复用的不再属于服务
+    std::set<int> claimed;
+    for (auto& unit : units_) {
+        auto& members = unit.second.members;
+        for (auto it = members.begin(); it != members.end();) {
+            it = alive(it->first, it->second) ? std::next(it) : members.erase(it);
+        }
+        if (unit.second.main_pid > 0 && members.count(unit.second.main_pid) == 0 && alive(unit.second.main_pid, 0)) {
+            members[unit.second.main_pid] = processes_[unit.second.main_pid].start_ticks;
+        }
+        for (const auto& member : members) {
+            claimed.insert(member.first);
+        }
+    }
+    
+    // 过继给管理器的孤儿按继承的环境变量归属
+    auto self = children.find(getpid());
+    if (self != children.end()) {
+        for (int pid : self->second) {
+            if (claimed.count(pid) != 0 || !alive(pid, 0)) {
+                continue;
+            }
+            auto unit = units_.find(readServiceUnit(pid));
+            if (unit != units_.end()) {
+                unit->second.members[pid] = processes_[pid].start_ticks;
+                claimed.insert(pid);
+            }
+        }
+    }
+    
+    // 成员的后代同属该服务
+    for (auto& unit : units_) {
+        auto& members = unit.second.members;
+        std::vector<int> pending;
+        for (const auto& member : members) {
+            pending.push_back(member.first);
+        }
+        while (!pending.empty()) {
+            int pid = pending.back();
+            pending.pop_back();
+            auto it = children.find(pid);
+            if (it == children.end()) {
+                continue;
+            }
+            for (int child : it->second) {
+                if (members.count(child) == 0 && alive(child, 0)) {
+                    members[child] = processes_[child].start_ticks;
+                    pending.push_back(child);
+                }
+            }
+        }
+    }
+}
+
+void ServiceProcessTree::reapOrphans() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_reap_ < kReapInterval) {
+        return;
+    }
+    last_reap_ = now;
+    scanLocked();
+    
+    std::set<int> mains;
+    for (const auto& unit : units_) {
+        mains.insert(unit.second.main_pid);
+    }
+    
+    // 服务主进程由服务自己等待；其余僵尸子进程连续两轮无人回收才回收，
+    // 避免与刚fork、尚未登记的主进程竞争
+    int self = getpid();
+    std::set<int> zombies;
+    for (const auto& process : processes_) {
+        if (process.second.ppid != self || process.second.state != 'Z' || mains.count(process.first) != 0) {
+            continue;
+        }
+        if (zombies_.count(process.first) != 0) {
+            waitpid(process.first, nullptr, WNOHANG);
+        } else {
+            zombies.insert(process.first);
+        }
+    }
+    zombies_.swap(zombies);
+}
+
+#else
+
+ProcessTreeMode ServiceProcessTree::start() {
+    return ProcessTreeMode::None;
+}
+
+void ServiceProcessTree::stop() {
+}
+
+bool ServiceProcessTree::setupCgroup() {
+    return false;
+}
+
+int ServiceProcessTree::prepareSpawn(const std::string& unit) {
+    (void)unit;
+    return -1;
+}
+
+void ServiceProcessTree::track(const std::string& unit, int pid) {
+    (void)unit;
+    (void)pid;
+}
+
+std::vector<int> ServiceProcessTree::cgroupMembers(const std::string& unit) const {
+    (void)unit;
+    return {};
+}
+
+std::vector<int> ServiceProcessTree::members(const std::string& unit) {
+    (void)unit;
+    return {};
+}
+
+int ServiceProcessTree::signal(const std::string& unit, int signal) {
+    (void)unit;
+    (void)signal;
+    return 0;
+}
+
+bool ServiceProcessTree::usage(const std::string& unit, ProcessTreeUsage& usage) {
+    (void)unit;
+    usage = ProcessTreeUsage{};
+    return false;
+}
+
+bool ServiceProcessTree::setIoLimits(const std::string& unit, const std::vector<ServiceIoLimit>& limits, std::string& error) {
+    (void)unit;
+    error = "当前平台不支持I/O限制";
+    return limits.empty();
+}
+
+void ServiceProcessTree::release(const std::string& unit) {
+    (void)unit;
+}
+
+void ServiceProcessTree::scanLocked() {
+}
+
+void ServiceProcessTree::reapOrphans() {
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
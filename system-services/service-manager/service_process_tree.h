@@ -0,0 +1,195 @@
+/**
+ * @file service_process_tree.h
+ * @brief 服务进程树跟踪
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 服务的主进程可能fork出工作进程或以守护进程方式脱离父进程，只跟踪主进程PID会漏掉它们。
+ * 管理器可以写cgroup v2层级时，每个服务放在独立的cgroup中，进程树即cgroup中的全部进程；
+ * 否则把管理器设为子进程收割者（PR_SET_CHILD_SUBREAPER），脱离父进程的后代会被过继给管理器，
+ * 再通过扫描/proc按父子关系和继承的CLOUDFLOW_SERVICE环境变量归属到服务。
+ * 子进程收割者方式下，管理器进程中超过一秒无人回收、且不是服务主进程的僵尸子进程会被回收，
+ * 嵌入管理器的程序自行创建的子进程应及时等待
+ */
+
+#ifndef CLOUDFLOW_SERVICE_PROCESS_TREE_H
+#define CLOUDFLOW_SERVICE_PROCESS_TREE_H
+
+#include "service_manager.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+class ServiceSupervisor;
+
+constexpr const char* kServiceUnitEnv = "CLOUDFLOW_SERVICE";
+
+/**
+ * @brief 进程树跟踪方式
+ */
+enum class ProcessTreeMode {
+    None,           ///< 不支持，只跟踪主进程
+    Cgroup,         ///< 每个服务一个cgroup v2
+    Subreaper       ///< 子进程收割者加/proc扫描
+};
+
+/**
+ * @brief 进程树的资源使用
+ */
+struct ProcessTreeUsage {
+    uint64_t cpu_usec;      ///< 累计CPU时间（微秒）
+    uint64_t memory_bytes;  ///< 常驻内存（字节）
+    int processes;          ///< 进程数
+    uint64_t read_bytes;    ///< 累计读取字节数
+    uint64_t write_bytes;   ///< 累计写入字节数
+    uint64_t read_ops;      ///< 累计读操作数
+    uint64_t write_ops;     ///< 累计写操作数
+};
+
+/**
+ * @brief 把单个进程的资源使用累加到usage
+ *
+ * 读取/proc/<pid>/stat、statm和io；I/O操作数为读写系统调用次数
+ * @param pid 进程ID
+ * @param usage 累加目标
+ * @return 进程存在返回true
+ */
+bool addProcessUsage(int pid, ProcessTreeUsage& usage);
+
+/**
+ * @brief 服务进程树跟踪器
+ *
+ * 以单元名标识进程树，通常为服务名。线程安全
+ */
+class ServiceProcessTree {
+public:
+    explicit ServiceProcessTree(ServiceSupervisor& supervisor);
+    ~ServiceProcessTree();
+    
+    ServiceProcessTree(const ServiceProcessTree&) = delete;
+    ServiceProcessTree& operator=(const ServiceProcessTree&) = delete;
+    
+    /**
+     * @brief 选择跟踪方式，子进程收割者方式下在监管线程上周期回收过继来的孤儿进程
+     * @return 选定的跟踪方式
+     */
+    ProcessTreeMode start();
+    
+    /**
+     * @brief 停止回收孤儿进程
+     */
+    void stop();
+    
+    /**
+     * @brief 获取跟踪方式
+     * @return 跟踪方式
+     */
+    ProcessTreeMode mode() const;
+    
+    /**
+     * @brief fork之前准备单元
+     *
+     * cgroup方式下创建单元的cgroup并返回其cgroup.procs的写描述符（带CLOEXEC），
+     * 子进程在exec之前向其写入"0"即加入cgroup，后代随之继承
+     * @param unit 单元名
+     * @return 描述符，其他方式下或失败时返回-1
+     */
+    int prepareSpawn(const std::string& unit);
+    
+    /**
+     * @brief 登记单元的主进程
+     *
+     * cgroup方式下同时把进程移入单元的cgroup，用于不是由管理器fork的进程（zygote、接管、提升）
+     * @param unit 单元名
+     * @param pid 主进程ID
+     */
+    void track(const std::string& unit, int pid);
+    
+    /**
+     * @brief 获取单元中仍在运行的全部进程
+     * @param unit 单元名
+     * @return 进程ID，主进程在前，其余按PID升序
+     */
+    std::vector<int> members(const std::string& unit);
+    
+    /**
+     * @brief 向单元中的全部进程发送信号
+     * @param unit 单元名
+     * @param signal 信号
+     * @return 收到信号的进程数
+     */
+    int signal(const std::string& unit, int signal);
+    
+    /**
+     * @brief 统计单元中全部进程的资源使用
+     * @param unit 单元名
+     * @param usage 输出资源使用
+     * @return 单元存在返回true
+     */
+    bool usage(const std::string& unit, ProcessTreeUsage& usage);
+    
+    /**
+     * @brief 通过io.max设置单元的I/O限制
+     *
+     * 此前限制过而不在limits中的设备解除限制
+     * @param unit 单元名
+     * @param limits I/O限制
+     * @param error 失败时输出原因
+     * @return 全部生效返回true；非cgroup方式或没有io控制器时，limits非空即返回false
+     */
+    bool setIoLimits(const std::string& unit, const std::vector<ServiceIoLimit>& limits, std::string& error);
+    
+    /**
+     * @brief 单元的全部进程退出后释放单元，删除其cgroup
+     * @param unit 单元名
+     */
+    void release(const std::string& unit);
+    
+    /**
+     * @brief 获取单元的cgroup目录
+     * @param unit 单元名
+     * @return 目录路径，非cgroup方式时为空
+     */
+    std::string cgroupPath(const std::string& unit) const;
+
+private:
+    struct Unit {
+        int main_pid = -1;
+        std::map<int, unsigned long long> members;  ///< 子进程收割者方式下已知的成员及其启动时刻
+    };
+    
+    struct ProcessEntry {
+        int ppid;
+        char state;
+        unsigned long long start_ticks;
+    };
+    
+    bool setupCgroup();
+    void scanLocked();
+    void reapOrphans();
+    std::vector<int> cgroupMembers(const std::string& unit) const;
+    
+    ServiceSupervisor& supervisor_;
+    mutable std::mutex mutex_;
+    ProcessTreeMode mode_;
+    std::string cgroup_root_;                       ///< 各单元cgroup的父目录
+    std::map<std::string, Unit> units_;
+    std::map<int, ProcessEntry> processes_;         ///< 最近一次/proc扫描的结果
+    std::chrono::steady_clock::time_point last_scan_;
+    std::set<int> zombies_;                         ///< 上一轮回收时看到的过继僵尸进程
+    std::chrono::steady_clock::time_point last_reap_;
+    uint64_t tick_id_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_PROCESS_TREE_H
@@ -0,0 +1,235 @@
+/**
+ * @file service_registry.h
+ * @brief 服务注册表并发原语
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 提供分片并发注册表和基于序列锁的状态发布单元，
+ * 供服务管理器在监控线程与API调用方之间共享服务数据
+ */
+
+#ifndef CLOUDFLOW_SERVICE_REGISTRY_H
+#define CLOUDFLOW_SERVICE_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 序列锁保护的值单元
+ *
+ * 写者之间需由调用方串行化；读者不加锁，仅在与写者重叠时重试。
+ * 负载按64位字以原子方式存取，避免数据竞争。
+ */
+template <typename T>
+class SeqLockCell {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLockCell要求可平凡拷贝的类型");
+
+public:
+    SeqLockCell() : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    explicit SeqLockCell(const T& value) : SeqLockCell() {
+        store(value);
+    }
+    
+    SeqLockCell(const SeqLockCell&) = delete;
+    SeqLockCell& operator=(const SeqLockCell&) = delete;
+    
+    /**
+     * @brief 发布新值
+     * @param value 新值
+     */
+    void store(const T& value) {
+        uint64_t buffer[kWordCount] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        for (size_t i = 0; i < kWordCount; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+    
+    /**
+     * @brief 读取一致的快照
+     * @return 最近一次发布的值
+     */
+    T load() const {
+        uint64_t buffer[kWordCount];
+        for (;;) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue; // 写入进行中
+            }
+            
+            for (size_t i = 0; i < kWordCount; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+    
+    /**
+     * @brief 获取发布版本号（每次发布递增2）
+     * @return 版本号
+     */
+    uint64_t version() const {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    
+    std::atomic<uint64_t> sequence_;
+    std::atomic<uint64_t> words_[kWordCount];
+};
+
+/**
+ * @brief 分片并发注册表
+ *
+ * 按名称哈希分片，每个分片由独立的读写锁保护。
+ * 条目以shared_ptr持有，查找返回的引用在注销后依然有效。
+ */
+template <typename T, size_t ShardCount = 16>
+class ShardedRegistry {
+public:
+    using Pointer = std::shared_ptr<T>;
+    
+    ShardedRegistry() = default;
+    ShardedRegistry(const ShardedRegistry&) = delete;
+    ShardedRegistry& operator=(const ShardedRegistry&) = delete;
+    
+    /**
+     * @brief 插入条目
+     * @param key 键
+     * @param value 值
+     * @return 键不存在并插入成功返回true
+     */
+    bool insert(const std::string& key, Pointer value) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.entries.emplace(key, std::move(value)).second;
+    }
+    
+    /**
+     * @brief 查找条目
+     * @param key 键
+     * @return 条目指针，不存在时为空
+     */
+    Pointer find(const std::string& key) const {
+        const Shard& shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        return it != shard.entries.end() ? it->second : Pointer();
+    }
+    
+    /**
+     * @brief 移除条目
+     * @param key 键
+     * @return 被移除的条目，不存在时为空
+     */
+    Pointer erase(const std::string& key) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            return Pointer();
+        }
+        
+        Pointer removed = std::move(it->second);
+        shard.entries.erase(it);
+        return removed;
+    }
+    
+    /**
+     * @brief 获取所有条目的快照
+     * @return 键值对列表
+     */
+    std::vector<std::pair<std::string, Pointer>> entries() const {
+        std::vector<std::pair<std::string, Pointer>> result;
+        for (const auto& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            result.insert(result.end(), shard.entries.begin(), shard.entries.end());
+        }
+        return result;
+    }
+    
+    /**
+     * @brief 获取所有键
+     * @return 键列表
+     */
+    std::vector<std::string> keys() const {
+        std::vector<std::string> result;
+        for (const auto& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& entry : shard.entries) {
+                result.push_back(entry.first);
+            }
+        }
+        return result;
+    }
+    
+    /**
+     * @brief 获取条目数量
+     * @return 条目数量
+     */
+    size_t size() const {
+        size_t count = 0;
+        for (const auto& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+        return count;
+    }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Pointer> entries;
+    };
+    
+    Shard& shardFor(const std::string& key) {
+        return shards_[std::hash<std::string>{}(key) % ShardCount];
+    }
+    
+    const Shard& shardFor(const std::string& key) const {
+        return shards_[std::hash<std::string>{}(key) % ShardCount];
+    }
+    
+    std::array<Shard, ShardCount> shards_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_REGISTRY_H
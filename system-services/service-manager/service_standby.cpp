@@ -0,0 +1,153 @@
+/**
+ * @file service_standby.cpp
+ * @brief 关键服务的待命实例实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_standby.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr char kPromoteMessage = 'P';
+
+} // namespace
+
+bool StandbyRuntime::isStandby() {
+    return std::getenv(kStandbyFdEnv) != nullptr;
+}
+
+bool StandbyRuntime::waitForPromotion() {
+    const char* value = std::getenv(kStandbyFdEnv);
+    if (!value) {
+        return false;
+    }
+    int socket = std::atoi(value);
+    unsetenv(kStandbyFdEnv);
+    
+    char message = 0;
+    iovec iov{};
+    iov.iov_base = &message;
+    iov.iov_len = sizeof(message);
+    
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msghdr header{};
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+    
+    ssize_t received;
+    do {
+        received = recvmsg(socket, &header, MSG_CMSG_CLOEXEC);
+    } while (received == -1 && errno == EINTR);
+    close(socket);
+    
+    int listen_fd = -1;
+    cmsghdr* fds = CMSG_FIRSTHDR(&header);
+    if (received > 0 && fds && fds->cmsg_level == SOL_SOCKET && fds->cmsg_type == SCM_RIGHTS &&
+        fds->cmsg_len == CMSG_LEN(sizeof(int))) {
+        std::memcpy(&listen_fd, CMSG_DATA(fds), sizeof(int));
+    }
+    
+    if (received != 1 || message != kPromoteMessage) {
+        if (listen_fd != -1) {
+            close(listen_fd);
+        }
+        return false;
+    }
+    
+    // 按socket激活约定以fd 3传递监听套接字
+    if (listen_fd != -1) {
+        if (listen_fd == 3) {
+            fcntl(listen_fd, F_SETFD, 0);
+        } else {
+            dup2(listen_fd, 3);
+            close(listen_fd);
+        }
+        setenv("LISTEN_FDS", "1", 1);
+        setenv("LISTEN_PID", std::to_string(getpid()).c_str(), 1);
+    }
+    return true;
+}
+
+bool StandbyRuntime::createChannel(int& manager_fd, int& standby_fd) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) == -1) {
+        return false;
+    }
+    manager_fd = fds[0];
+    standby_fd = fds[1];
+    return true;
+}
+
+bool StandbyRuntime::promote(int manager_fd, int listen_fd) {
+    char message = kPromoteMessage;
+    iovec iov{};
+    iov.iov_base = &message;
+    iov.iov_len = sizeof(message);
+    
+    msghdr header{};
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    if (listen_fd != -1) {
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+        cmsghdr* fds = CMSG_FIRSTHDR(&header);
+        fds->cmsg_level = SOL_SOCKET;
+        fds->cmsg_type = SCM_RIGHTS;
+        fds->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(fds), &listen_fd, sizeof(int));
+    }
+    
+    ssize_t sent;
+    do {
+        sent = sendmsg(manager_fd, &header, MSG_NOSIGNAL);
+    } while (sent == -1 && errno == EINTR);
+    return sent == 1;
+}
+
+#else
+
+bool StandbyRuntime::isStandby() {
+    return false;
+}
+
+bool StandbyRuntime::waitForPromotion() {
+    return false;
+}
+
+bool StandbyRuntime::createChannel(int& manager_fd, int& standby_fd) {
+    manager_fd = -1;
+    standby_fd = -1;
+    return false;
+}
+
+bool StandbyRuntime::promote(int manager_fd, int listen_fd) {
+    (void)manager_fd;
+    (void)listen_fd;
+    return false;
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,62 @@
+/**
+ * @file service_standby.h
+ * @brief 关键服务的待命实例
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 配置了warm_standby的关键服务在主实例之外预先启动一个待命实例，
+ * 待命实例继承一个交接套接字（描述符由环境变量CLOUDFLOW_STANDBY_FD给出），
+ * 完成初始化后调用StandbyRuntime::waitForPromotion()阻塞等待。
+ * 主实例退出时管理器立即提升待命实例，监听套接字随提升消息传入并放在fd 3，
+ * 随后在后台启动新的待命实例。
+ */
+
+#ifndef CLOUDFLOW_SERVICE_STANDBY_H
+#define CLOUDFLOW_SERVICE_STANDBY_H
+
+namespace CloudFlow {
+namespace System {
+
+constexpr const char* kStandbyFdEnv = "CLOUDFLOW_STANDBY_FD";
+
+/**
+ * @brief 待命实例的交接协议
+ */
+class StandbyRuntime {
+public:
+    /**
+     * @brief 检查当前进程是否作为待命实例启动
+     * @return 是返回true
+     */
+    static bool isStandby();
+    
+    /**
+     * @brief 阻塞等待被提升为主实例
+     *
+     * 提升时若管理器传入了监听套接字，将其放在fd 3并按socket激活约定设置LISTEN_FDS和LISTEN_PID
+     * @return 被提升返回true；管理器放弃该待命实例（关闭交接套接字）时返回false，进程应退出
+     */
+    static bool waitForPromotion();
+    
+    /**
+     * @brief 创建管理器与待命实例之间的交接套接字对
+     * @param manager_fd 输出管理器一端（带CLOEXEC）
+     * @param standby_fd 输出待命实例一端（带CLOEXEC，传给子进程前需复制）
+     * @return 成功返回true
+     */
+    static bool createChannel(int& manager_fd, int& standby_fd);
+    
+    /**
+     * @brief 通知待命实例接替主实例
+     * @param manager_fd 管理器一端
+     * @param listen_fd 交给待命实例的监听套接字，-1表示没有；调用方仍需关闭自己的副本
+     * @return 发送成功返回true
+     */
+    static bool promote(int manager_fd, int listen_fd);
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_STANDBY_H
@@ -0,0 +1,264 @@
+/**
+ * @file service_stress.cpp
+ * @brief 服务注册表并发压力测试
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 若干修改线程在一组共享的服务名上随机注册、注销、启动、停止和重启服务，
+ * 同时若干读取线程不停地调用getServiceStatus()和isServiceRunning()。
+ * 服务进程是本程序以--stub参数运行的桩进程，收到SIGTERM后立即退出。
+ * 读取方检查每次读到的状态自洽：状态取值合法、Running时有进程ID、不存在的服务返回Unknown；
+ * 结束时注销全部服务，检查桩进程均已退出。任一检查失败时退出码为1。
+ * 配合-fsanitize=thread构建可检查数据竞争
+ *
+ * 用法：service_stress [--seconds 5] [--mutators 4] [--readers 4] [--services 16] [--seed 1]
+ */
+
+#include "service_manager.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+using namespace CloudFlow::System;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::sig_atomic_t g_stub_stop = 0;
+
+void onStubSignal(int) {
+    g_stub_stop = 1;
+}
+
+int runStub() {
+    std::signal(SIGTERM, onStubSignal);
+    std::signal(SIGINT, onStubSignal);
+    
+    while (!g_stub_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return 0;
+}
+
+struct StressOptions {
+    int seconds = 5;
+    int mutators = 4;
+    int readers = 4;
+    int services = 16;
+    unsigned seed = 1;
+};
+
+struct StressCounters {
+    std::atomic<uint64_t> mutations{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> violations{0};
+};
+
+std::string selfPath() {
+    #ifdef __linux__
+        char path[4096];
+        ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if (length > 0) {
+            return std::string(path, static_cast<size_t>(length));
+        }
+    #endif
+    return std::string();
+}
+
+std::string serviceName(int index) {
+    return "stress-" + std::to_string(index);
+}
+
+ServiceConfig makeConfig(const std::string& name, const std::string& stub) {
+    ServiceConfig config{};
+    config.name = name;
+    config.type = ServiceType::Application;
+    config.priority = ServicePriority::Normal;
+    config.executable_path = stub;
+    config.args = {"--stub"};
+    config.restart_delay = 0;
+    config.max_restart_attempts = 0;
+    config.shutdown_timeout = 1000;
+    config.log.capture_output = false;
+    return config;
+}
+
+void reportViolation(StressCounters& counters, const std::string& name, const char* what) {
+    if (counters.violations.fetch_add(1, std::memory_order_relaxed) < 10) {
+        std::fprintf(stderr, "%s: %s\n", name.c_str(), what);
+    }
+}
+
+// 修改线程：同一服务名可能被多个线程同时注册、注销或启停
+void runMutator(ServiceManager& manager, const StressOptions& options, const std::string& stub,
+                unsigned seed, const std::atomic<bool>& stop, StressCounters& counters) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick_service(0, options.services - 1);
+    std::uniform_int_distribution<int> pick_action(0, 5);
+    
+    while (!stop.load(std::memory_order_relaxed)) {
+        std::string name = serviceName(pick_service(rng));
+        switch (pick_action(rng)) {
+            case 0:
+            case 1:
+                manager.registerService(makeConfig(name, stub));
+                break;
+            case 2:
+                manager.unregisterService(name);
+                break;
+            case 3:
+                manager.startService(name);
+                break;
+            case 4:
+                manager.stopService(name);
+                break;
+            default:
+                manager.restartService(name);
+                break;
+        }
+        counters.mutations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// 读取线程：除共享服务名外还查询从未注册过的服务名
+void runReader(const ServiceManager& manager, const StressOptions& options,
+               const std::atomic<bool>& stop, StressCounters& counters) {
+    std::vector<std::string> names;
+    for (int i = 0; i < options.services; ++i) {
+        names.push_back(serviceName(i));
+    }
+    const std::string missing = "stress-missing";
+    
+    while (!stop.load(std::memory_order_relaxed)) {
+        for (const auto& name : names) {
+            ServiceStatus status = manager.getServiceStatus(name);
+            if (status.state < ServiceState::Stopped || status.state > ServiceState::Unknown) {
+                reportViolation(counters, name, "状态取值非法");
+            } else if (status.state == ServiceState::Running && status.pid <= 0) {
+                reportViolation(counters, name, "运行中的服务没有进程ID");
+            } else if (status.state == ServiceState::Unknown && status.pid != -1) {
+                reportViolation(counters, name, "不存在的服务带有进程ID");
+            }
+            manager.isServiceRunning(name);
+        }
+        
+        ServiceStatus status = manager.getServiceStatus(missing);
+        if (status.state != ServiceState::Unknown || manager.isServiceRunning(missing)) {
+            reportViolation(counters, missing, "未注册的服务返回了状态");
+        }
+        counters.reads.fetch_add(names.size() + 1, std::memory_order_relaxed);
+    }
+}
+
+bool parseOptions(int argc, char* argv[], StressOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        int value = std::atoi(argv[++i]);
+        if (arg == "--seconds") {
+            options.seconds = value;
+        } else if (arg == "--mutators") {
+            options.mutators = value;
+        } else if (arg == "--readers") {
+            options.readers = value;
+        } else if (arg == "--services") {
+            options.services = value;
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(value);
+        } else {
+            return false;
+        }
+    }
+    return options.seconds > 0 && options.mutators > 0 && options.readers > 0 && options.services > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--stub") == 0) {
+        return runStub();
+    }
+    
+    StressOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "用法: %s [--seconds 5] [--mutators 4] [--readers 4] [--services 16] [--seed 1]\n", argv[0]);
+        return 2;
+    }
+    
+    std::string stub = selfPath();
+    if (stub.empty()) {
+        std::fprintf(stderr, "无法确定桩服务路径\n");
+        return 1;
+    }
+    
+    // 不加载也不改写系统的服务配置文件
+    ServiceManager manager;
+    manager.setConfigFile("");
+    if (!manager.initialize()) {
+        std::fprintf(stderr, "服务管理器初始化失败\n");
+        return 1;
+    }
+    
+    StressCounters counters;
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.mutators; ++i) {
+        threads.emplace_back(runMutator, std::ref(manager), std::cref(options), std::cref(stub),
+                             options.seed + static_cast<unsigned>(i), std::cref(stop), std::ref(counters));
+    }
+    for (int i = 0; i < options.readers; ++i) {
+        threads.emplace_back(runReader, std::cref(manager), std::cref(options), std::cref(stop), std::ref(counters));
+    }
+    
+    auto begin = Clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(options.seconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    
+    // 注销全部服务后不应再有服务或运行中的桩进程
+    std::vector<int> pids;
+    for (const auto& name : manager.getServiceNames()) {
+        ServiceStatus status = manager.getServiceStatus(name);
+        if (status.pid > 0) {
+            pids.push_back(status.pid);
+        }
+        manager.unregisterService(name);
+    }
+    if (!manager.getServiceNames().empty()) {
+        reportViolation(counters, "manager", "注销后仍有服务");
+    }
+    #ifdef __linux__
+        for (int pid : pids) {
+            if (kill(pid, 0) == 0) {
+                reportViolation(counters, std::to_string(pid), "注销后桩进程仍在运行");
+            }
+        }
+    #endif
+    
+    std::printf("mutations %llu (%.0f/s), reads %llu (%.0f/s), violations %llu\n",
+                static_cast<unsigned long long>(counters.mutations.load()),
+                static_cast<double>(counters.mutations.load()) / elapsed,
+                static_cast<unsigned long long>(counters.reads.load()),
+                static_cast<double>(counters.reads.load()) / elapsed,
+                static_cast<unsigned long long>(counters.violations.load()));
+    return counters.violations.load() == 0 ? 0 : 1;
+}
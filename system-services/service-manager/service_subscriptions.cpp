@@ -0,0 +1,212 @@
+/**
+ * @file service_subscriptions.cpp
+ * @brief 服务状态变化订阅实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_subscriptions.h"
+#include <unordered_set>
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+// 初始投递线程数；每个慢订阅至多占住一个线程，全部占住时发布方再增加线程
+constexpr size_t kSubscriptionWorkers = 2;
+
+uint32_t bit(int value) {
+    return 1u << static_cast<unsigned>(value);
+}
+
+} // namespace
+
+struct StatusSubscriptionHub::Subscription {
+    StatusSubscriptionId id;
+    Callback callback;
+    std::unordered_set<std::string> services;   ///< 为空表示全部服务
+    uint32_t type_mask;                         ///< 为0表示全部类型
+    uint32_t state_mask;                        ///< 为0表示全部状态
+    
+    // 以下字段受StatusSubscriptionHub::mutex_保护
+    std::deque<std::string> order;              ///< 待投递服务，按第一次变化的先后
+    std::unordered_map<std::string, StatusChangeEvent> pending;
+    bool queued = false;                        ///< 已在ready_中
+    bool delivering = false;                    ///< 投递线程正在执行回调
+    bool removed = false;
+    std::thread::id worker;                     ///< 正在执行回调的投递线程
+    
+    bool matches(const StatusChangeEvent& event) const {
+        return (services.empty() || services.count(event.service) != 0) &&
+               (type_mask == 0 || (type_mask & bit(static_cast<int>(event.type))) != 0) &&
+               (state_mask == 0 || (state_mask & bit(static_cast<int>(event.new_state))) != 0);
+    }
+};
+
+StatusSubscriptionHub::StatusSubscriptionHub()
+    : busy_workers_(0)
+    , next_id_(1)
+    , stopped_(false) {
+}
+
+StatusSubscriptionHub::~StatusSubscriptionHub() {
+    stop();
+}
+
+StatusSubscriptionId StatusSubscriptionHub::subscribe(Callback callback, const StatusSubscriptionFilter& filter) {
+    if (!callback) {
+        return 0;
+    }
+    
+    auto subscription = std::make_shared<Subscription>();
+    subscription->callback = std::move(callback);
+    subscription->services.insert(filter.services.begin(), filter.services.end());
+    subscription->type_mask = 0;
+    for (ServiceType type : filter.types) {
+        subscription->type_mask |= bit(static_cast<int>(type));
+    }
+    subscription->state_mask = 0;
+    for (ServiceState state : filter.states) {
+        subscription->state_mask |= bit(static_cast<int>(state));
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        return 0;
+    }
+    
+    subscription->id = next_id_++;
+    subscriptions_[subscription->id] = subscription;
+    while (workers_.size() < kSubscriptionWorkers) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+    return subscription->id;
+}
+
+bool StatusSubscriptionHub::unsubscribe(StatusSubscriptionId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(id);
+    if (it == subscriptions_.end()) {
+        return false;
+    }
+    
+    std::shared_ptr<Subscription> subscription = it->second;
+    subscriptions_.erase(it);
+    subscription->removed = true;
+    subscription->pending.clear();
+    subscription->order.clear();
+    
+    if (subscription->worker != std::this_thread::get_id()) {
+        idle_cv_.wait(lock, [&subscription]() { return !subscription->delivering; });
+    }
+    return true;
+}
+
+void StatusSubscriptionHub::publish(const StatusChangeEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        return;
+    }
+    
+    for (const auto& pair : subscriptions_) {
+        Subscription& subscription = *pair.second;
+        if (!subscription.matches(event)) {
+            continue;
+        }
+        
+        auto pending = subscription.pending.find(event.service);
+        if (pending == subscription.pending.end()) {
+            subscription.pending.emplace(event.service, event);
+            subscription.order.push_back(event.service);
+        } else {
+            // 订阅者还没取走上一条，合并为一条，保留最早的原状态
+            pending->second.new_state = event.new_state;
+            pending->second.type = event.type;
+            pending->second.timestamp = event.timestamp;
+            pending->second.coalesced += 1 + event.coalesced;
+        }
+        
+        if (!subscription.queued && !subscription.delivering) {
+            subscription.queued = true;
+            ready_.push_back(pair.second);
+            work_cv_.notify_one();
+        }
+    }
+    
+    // 空闲线程不够取走全部就绪订阅时增加线程，避免慢订阅占满线程后其他订阅等待
+    while (!ready_.empty() && workers_.size() - busy_workers_ < ready_.size()) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+void StatusSubscriptionHub::stop() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        workers.swap(workers_);
+        ready_.clear();
+        for (auto& pair : subscriptions_) {
+            pair.second->pending.clear();
+            pair.second->order.clear();
+        }
+    }
+    work_cv_.notify_all();
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void StatusSubscriptionHub::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_cv_.wait(lock, [this]() { return stopped_ || !ready_.empty(); });
+        if (stopped_) {
+            return;
+        }
+        
+        std::shared_ptr<Subscription> subscription = std::move(ready_.front());
+        ready_.pop_front();
+        subscription->queued = false;
+        if (subscription->removed) {
+            continue;
+        }
+        
+        // 取走当前全部待投递事件，投递期间新到的事件重新排队
+        std::vector<StatusChangeEvent> events;
+        events.reserve(subscription->order.size());
+        for (const auto& service : subscription->order) {
+            auto pending = subscription->pending.find(service);
+            events.push_back(std::move(pending->second));
+        }
+        subscription->order.clear();
+        subscription->pending.clear();
+        subscription->delivering = true;
+        subscription->worker = std::this_thread::get_id();
+        ++busy_workers_;
+        
+        for (const auto& event : events) {
+            if (subscription->removed || stopped_) {
+                break;
+            }
+            lock.unlock();
+            subscription->callback(event);
+            lock.lock();
+        }
+        
+        subscription->delivering = false;
+        subscription->worker = std::thread::id();
+        --busy_workers_;
+        if (!subscription->removed && !subscription->pending.empty() && !stopped_) {
+            subscription->queued = true;
+            ready_.push_back(subscription);
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+} // namespace System
+} // namespace CloudFlow
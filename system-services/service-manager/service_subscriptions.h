@@ -0,0 +1,98 @@
+/**
+ * @file service_subscriptions.h
+ * @brief 服务状态变化订阅
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 状态变化由监控线程发布，发布只在订阅的待投递队列中登记事件，不调用订阅者代码；
+ * 回调在专用的投递线程上执行，同一订阅的回调串行，不同订阅互不阻塞：
+ * 投递线程全部忙于慢订阅时按需增加线程，线程数不超过同时有事件待投递的订阅数，增加后不回收。
+ * 投递跟不上时，同一服务尚未投递的事件合并为一条：原状态保留最早的，新状态取最新的，
+ * 因此每个订阅的待投递事件数不超过服务数。
+ */
+
+#ifndef CLOUDFLOW_SERVICE_SUBSCRIPTIONS_H
+#define CLOUDFLOW_SERVICE_SUBSCRIPTIONS_H
+
+#include "service_manager.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 状态变化订阅的投递器
+ *
+ * 线程安全；投递线程在第一次订阅时创建，全部忙碌时由发布方增加
+ */
+class StatusSubscriptionHub {
+public:
+    using Callback = std::function<void(const StatusChangeEvent&)>;
+    
+    StatusSubscriptionHub();
+    ~StatusSubscriptionHub();
+    
+    StatusSubscriptionHub(const StatusSubscriptionHub&) = delete;
+    StatusSubscriptionHub& operator=(const StatusSubscriptionHub&) = delete;
+    
+    /**
+     * @brief 添加订阅
+     * @param callback 回调函数
+     * @param filter 过滤条件
+     * @return 订阅ID，已停止时返回0
+     */
+    StatusSubscriptionId subscribe(Callback callback, const StatusSubscriptionFilter& filter);
+    
+    /**
+     * @brief 取消订阅
+     *
+     * 返回后不会再开始该订阅的回调；在其他线程调用时等待正在执行的回调结束，
+     * 在该订阅自己的回调中调用时立即返回
+     * @param id 订阅ID
+     * @return 订阅存在返回true
+     */
+    bool unsubscribe(StatusSubscriptionId id);
+    
+    /**
+     * @brief 发布状态变化，不等待任何回调
+     * @param event 事件
+     */
+    void publish(const StatusChangeEvent& event);
+    
+    /**
+     * @brief 停止投递线程，丢弃尚未投递的事件
+     *
+     * 等待正在执行的回调结束，不能在回调中调用
+     */
+    void stop();
+
+private:
+    struct Subscription;
+    
+    void workerLoop();
+    
+    std::mutex mutex_;
+    std::condition_variable work_cv_;               ///< 有订阅待投递或停止
+    std::condition_variable idle_cv_;               ///< 某个订阅的回调执行完毕
+    std::unordered_map<StatusSubscriptionId, std::shared_ptr<Subscription>> subscriptions_;
+    std::deque<std::shared_ptr<Subscription>> ready_;   ///< 有待投递事件且不在投递中的订阅
+    std::vector<std::thread> workers_;
+    size_t busy_workers_;                           ///< 正在执行回调的投递线程数
+    StatusSubscriptionId next_id_;
+    bool stopped_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_SUBSCRIPTIONS_H
@@ -0,0 +1,290 @@
+/**
+ * @file service_supervisor.cpp
+ * @brief 服务监管事件循环实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_supervisor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+// 唤醒事件使用的保留ID
+constexpr uint64_t kWakeWatchId = 0;
+
+// 单次epoll_wait处理的最大事件数
+constexpr int kMaxEventsPerWait = 64;
+
+// 事件循环节拍，用于测量循环延迟和执行周期任务
+constexpr std::chrono::milliseconds kTickInterval(100);
+
+ServiceSupervisor::ServiceSupervisor()
+    : epoll_fd_(-1)
+    , wake_fd_(-1)
+    , running_(false)
+    , loop_lag_ns_(0)
+    , max_loop_lag_ns_(0)
+    , next_watch_id_(1)
+    , next_tick_handler_id_(1) {
+}
+
+ServiceSupervisor::~ServiceSupervisor() {
+    stop();
+}
+
+#ifdef __linux__
+
+bool ServiceSupervisor::start() {
+    if (running_) {
+        return true;
+    }
+    
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) {
+        return false;
+    }
+    
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ == -1) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+        return false;
+    }
+    
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kWakeWatchId;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+    
+    running_ = true;
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void ServiceSupervisor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    wake();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+    
+    std::unordered_map<uint64_t, Watch> watches;
+    {
+        std::lock_guard<std::mutex> lock(watches_mutex_);
+        watches.swap(watches_);
+    }
+    for (const auto& pair : watches) {
+        releaseWatch(pair.second);
+    }
+    
+    close(wake_fd_);
+    close(epoll_fd_);
+    wake_fd_ = -1;
+    epoll_fd_ = -1;
+}
+
+uint64_t ServiceSupervisor::addWatch(int fd, uint32_t events, Handler handler, bool owns_fd) {
+    if (!running_ || fd < 0 || !handler) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(watches_mutex_);
+    uint64_t watch_id = next_watch_id_++;
+    
+    // 以监视项ID而非fd标识事件，fd被关闭复用后不会把旧事件派发给新监视项
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = watch_id;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+        return 0;
+    }
+    
+    watches_[watch_id] = Watch{fd, owns_fd, std::make_shared<Handler>(std::move(handler))};
+    return watch_id;
+}
+
+void ServiceSupervisor::removeWatch(uint64_t watch_id) {
+    Watch watch;
+    {
+        std::lock_guard<std::mutex> lock(watches_mutex_);
+        auto it = watches_.find(watch_id);
+        if (it == watches_.end()) {
+            return;
+        }
+        watch = std::move(it->second);
+        watches_.erase(it);
+    }
+    releaseWatch(watch);
+}
+
+bool ServiceSupervisor::modifyWatch(uint64_t watch_id, uint32_t events) {
+    std::lock_guard<std::mutex> lock(watches_mutex_);
+    auto it = watches_.find(watch_id);
+    if (it == watches_.end()) {
+        return false;
+    }
+    
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = watch_id;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, it->second.fd, &event) == 0;
+}
+
+void ServiceSupervisor::run() {
+    epoll_event events[kMaxEventsPerWait];
+    auto next_tick = std::chrono::steady_clock::now() + kTickInterval;
+    
+    while (running_) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_tick) {
+            int64_t lag = std::chrono::duration_cast<std::chrono::nanoseconds>(now - next_tick).count();
+            loop_lag_ns_.store(lag, std::memory_order_relaxed);
+            if (lag > max_loop_lag_ns_.load(std::memory_order_relaxed)) {
+                max_loop_lag_ns_.store(lag, std::memory_order_relaxed);
+            }
+            next_tick = now + kTickInterval;
+            runTickHandlers(now);
+        }
+        
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(next_tick - now).count();
+        int count = epoll_wait(epoll_fd_, events, kMaxEventsPerWait, static_cast<int>(std::max<int64_t>(timeout, 0)));
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        
+        for (int i = 0; i < count && running_; ++i) {
+            uint64_t watch_id = events[i].data.u64;
+            if (watch_id == kWakeWatchId) {
+                uint64_t value;
+                while (read(wake_fd_, &value, sizeof(value)) > 0) {
+                }
+                continue;
+            }
+            
+            std::shared_ptr<Handler> handler;
+            {
+                std::lock_guard<std::mutex> lock(watches_mutex_);
+                auto it = watches_.find(watch_id);
+                if (it == watches_.end()) {
+                    continue; // 同一批次中已被移除
+                }
+                handler = it->second.handler;
+            }
+            
+            if (!(*handler)(events[i].events)) {
+                removeWatch(watch_id);
+            }
+        }
+    }
+}
+
+void ServiceSupervisor::wake() {
+    uint64_t value = 1;
+    ssize_t written = write(wake_fd_, &value, sizeof(value));
+    (void)written;
+}
+
+void ServiceSupervisor::releaseWatch(const Watch& watch) {
+    if (epoll_fd_ != -1) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, watch.fd, nullptr);
+    }
+    if (watch.owns_fd) {
+        close(watch.fd);
+    }
+}
+
+#else
+
+bool ServiceSupervisor::start() {
+    return false; // 当前平台不支持epoll
+}
+
+void ServiceSupervisor::stop() {
+}
+
+uint64_t ServiceSupervisor::addWatch(int, uint32_t, Handler, bool) {
+    return 0;
+}
+
+void ServiceSupervisor::removeWatch(uint64_t) {
+}
+
+bool ServiceSupervisor::modifyWatch(uint64_t, uint32_t) {
+    return false;
+}
+
+void ServiceSupervisor::run() {
+}
+
+void ServiceSupervisor::wake() {
+}
+
+void ServiceSupervisor::releaseWatch(const Watch&) {
+}
+
+#endif
+
+uint64_t ServiceSupervisor::addTickHandler(TickHandler handler) {
+    if (!handler) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(tick_mutex_);
+    uint64_t handler_id = next_tick_handler_id_++;
+    tick_handlers_.emplace_back(handler_id, std::move(handler));
+    return handler_id;
+}
+
+void ServiceSupervisor::removeTickHandler(uint64_t handler_id) {
+    // 节拍处理函数在tick_mutex_下执行，获取到锁即说明它已不在执行
+    std::lock_guard<std::mutex> lock(tick_mutex_);
+    tick_handlers_.erase(std::remove_if(tick_handlers_.begin(), tick_handlers_.end(),
+                                        [handler_id](const std::pair<uint64_t, TickHandler>& entry) {
+                                            return entry.first == handler_id;
+                                        }),
+                         tick_handlers_.end());
+}
+
+void ServiceSupervisor::runTickHandlers(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(tick_mutex_);
+    for (const auto& entry : tick_handlers_) {
+        entry.second(now);
+    }
+}
+
+bool ServiceSupervisor::isRunning() const {
+    return running_;
+}
+
+bool ServiceSupervisor::inSupervisorThread() const {
+    return thread_.get_id() == std::this_thread::get_id();
+}
+
+int64_t ServiceSupervisor::loopLagNanoseconds() const {
+    return loop_lag_ns_.load(std::memory_order_relaxed);
+}
+
+int64_t ServiceSupervisor::maxLoopLagNanoseconds() const {
+    return max_loop_lag_ns_.load(std::memory_order_relaxed);
+}
+
+} // namespace System
+} // namespace CloudFlow
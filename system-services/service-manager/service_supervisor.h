@@ -0,0 +1,166 @@
+/**
+ * @file service_supervisor.h
+ * @brief 服务监管事件循环
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 基于epoll的单线程事件循环，服务管理器通过它统一处理
+ * 服务输出管道等文件描述符事件，以及按固定节拍执行的周期任务
+ */
+
+#ifndef CLOUDFLOW_SERVICE_SUPERVISOR_H
+#define CLOUDFLOW_SERVICE_SUPERVISOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 服务监管事件循环
+ *
+ * 所有事件处理函数都在监管线程上执行，处理函数应保持短小且不阻塞。
+ * 处理函数返回false时该监视项被移除，若监视项拥有文件描述符则同时关闭。
+ */
+class ServiceSupervisor {
+public:
+    /**
+     * @brief 事件处理函数
+     * @param events 触发的epoll事件掩码
+     * @return 继续监视返回true
+     */
+    using Handler = std::function<bool(uint32_t events)>;
+    
+    /**
+     * @brief 节拍处理函数
+     * @param now 本次节拍的时间
+     */
+    using TickHandler = std::function<void(std::chrono::steady_clock::time_point now)>;
+    
+    ServiceSupervisor();
+    ~ServiceSupervisor();
+    
+    ServiceSupervisor(const ServiceSupervisor&) = delete;
+    ServiceSupervisor& operator=(const ServiceSupervisor&) = delete;
+    
+    /**
+     * @brief 启动事件循环线程
+     * @return 成功返回true
+     */
+    bool start();
+    
+    /**
+     * @brief 停止事件循环线程并释放所有监视项
+     */
+    void stop();
+    
+    /**
+     * @brief 检查事件循环是否在运行
+     * @return 运行中返回true
+     */
+    bool isRunning() const;
+    
+    /**
+     * @brief 添加文件描述符监视
+     * @param fd 文件描述符
+     * @param events 关注的epoll事件（水平触发）
+     * @param handler 事件处理函数
+     * @param owns_fd 为true时监视项移除后关闭fd
+     * @return 监视项ID，失败返回0
+     */
+    uint64_t addWatch(int fd, uint32_t events, Handler handler, bool owns_fd = false);
+    
+    /**
+     * @brief 移除文件描述符监视
+     * @param watch_id 监视项ID
+     */
+    void removeWatch(uint64_t watch_id);
+    
+    /**
+     * @brief 修改监视的事件掩码
+     * @param watch_id 监视项ID
+     * @param events 新的epoll事件
+     * @return 成功返回true
+     */
+    bool modifyWatch(uint64_t watch_id, uint32_t events);
+    
+    /**
+     * @brief 添加节拍处理函数
+     * 
+     * 处理函数在每个节拍（100毫秒）于监管线程上执行一次，执行期间持有节拍锁，
+     * 不能在其中添加或移除节拍处理函数
+     * @param handler 节拍处理函数
+     * @return 处理函数ID，失败返回0
+     */
+    uint64_t addTickHandler(TickHandler handler);
+    
+    /**
+     * @brief 移除节拍处理函数
+     * 
+     * 返回后该处理函数不会再被调用，即使移除时它正在执行
+     * @param handler_id 处理函数ID
+     */
+    void removeTickHandler(uint64_t handler_id);
+    
+    /**
+     * @brief 检查当前线程是否为监管线程
+     * @return 是返回true
+     */
+    bool inSupervisorThread() const;
+    
+    /**
+     * @brief 获取最近一次节拍的循环延迟
+     * 
+     * 事件循环按固定节拍醒来，实际醒来时间与计划时间之差反映了处理函数造成的拥塞
+     * @return 延迟（纳秒）
+     */
+    int64_t loopLagNanoseconds() const;
+    
+    /**
+     * @brief 获取启动以来的最大循环延迟
+     * @return 延迟（纳秒）
+     */
+    int64_t maxLoopLagNanoseconds() const;
+
+private:
+    struct Watch {
+        int fd;
+        bool owns_fd;
+        std::shared_ptr<Handler> handler;
+    };
+    
+    void run();
+    void runTickHandlers(std::chrono::steady_clock::time_point now);
+    void wake();
+    void releaseWatch(const Watch& watch);
+    
+    int epoll_fd_;
+    int wake_fd_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::atomic<int64_t> loop_lag_ns_;
+    std::atomic<int64_t> max_loop_lag_ns_;
+    
+    mutable std::mutex watches_mutex_;
+    std::unordered_map<uint64_t, Watch> watches_;
+    uint64_t next_watch_id_;
+    
+    std::mutex tick_mutex_;
+    std::vector<std::pair<uint64_t, TickHandler>> tick_handlers_;
+    uint64_t next_tick_handler_id_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_SUPERVISOR_H
@@ -0,0 +1,234 @@
+/**
+ * @file service_timing.cpp
+ * @brief 服务启动时间分析实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_timing.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+using TimePoint = std::chrono::steady_clock::time_point;
+
+bool isSet(TimePoint point) {
+    return point != TimePoint();
+}
+
+// 启动过程的时间原点：最早的启动请求
+TimePoint findOrigin(const std::vector<ServiceStartupTiming>& timings) {
+    TimePoint origin;
+    for (const auto& timing : timings) {
+        if (isSet(timing.requested) && (!isSet(origin) || timing.requested < origin)) {
+            origin = timing.requested;
+        }
+    }
+    return origin;
+}
+
+std::string formatSeconds(std::chrono::steady_clock::duration duration) {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3)
+           << std::chrono::duration<double>(duration).count() << "s";
+    return stream.str();
+}
+
+long long toMicroseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::ostringstream code;
+                    code << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    escaped += code.str();
+                } else {
+                    escaped += c;
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+std::vector<std::string> computeCriticalChain(const std::vector<ServiceStartupTiming>& timings,
+                                              const std::string& service_name) {
+    std::unordered_map<std::string, const ServiceStartupTiming*> by_name;
+    for (const auto& timing : timings) {
+        by_name[timing.name] = &timing;
+    }
+    
+    std::vector<std::string> chain;
+    std::unordered_set<std::string> visited;
+    std::string current = service_name;
+    
+    while (visited.insert(current).second) {
+        auto it = by_name.find(current);
+        if (it == by_name.end()) {
+            break;
+        }
+        chain.push_back(current);
+        
+        // 最晚就绪的依赖决定了当前服务能够开始的时间
+        const ServiceStartupTiming* gating = nullptr;
+        for (const auto& dependency : it->second->dependencies) {
+            auto dep = by_name.find(dependency);
+            if (dep == by_name.end() || !dep->second->completed) {
+                continue;
+            }
+            if (!gating || dep->second->ready > gating->ready) {
+                gating = dep->second;
+            }
+        }
+        
+        if (!gating) {
+            break;
+        }
+        current = gating->name;
+    }
+    
+    return chain;
+}
+
+std::string formatCriticalChainReport(const std::vector<ServiceStartupTiming>& timings) {
+    std::ostringstream report;
+    report << "=== 启动关键路径 ===\n";
+    
+    TimePoint origin = findOrigin(timings);
+    if (!isSet(origin)) {
+        report << "没有启动记录\n";
+        return report.str();
+    }
+    
+    std::unordered_map<std::string, const ServiceStartupTiming*> by_name;
+    std::unordered_set<std::string> depended_on;
+    TimePoint last_ready = origin;
+    size_t ready_count = 0;
+    for (const auto& timing : timings) {
+        by_name[timing.name] = &timing;
+        for (const auto& dependency : timing.dependencies) {
+            depended_on.insert(dependency);
+        }
+        if (timing.completed) {
+            last_ready = std::max(last_ready, timing.ready);
+            ++ready_count;
+        }
+    }
+    
+    report << "启动总耗时: " << formatSeconds(last_ready - origin)
+           << "（" << ready_count << "/" << timings.size() << "个服务就绪）\n";
+    
+    // 终端服务按就绪时间倒序，最慢的链排在最前
+    std::vector<const ServiceStartupTiming*> terminals;
+    for (const auto& timing : timings) {
+        if (isSet(timing.requested) && depended_on.count(timing.name) == 0) {
+            terminals.push_back(&timing);
+        }
+    }
+    std::sort(terminals.begin(), terminals.end(), [](const ServiceStartupTiming* a, const ServiceStartupTiming* b) {
+        if (a->completed != b->completed) {
+            return !a->completed; // 未就绪的服务最需要关注
+        }
+        return a->ready > b->ready;
+    });
+    
+    for (const auto* terminal : terminals) {
+        report << "\n";
+        std::vector<std::string> chain = computeCriticalChain(timings, terminal->name);
+        for (size_t depth = 0; depth < chain.size(); ++depth) {
+            const ServiceStartupTiming& timing = *by_name[chain[depth]];
+            
+            if (depth > 0) {
+                report << std::string((depth - 1) * 2, ' ') << "└─";
+            }
+            report << timing.name;
+            
+            if (!timing.completed) {
+                report << " 未就绪\n";
+                continue;
+            }
+            
+            report << " @" << formatSeconds(timing.ready - origin);
+            if (isSet(timing.spawned)) {
+                report << " +" << formatSeconds(timing.ready - timing.spawned);
+            }
+            if (isSet(timing.dependencies_ready) && timing.dependencies_ready > timing.requested) {
+                report << "（等待依赖 " << formatSeconds(timing.dependencies_ready - timing.requested) << "）";
+            }
+            report << "\n";
+        }
+    }
+    
+    return report.str();
+}
+
+std::string formatStartupTrace(const std::vector<ServiceStartupTiming>& timings) {
+    TimePoint origin = findOrigin(timings);
+    
+    std::ostringstream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    
+    bool first = true;
+    auto emit = [&](const std::string& event) {
+        json << (first ? "" : ",") << "\n" << event;
+        first = false;
+    };
+    
+    auto emitPhase = [&](size_t tid, const std::string& name, TimePoint begin, TimePoint end) {
+        if (!isSet(begin) || !isSet(end) || end < begin) {
+            return;
+        }
+        std::ostringstream event;
+        event << "{\"name\":\"" << escapeJson(name) << "\",\"cat\":\"service\",\"ph\":\"X\""
+              << ",\"pid\":1,\"tid\":" << tid
+              << ",\"ts\":" << toMicroseconds(begin - origin)
+              << ",\"dur\":" << toMicroseconds(end - begin) << "}";
+        emit(event.str());
+    };
+    
+    for (size_t i = 0; i < timings.size(); ++i) {
+        const auto& timing = timings[i];
+        if (!isSet(timing.requested)) {
+            continue;
+        }
+        
+        size_t tid = i + 1;
+        std::ostringstream metadata;
+        metadata << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                 << ",\"args\":{\"name\":\"" << escapeJson(timing.name) << "\"}}";
+        emit(metadata.str());
+        
+        emitPhase(tid, "等待依赖", timing.requested, timing.dependencies_ready);
+        emitPhase(tid, "排队", timing.dependencies_ready, timing.spawned);
+        emitPhase(tid, "exec", timing.spawned, timing.executed);
+        if (timing.completed) {
+            emitPhase(tid, "初始化", isSet(timing.executed) ? timing.executed : timing.spawned, timing.ready);
+        }
+    }
+    
+    json << "\n]}\n";
+    return json.str();
+}
+
+} // namespace System
+} // namespace CloudFlow
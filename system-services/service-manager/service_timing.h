@@ -0,0 +1,47 @@
+/**
+ * @file service_timing.h
+ * @brief 服务启动时间分析
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 根据各服务的启动时间线计算关键路径，并导出Chrome trace格式
+ */
+
+#ifndef CLOUDFLOW_SERVICE_TIMING_H
+#define CLOUDFLOW_SERVICE_TIMING_H
+
+#include "service_manager.h"
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+/**
+ * @brief 计算服务的关键依赖链
+ * @param timings 所有服务的时间线
+ * @param service_name 起点服务
+ * @return 从起点服务到最早依赖的服务名称链
+ */
+std::vector<std::string> computeCriticalChain(const std::vector<ServiceStartupTiming>& timings,
+                                              const std::string& service_name);
+
+/**
+ * @brief 生成关键路径报告文本
+ * @param timings 所有服务的时间线
+ * @return 报告文本
+ */
+std::string formatCriticalChainReport(const std::vector<ServiceStartupTiming>& timings);
+
+/**
+ * @brief 生成Chrome trace JSON
+ * @param timings 所有服务的时间线
+ * @return JSON文本
+ */
+std::string formatStartupTrace(const std::vector<ServiceStartupTiming>& timings);
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_TIMING_H
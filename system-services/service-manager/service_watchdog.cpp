@@ -0,0 +1,224 @@
+/**
+ * @file service_watchdog.cpp
+ * @brief 服务看门狗实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_watchdog.h"
+#include "service_supervisor.h"
+#include <algorithm>
+#include <new>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+namespace {
+
+int64_t toNanoseconds(std::chrono::steady_clock::time_point point) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(point.time_since_epoch()).count();
+}
+
+} // namespace
+
+HeartbeatRegion::HeartbeatRegion(int fd, HeartbeatPage* page)
+    : fd_(fd)
+    , page_(page) {
+}
+
+int HeartbeatRegion::fd() const {
+    return fd_;
+}
+
+HeartbeatPage* HeartbeatRegion::page() const {
+    return page_;
+}
+
+#ifdef __linux__
+
+std::shared_ptr<HeartbeatRegion> HeartbeatRegion::create(const std::string& service_name) {
+    std::string name = "cloudflow-heartbeat-" + service_name;
+    int fd = memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd == -1) {
+        return nullptr;
+    }
+    
+    // 封住大小，服务进程无法截断文件让管理器访问映射时收到SIGBUS
+    size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (ftruncate(fd, static_cast<off_t>(size)) == -1 ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1) {
+        close(fd);
+        return nullptr;
+    }
+    
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    
+    HeartbeatPage* page = new (mapping) HeartbeatPage;
+    page->magic = kHeartbeatMagic;
+    page->version = kHeartbeatVersion;
+    page->counter.store(0, std::memory_order_relaxed);
+    page->last_seen_ns.store(toNanoseconds(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+    
+    return std::shared_ptr<HeartbeatRegion>(new HeartbeatRegion(fd, page));
+}
+
+std::shared_ptr<HeartbeatRegion> HeartbeatRegion::adopt(int fd) {
+    size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    struct stat info;
+    if (fstat(fd, &info) == -1 || static_cast<size_t>(info.st_size) != size) {
+        return nullptr;
+    }
+    
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    
+    HeartbeatPage* page = static_cast<HeartbeatPage*>(mapping);
+    if (page->magic != kHeartbeatMagic || page->version != kHeartbeatVersion) {
+        munmap(mapping, size);
+        return nullptr;
+    }
+    
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return std::shared_ptr<HeartbeatRegion>(new HeartbeatRegion(fd, page));
+}
+
+HeartbeatRegion::~HeartbeatRegion() {
+    munmap(page_, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    close(fd_);
+}
+
+#else
+
+std::shared_ptr<HeartbeatRegion> HeartbeatRegion::create(const std::string&) {
+    return nullptr; // 当前平台不支持
+}
+
+std::shared_ptr<HeartbeatRegion> HeartbeatRegion::adopt(int) {
+    return nullptr;
+}
+
+HeartbeatRegion::~HeartbeatRegion() {
+}
+
+#endif
+
+ServiceWatchdog::ServiceWatchdog(ServiceSupervisor& supervisor)
+    : supervisor_(supervisor)
+    , tick_handler_(0)
+    , next_id_(1) {
+}
+
+ServiceWatchdog::~ServiceWatchdog() {
+    stop();
+}
+
+bool ServiceWatchdog::start() {
+    if (tick_handler_ == 0) {
+        tick_handler_ = supervisor_.addTickHandler([this](std::chrono::steady_clock::time_point now) {
+            scan(now);
+        });
+    }
+    return tick_handler_ != 0;
+}
+
+void ServiceWatchdog::stop() {
+    if (tick_handler_ != 0) {
+        supervisor_.removeTickHandler(tick_handler_);
+        tick_handler_ = 0;
+    }
+}
+
+uint64_t ServiceWatchdog::watch(std::shared_ptr<HeartbeatRegion> region, std::chrono::milliseconds timeout,
+                                ExpireHandler handler) {
+    if (!region || !handler || timeout.count() <= 0) {
+        return 0;
+    }
+    
+    HeartbeatPage* page = region->page();
+    int64_t now = toNanoseconds(std::chrono::steady_clock::now());
+    page->last_seen_ns.store(now, std::memory_order_relaxed);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t watch_id = next_id_++;
+    entries_.push_back(Entry{
+        watch_id,
+        page,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count(),
+        page->counter.load(std::memory_order_acquire),
+        now,
+        false,
+        false,
+        std::move(region),
+        std::move(handler)
+    });
+    return watch_id;
+}
+
+void ServiceWatchdog::unwatch(uint64_t watch_id) {
+    std::shared_ptr<HeartbeatRegion> region; // 在锁外释放，解除映射不占用看门狗锁
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(entries_.begin(), entries_.end(), [watch_id](const Entry& entry) {
+            return entry.id == watch_id;
+        });
+        if (it == entries_.end()) {
+            return;
+        }
+        
+        // 与末尾交换后删除，扫描顺序无关紧要
+        region = std::move(it->region);
+        std::swap(*it, entries_.back());
+        entries_.pop_back();
+    }
+}
+
+void ServiceWatchdog::setSuspended(uint64_t watch_id, bool suspended) {
+    int64_t now = toNanoseconds(std::chrono::steady_clock::now());
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        if (entry.id == watch_id) {
+            entry.suspended = suspended;
+            entry.last_counter = entry.page->counter.load(std::memory_order_acquire);
+            entry.last_seen_ns = now;
+            return;
+        }
+    }
+}
+
+void ServiceWatchdog::scan(std::chrono::steady_clock::time_point now) {
+    int64_t now_ns = toNanoseconds(now);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        uint64_t counter = entry.page->counter.load(std::memory_order_acquire);
+        if (counter != entry.last_counter) {
+            entry.last_counter = counter;
+            entry.last_seen_ns = now_ns;
+            entry.page->last_seen_ns.store(now_ns, std::memory_order_relaxed);
+            continue;
+        }
+        
+        if (!entry.expired && !entry.suspended && now_ns - entry.last_seen_ns > entry.timeout_ns) {
+            entry.expired = true;
+            entry.handler();
+        }
+    }
+}
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,159 @@
+/**
+ * @file service_watchdog.h
+ * @brief 服务看门狗
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 为每个配置了看门狗超时的服务创建共享内存心跳页，
+ * 监管线程每个节拍一次扫描全部心跳页，发现心跳停滞后通知服务重启
+ */
+
+#ifndef CLOUDFLOW_SERVICE_WATCHDOG_H
+#define CLOUDFLOW_SERVICE_WATCHDOG_H
+
+#include "service_heartbeat.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+class ServiceSupervisor;
+
+/**
+ * @brief 心跳共享内存区域
+ *
+ * 由memfd承载，每次启动服务时新建，旧进程无法写入新进程的心跳页
+ */
+class HeartbeatRegion {
+public:
+    /**
+     * @brief 创建心跳区域
+     * @param service_name 服务名称，用于memfd命名
+     * @return 区域对象，失败返回空指针
+     */
+    static std::shared_ptr<HeartbeatRegion> create(const std::string& service_name);
+    
+    /**
+     * @brief 接管已有的心跳区域，用于管理器重新exec后继续监视服务
+     * @param fd memfd描述符，成功时所有权转移给区域对象，失败时由调用方关闭
+     * @return 区域对象，描述符不是有效的心跳页时返回空指针
+     */
+    static std::shared_ptr<HeartbeatRegion> adopt(int fd);
+    
+    ~HeartbeatRegion();
+    
+    HeartbeatRegion(const HeartbeatRegion&) = delete;
+    HeartbeatRegion& operator=(const HeartbeatRegion&) = delete;
+    
+    /**
+     * @brief 获取传给服务进程的文件描述符（带CLOEXEC标志）
+     * @return 文件描述符
+     */
+    int fd() const;
+    
+    /**
+     * @brief 获取心跳页
+     * @return 心跳页指针
+     */
+    HeartbeatPage* page() const;
+
+private:
+    HeartbeatRegion(int fd, HeartbeatPage* page);
+    
+    int fd_;
+    HeartbeatPage* page_;
+};
+
+/**
+ * @brief 服务看门狗
+ *
+ * 心跳页登记在连续数组中，每个节拍在监管线程上顺序扫描一遍。
+ * 超时处理函数在扫描时于看门狗锁内调用，只应设置标志或唤醒其他线程，
+ * 不能调用watch()/unwatch()；unwatch()返回后处理函数不会再被调用。
+ */
+class ServiceWatchdog {
+public:
+    using ExpireHandler = std::function<void()>;
+    
+    explicit ServiceWatchdog(ServiceSupervisor& supervisor);
+    ~ServiceWatchdog();
+    
+    ServiceWatchdog(const ServiceWatchdog&) = delete;
+    ServiceWatchdog& operator=(const ServiceWatchdog&) = delete;
+    
+    /**
+     * @brief 在监管事件循环上开始扫描
+     * @return 成功返回true
+     */
+    bool start();
+    
+    /**
+     * @brief 停止扫描
+     */
+    void stop();
+    
+    /**
+     * @brief 登记心跳区域
+     *
+     * 登记时刻视为最近一次心跳，服务需在超时前发出第一次心跳
+     * @param region 心跳区域
+     * @param timeout 超时时间
+     * @param handler 超时处理函数，每次登记最多调用一次
+     * @return 登记ID，失败返回0
+     */
+    uint64_t watch(std::shared_ptr<HeartbeatRegion> region, std::chrono::milliseconds timeout, ExpireHandler handler);
+    
+    /**
+     * @brief 取消登记
+     * @param watch_id 登记ID
+     */
+    void unwatch(uint64_t watch_id);
+    
+    /**
+     * @brief 暂停或恢复对心跳的检查
+     *
+     * 服务被SIGSTOP暂停期间无法发出心跳，暂停时跳过检查；
+     * 恢复时以当前时刻作为最近一次心跳，重新开始计时
+     * @param watch_id 登记ID
+     * @param suspended true表示暂停检查
+     */
+    void setSuspended(uint64_t watch_id, bool suspended);
+    
+    /**
+     * @brief 扫描全部心跳页
+     * @param now 当前时间
+     */
+    void scan(std::chrono::steady_clock::time_point now);
+
+private:
+    struct Entry {
+        uint64_t id;
+        HeartbeatPage* page;
+        int64_t timeout_ns;
+        uint64_t last_counter;
+        int64_t last_seen_ns;
+        bool expired;
+        bool suspended;
+        std::shared_ptr<HeartbeatRegion> region;
+        ExpireHandler handler;
+    };
+    
+    ServiceSupervisor& supervisor_;
+    uint64_t tick_handler_;
+    
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+    uint64_t next_id_;
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_WATCHDOG_H
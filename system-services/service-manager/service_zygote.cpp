@@ -0,0 +1,539 @@
+/**
+ * @file service_zygote.cpp
+ * @brief Zygote预初始化运行时实现
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ */
+
+#include "service_zygote.h"
+#include "service_fdstore.h"
+#include "service_heartbeat.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace CloudFlow {
+namespace System {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr size_t kMaxMessageSize = 64 * 1024;
+constexpr int kReplyTimeoutMs = 5000;
+constexpr int kMaxRequestFds = 3;
+
+// 请求负载的第一个字节标记随消息传递了哪些描述符，描述符按此顺序排列
+constexpr uint8_t kHasOutput = 0x01;
+constexpr uint8_t kHasListen = 0x02;
+constexpr uint8_t kHasHeartbeat = 0x04;
+
+void putU8(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+void putString(std::string& out, const std::string& value) {
+    putU32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+/**
+ * @brief 小端负载读取器，越界后所有读取返回0并置失败标志
+ */
+class PayloadReader {
+public:
+    PayloadReader(const char* data, size_t size)
+        : data_(data)
+        , size_(size)
+        , offset_(0)
+        , ok_(true) {
+    }
+    
+    uint8_t u8() {
+        if (!require(1)) {
+            return 0;
+        }
+        return static_cast<uint8_t>(data_[offset_++]);
+    }
+    
+    uint32_t u32() {
+        if (!require(4)) {
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[offset_ + i])) << (i * 8);
+        }
+        offset_ += 4;
+        return value;
+    }
+    
+    std::string string() {
+        uint32_t length = u32();
+        if (!require(length)) {
+            return std::string();
+        }
+        std::string value(data_ + offset_, length);
+        offset_ += length;
+        return value;
+    }
+    
+    bool ok() const {
+        return ok_;
+    }
+    
+    bool finished() const {
+        return ok_ && offset_ == size_;
+    }
+
+private:
+    bool require(size_t count) {
+        if (!ok_ || size_ - offset_ < count) {
+            ok_ = false;
+        }
+        return ok_;
+    }
+    
+    const char* data_;
+    size_t size_;
+    size_t offset_;
+    bool ok_;
+};
+
+bool sendMessage(int socket, const std::string& payload, const std::vector<int>& fds) {
+    iovec iov{};
+    iov.iov_base = const_cast<char*>(payload.data());
+    iov.iov_len = payload.size();
+    
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxRequestFds)];
+    if (!fds.empty()) {
+        message.msg_control = control;
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+    }
+    
+    ssize_t sent;
+    do {
+        sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+    } while (sent == -1 && errno == EINTR);
+    return sent == static_cast<ssize_t>(payload.size());
+}
+
+// 返回负载长度，对端关闭返回0，出错返回-1；收到的描述符带CLOEXEC
+ssize_t receiveMessage(int socket, std::vector<char>& buffer, std::vector<int>& fds) {
+    fds.clear();
+    
+    iovec iov{};
+    iov.iov_base = buffer.data();
+    iov.iov_len = buffer.size();
+    
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxRequestFds)];
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    
+    ssize_t received;
+    do {
+        received = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+    } while (received == -1 && errno == EINTR);
+    if (received <= 0) {
+        return received;
+    }
+    
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const unsigned char* data = CMSG_DATA(header);
+            for (size_t i = 0; i < count; ++i) {
+                int fd;
+                std::memcpy(&fd, data + i * sizeof(int), sizeof(int));
+                fds.push_back(fd);
+            }
+        }
+    }
+    
+    // 截断的消息不可信，附带的描述符一并关闭
+    if (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+        for (int fd : fds) {
+            close(fd);
+        }
+        fds.clear();
+        errno = EMSGSIZE;
+        return -1;
+    }
+    return received;
+}
+
+std::string encodeRequest(const ZygoteSpawnRequest& request, std::vector<int>& fds) {
+    uint8_t flags = 0;
+    if (request.output_fd != -1) {
+        flags |= kHasOutput;
+        fds.push_back(request.output_fd);
+    }
+    if (request.listen_fd != -1) {
+        flags |= kHasListen;
+        fds.push_back(request.listen_fd);
+    }
+    if (request.heartbeat_fd != -1) {
+        flags |= kHasHeartbeat;
+        fds.push_back(request.heartbeat_fd);
+    }
+    
+    std::string payload;
+    putU8(payload, flags);
+    putString(payload, request.name);
+    putU32(payload, static_cast<uint32_t>(request.args.size()));
+    for (const auto& arg : request.args) {
+        putString(payload, arg);
+    }
+    putU32(payload, static_cast<uint32_t>(request.environment.size()));
+    for (const auto& env : request.environment) {
+        putString(payload, env.first);
+        putString(payload, env.second);
+    }
+    putString(payload, request.working_directory);
+    putU32(payload, static_cast<uint32_t>(request.cpus.size()));
+    for (int cpu : request.cpus) {
+        putU32(payload, static_cast<uint32_t>(cpu));
+    }
+    putU32(payload, static_cast<uint32_t>(request.oom_score_adj));
+    return payload;
+}
+
+bool decodeRequest(const char* data, size_t size, const std::vector<int>& fds, ZygoteSpawnRequest& request) {
+    PayloadReader reader(data, size);
+    uint8_t flags = reader.u8();
+    request.name = reader.string();
+    
+    // 数量字段不可信，不预先分配；越界后读取器失败，循环随之结束
+    uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        request.args.push_back(reader.string());
+    }
+    count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        std::string key = reader.string();
+        request.environment[key] = reader.string();
+    }
+    request.working_directory = reader.string();
+    count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        request.cpus.push_back(static_cast<int>(reader.u32()));
+    }
+    request.oom_score_adj = static_cast<int>(reader.u32());
+    if (!reader.finished() || request.args.empty()) {
+        return false;
+    }
+    
+    size_t index = 0;
+    auto take = [&](uint8_t flag, int& fd) {
+        if (flags & flag) {
+            fd = index < fds.size() ? fds[index++] : -1;
+            return fd != -1;
+        }
+        return true;
+    };
+    return take(kHasOutput, request.output_fd) && take(kHasListen, request.listen_fd) &&
+           take(kHasHeartbeat, request.heartbeat_fd) && index == fds.size();
+}
+
+std::string encodeReply(int pid, const std::string& error) {
+    std::string payload;
+    putU32(payload, static_cast<uint32_t>(pid));
+    putString(payload, error);
+    return payload;
+}
+
+// 把描述符移到3之后，使安放到0到3时不会互相覆盖
+int moveAbove(int fd) {
+    if (fd == -1 || fd > 3) {
+        return fd;
+    }
+    int moved = fcntl(fd, F_DUPFD_CLOEXEC, 4);
+    close(fd);
+    return moved;
+}
+
+// 在fork出的子进程中按exec启动相同的约定安放描述符并应用服务配置，返回退出码
+int runService(ZygoteSpawnRequest& request, const ZygoteRuntime::Entry& entry) {
+    signal(SIGCHLD, SIG_DFL);
+    
+    request.output_fd = moveAbove(request.output_fd);
+    request.listen_fd = moveAbove(request.listen_fd);
+    request.heartbeat_fd = moveAbove(request.heartbeat_fd);
+    
+    if (request.output_fd != -1) {
+        dup2(request.output_fd, STDOUT_FILENO);
+        dup2(request.output_fd, STDERR_FILENO);
+        close(request.output_fd);
+        request.output_fd = STDOUT_FILENO;
+    }
+    
+    if (request.heartbeat_fd != -1) {
+        int inherited = fcntl(request.heartbeat_fd, F_DUPFD, 4);
+        close(request.heartbeat_fd);
+        request.heartbeat_fd = inherited;
+        if (inherited != -1) {
+            setenv(kHeartbeatFdEnv, std::to_string(inherited).c_str(), 1);
+        }
+    }
+    
+    if (request.listen_fd != -1) {
+        dup2(request.listen_fd, 3);
+        close(request.listen_fd);
+        request.listen_fd = 3;
+        setenv("LISTEN_FDS", "1", 1);
+        setenv("LISTEN_PID", std::to_string(getpid()).c_str(), 1);
+    }
+    
+    if (!request.cpus.empty()) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : request.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpu_set);
+            }
+        }
+        sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+    }
+    
+    // 降低分值需要特权，失败时忽略
+    if (request.oom_score_adj != 0) {
+        int oom_fd = open("/proc/self/oom_score_adj", O_WRONLY | O_CLOEXEC);
+        if (oom_fd != -1) {
+            std::string value = std::to_string(request.oom_score_adj);
+            ssize_t written = write(oom_fd, value.c_str(), value.size());
+            (void)written;
+            close(oom_fd);
+        }
+    }
+    
+    if (!request.working_directory.empty() && chdir(request.working_directory.c_str()) == -1) {
+        return EXIT_FAILURE;
+    }
+    
+    for (const auto& env : request.environment) {
+        setenv(env.first.c_str(), env.second.c_str(), 1);
+    }
+    
+    return entry(request);
+}
+
+} // namespace
+
+ZygoteClient::ZygoteClient(int fd)
+    : fd_(fd) {
+}
+
+ZygoteClient::~ZygoteClient() {
+    if (fd_ != -1) {
+        close(fd_);
+    }
+}
+
+int ZygoteClient::spawn(const ZygoteSpawnRequest& request, int& pidfd, std::string& error) {
+    pidfd = -1;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ == -1) {
+        error = "zygote连接已断开";
+        return -1;
+    }
+    
+    std::vector<int> fds;
+    std::string payload = encodeRequest(request, fds);
+    if (payload.size() > kMaxMessageSize) {
+        error = "启动请求过大";
+        return -1;
+    }
+    if (!sendMessage(fd_, payload, fds)) {
+        error = std::string("发送启动请求失败: ") + std::strerror(errno);
+        return -1;
+    }
+    
+    pollfd entry{};
+    entry.fd = fd_;
+    entry.events = POLLIN;
+    int ready;
+    do {
+        ready = poll(&entry, 1, kReplyTimeoutMs);
+    } while (ready == -1 && errno == EINTR);
+    
+    std::vector<char> buffer(kMaxMessageSize);
+    std::vector<int> received_fds;
+    ssize_t received = ready > 0 ? receiveMessage(fd_, buffer, received_fds) : -1;
+    if (received <= 0) {
+        // 超时后迟到的应答会与下一个请求错位，不再使用该连接
+        error = ready == 0 ? "等待zygote应答超时" : "zygote连接已断开";
+        close(fd_);
+        fd_ = -1;
+        return -1;
+    }
+    
+    PayloadReader reader(buffer.data(), static_cast<size_t>(received));
+    int pid = static_cast<int>(reader.u32());
+    std::string reason = reader.string();
+    if (!reader.finished() || pid <= 0) {
+        for (int fd : received_fds) {
+            close(fd);
+        }
+        error = reason.empty() ? "zygote应答格式错误" : reason;
+        return -1;
+    }
+    
+    for (size_t i = 0; i < received_fds.size(); ++i) {
+        if (i == 0) {
+            pidfd = received_fds[i];
+        } else {
+            close(received_fds[i]);
+        }
+    }
+    return pid;
+}
+
+bool ZygoteRuntime::isZygote() {
+    return std::getenv(kZygoteFdEnv) != nullptr;
+}
+
+int ZygoteRuntime::serve(const Entry& entry) {
+    const char* value = std::getenv(kZygoteFdEnv);
+    if (!value) {
+        return 1;
+    }
+    int socket = std::atoi(value);
+    unsetenv(kZygoteFdEnv);
+    fcntl(socket, F_SETFD, FD_CLOEXEC);
+    
+    // 服务进程由管理器通过pidfd监督，zygote不等待它们，由内核自动回收
+    signal(SIGCHLD, SIG_IGN);
+    
+    std::vector<char> buffer(kMaxMessageSize);
+    std::vector<int> fds;
+    while (true) {
+        ssize_t received = receiveMessage(socket, buffer, fds);
+        if (received == 0) {
+            close(socket);
+            return 0;
+        }
+        if (received == -1) {
+            if (errno == EMSGSIZE) {
+                sendMessage(socket, encodeReply(-1, "启动请求过大"), {});
+                continue;
+            }
+            close(socket);
+            return 1;
+        }
+        
+        ZygoteSpawnRequest request;
+        if (!decodeRequest(buffer.data(), static_cast<size_t>(received), fds, request)) {
+            for (int fd : fds) {
+                close(fd);
+            }
+            sendMessage(socket, encodeReply(-1, "启动请求格式错误"), {});
+            continue;
+        }
+        
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(socket);
+            _exit(runService(request, entry));
+        }
+        int error = errno;
+        
+        for (int fd : fds) {
+            close(fd);
+        }
+        
+        if (pid == -1) {
+            sendMessage(socket, encodeReply(-1, std::string("创建进程失败: ") + std::strerror(error)), {});
+            continue;
+        }
+        
+        // 由zygote打开pidfd再传给管理器，避免服务进程在管理器打开之前退出并被回收
+        int pidfd = openPidfd(pid);
+        std::vector<int> reply_fds;
+        if (pidfd != -1) {
+            reply_fds.push_back(pidfd);
+        }
+        bool sent = sendMessage(socket, encodeReply(pid, std::string()), reply_fds);
+        if (pidfd != -1) {
+            close(pidfd);
+        }
+        if (!sent) {
+            close(socket);
+            return 1;
+        }
+    }
+}
+
+bool ZygoteRuntime::createChannel(int& manager_fd, int& zygote_fd) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) == -1) {
+        return false;
+    }
+    manager_fd = fds[0];
+    zygote_fd = fds[1];
+    return true;
+}
+
+#else
+
+ZygoteClient::ZygoteClient(int fd)
+    : fd_(fd) {
+}
+
+ZygoteClient::~ZygoteClient() {
+}
+
+int ZygoteClient::spawn(const ZygoteSpawnRequest& request, int& pidfd, std::string& error) {
+    (void)request;
+    pidfd = -1;
+    error = "当前平台不支持zygote";
+    return -1;
+}
+
+bool ZygoteRuntime::isZygote() {
+    return false;
+}
+
+int ZygoteRuntime::serve(const Entry& entry) {
+    (void)entry;
+    return 1;
+}
+
+bool ZygoteRuntime::createChannel(int& manager_fd, int& zygote_fd) {
+    manager_fd = -1;
+    zygote_fd = -1;
+    return false;
+}
+
+#endif
+
+} // namespace System
+} // namespace CloudFlow
@@ -0,0 +1,117 @@
+/**
+ * @file service_zygote.h
+ * @brief Zygote预初始化运行时
+ * @author 云流操作系统开发团队
+ * @date 2026-02-04
+ * @version 1.0.0
+ *
+ * 配置为zygote的服务是一个完成了重量级初始化的模板进程，启动时继承一个
+ * SOCK_SEQPACKET控制套接字（描述符由环境变量CLOUDFLOW_ZYGOTE_FD给出）。
+ * 指定spawn_from的服务不再exec，而是由管理器请求zygote fork出子进程，
+ * 子进程只应用该服务自身的参数、环境变量、工作目录、CPU绑定和继承的描述符，
+ * 运行时的内存页与zygote写时复制共享。
+ *
+ * 运行时一侧在初始化完成后调用ZygoteRuntime::serve()，传入服务入口函数即可。
+ * zygote在fork时必须是单线程的，初始化过程中创建的线程应在serve()之前结束。
+ */
+
+#ifndef CLOUDFLOW_SERVICE_ZYGOTE_H
+#define CLOUDFLOW_SERVICE_ZYGOTE_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CloudFlow {
+namespace System {
+
+constexpr const char* kZygoteFdEnv = "CLOUDFLOW_ZYGOTE_FD";
+
+/**
+ * @brief 从zygote启动服务的请求
+ */
+struct ZygoteSpawnRequest {
+    std::string name;                               ///< 服务名称
+    std::vector<std::string> args;                  ///< 参数，args[0]为服务的可执行文件路径
+    std::map<std::string, std::string> environment; ///< 追加的环境变量
+    std::string working_directory;                  ///< 工作目录，为空时不切换
+    std::vector<int> cpus;                          ///< 绑定的CPU，为空表示不绑定
+    int oom_score_adj = 0;                          ///< OOM分值调整，0表示不调整
+    int output_fd = -1;                             ///< 标准输出和标准错误，-1表示继承zygote的
+    int listen_fd = -1;                             ///< 按socket激活约定放在fd 3的监听套接字
+    int heartbeat_fd = -1;                          ///< 看门狗心跳页
+};
+
+/**
+ * @brief 管理器一侧的zygote连接
+ */
+class ZygoteClient {
+public:
+    /**
+     * @brief 构造函数
+     * @param fd 控制套接字，所有权转移给客户端
+     */
+    explicit ZygoteClient(int fd);
+    ~ZygoteClient();
+    
+    ZygoteClient(const ZygoteClient&) = delete;
+    ZygoteClient& operator=(const ZygoteClient&) = delete;
+    
+    /**
+     * @brief 请求zygote fork一个服务进程
+     *
+     * 请求中的描述符以SCM_RIGHTS传递，调用方仍需关闭自己的副本。
+     * 服务进程是zygote的子进程，管理器只能通过pidfd观察其退出
+     * @param request 启动请求
+     * @param pidfd 输出zygote为服务进程打开的pidfd（带CLOEXEC），内核不支持时为-1
+     * @param error 失败时的原因
+     * @return 服务进程ID，失败返回-1
+     */
+    int spawn(const ZygoteSpawnRequest& request, int& pidfd, std::string& error);
+
+private:
+    int fd_;            ///< 应答超时后关闭，此后的请求直接失败
+    std::mutex mutex_;  ///< 串行化请求与应答
+};
+
+/**
+ * @brief zygote一侧的请求循环
+ */
+class ZygoteRuntime {
+public:
+    /**
+     * @brief 服务入口
+     *
+     * 在fork出的子进程中调用，返回值作为进程退出码
+     * @param request 启动请求，其中的描述符已安放完毕
+     */
+    using Entry = std::function<int(const ZygoteSpawnRequest& request)>;
+    
+    /**
+     * @brief 检查当前进程是否作为zygote启动
+     * @return 是返回true
+     */
+    static bool isZygote();
+    
+    /**
+     * @brief 处理启动请求，直到管理器关闭控制套接字
+     * @param entry 服务入口
+     * @return 管理器正常关闭连接返回0，否则返回1
+     */
+    static int serve(const Entry& entry);
+    
+    /**
+     * @brief 创建管理器与zygote之间的控制套接字对
+     * @param manager_fd 输出管理器一端（带CLOEXEC）
+     * @param zygote_fd 输出zygote一端（带CLOEXEC，传给子进程前需复制）
+     * @return 成功返回true
+     */
+    static bool createChannel(int& manager_fd, int& zygote_fd);
+};
+
+} // namespace System
+} // namespace CloudFlow
+
+#endif // CLOUDFLOW_SERVICE_ZYGOTE_H